@@ -0,0 +1,358 @@
+#include "AdaptiveFilter.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ADAPTIVE_FILTER_X86 1
+#include <immintrin.h>
+#endif
+
+constexpr float AdaptiveFilter::NLMS_REGULARIZATION;
+
+////////////////////////////////////////////////////////////
+/// @brief Moves a circular buffer head back one slot, which
+///        is where the next newest value gets written.
+/// @param head -- Current head index.
+/// @param size -- Length of the delay line.
+/// @return The new head index.
+////////////////////////////////////////////////////////////
+static inline unsigned int retreatHead(unsigned int head,
+                                       unsigned int size){
+  return (head == 0 ? size : head) - 1;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Checks the settings before the base class sizes
+///        its storage from them.
+/// @param spec -- The algorithm and its settings.
+/// @return The tap count.
+////////////////////////////////////////////////////////////
+static unsigned int checkedTaps(const AdaptiveSpec& spec){
+  if (spec.numTaps == 0){
+    throw std::invalid_argument("AdaptiveFilter needs at least one tap");
+  }
+  if (!(spec.stepSize > 0.0f) || !std::isfinite(spec.stepSize)){
+    throw std::invalid_argument("AdaptiveFilter step size must be positive "
+                                "and finite");
+  }
+  if (spec.algorithm == LEAKY_LMS &&
+      (!(spec.leakage >= 0.0f) || !(spec.stepSize*spec.leakage < 1.0f))){
+    throw std::invalid_argument("AdaptiveFilter leakage must be at least 0 "
+                                "and below 1/stepSize");
+  }
+  if (spec.updateInterval == 0){
+    throw std::invalid_argument("AdaptiveFilter update interval must be at "
+                                "least 1");
+  }
+  return spec.numTaps;
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members.
+////////////////////////////////////////////////////////////
+AdaptiveFilter::AdaptiveFilter(const AdaptiveSpec& spec) :
+         Filter(std::vector<float>(checkedTaps(spec), 0.0f),
+                std::vector<float>(1, 1.0f)),
+         _spec(spec),
+         _retention(spec.algorithm == LEAKY_LMS ?
+                    1.0f - spec.stepSize*spec.leakage : 1.0f),
+         _untilUpdate(spec.updateInterval),
+         _kernel(SCALAR_KERNEL),
+         _dotKernel(&AdaptiveFilter::scalarDot),
+         _updateKernel(&AdaptiveFilter::scalarUpdate)
+{
+  if (!SetKernel(AVX2_KERNEL)){
+    SetKernel(SSE_KERNEL);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+AdaptiveFilter::~AdaptiveFilter() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Zeroes the weights, both delay lines and the
+///        update countdown.
+////////////////////////////////////////////////////////////
+void AdaptiveFilter::reset(void){
+  std::fill(_inputWeights, _inputWeights + _numInWeights, 0.0f);
+  std::fill(_inputBuffer, _inputBuffer + 2*_numInWeights, 0.0f);
+  std::fill(_outputBuffer, _outputBuffer + 2*_numOutWeights, 0.0f);
+  _inputHead = 0;
+  _outputHead = 0;
+  _untilUpdate = _spec.updateInterval;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Checks the CPU for the instructions a kernel needs.
+/// @param kernel -- The kernel to check.
+/// @return true if the kernel is supported.
+////////////////////////////////////////////////////////////
+bool AdaptiveFilter::IsKernelSupported(Kernel kernel){
+  switch (kernel){
+    case SCALAR_KERNEL:
+      return true;
+#ifdef ADAPTIVE_FILTER_X86
+    case SSE_KERNEL:
+      return __builtin_cpu_supports("sse");
+    case AVX2_KERNEL:
+      return __builtin_cpu_supports("avx2");
+#endif
+    default:
+      return false;
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Switches kernels if the CPU supports the new one.
+/// @param kernel -- The kernel to use.
+/// @return false if the kernel is not supported.
+////////////////////////////////////////////////////////////
+bool AdaptiveFilter::SetKernel(Kernel kernel){
+  if (!IsKernelSupported(kernel)){
+    return false;
+  }
+  _kernel = kernel;
+  switch (kernel){
+    case SSE_KERNEL:
+      _dotKernel = &AdaptiveFilter::sseDot;
+      _updateKernel = &AdaptiveFilter::sseUpdate;
+      break;
+    case AVX2_KERNEL:
+      _dotKernel = &AdaptiveFilter::avx2Dot;
+      _updateKernel = &AdaptiveFilter::avx2Update;
+      break;
+    default:
+      _dotKernel = &AdaptiveFilter::scalarDot;
+      _updateKernel = &AdaptiveFilter::scalarUpdate;
+      break;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Pushes the input into the mirrored delay line so
+///        the window is contiguous, newest first, then runs
+///        the dot product and, once every updateInterval
+///        samples, the weight update on that same window.
+/// @param inputValue -- The reference input.
+/// @param desired    -- The signal the output should match.
+/// @return The error.
+////////////////////////////////////////////////////////////
+inline float AdaptiveFilter::step(float inputValue, float desired){
+  const unsigned int numTaps = _numInWeights;
+  _inputHead = retreatHead(_inputHead, numTaps);
+  _inputBuffer[_inputHead] = inputValue;
+  _inputBuffer[_inputHead + numTaps] = inputValue;
+  const float* window = &_inputBuffer[_inputHead];
+  const float outputValue = _dotKernel(_inputWeights, window, numTaps);
+  _outputBuffer[0] = outputValue;
+  _outputBuffer[1] = outputValue;
+  const float error = desired - outputValue;
+  if (--_untilUpdate == 0){
+    _untilUpdate = _spec.updateInterval;
+    float gain = _spec.stepSize*error;
+    if (_spec.algorithm == NLMS){
+      gain /= NLMS_REGULARIZATION + _dotKernel(window, window, numTaps);
+    }
+    _updateKernel(_inputWeights, window, _retention, gain, numTaps);
+  }
+  return error;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filters one sample and adapts the weights.
+/// @param inputValue -- The reference input.
+/// @param desired    -- The signal the output should match.
+/// @return The error.
+////////////////////////////////////////////////////////////
+float AdaptiveFilter::adapt(float inputValue, float desired){
+  return step(inputValue, desired);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Adapts over a block. Each sample's inputs are read
+///        before its error is written, so the error may
+///        alias either input.
+/// @param input      -- Reference samples, oldest first.
+/// @param desired    -- Desired samples.
+/// @param error      -- Receives the errors.
+/// @param numSamples -- Number of samples in the block.
+////////////////////////////////////////////////////////////
+void AdaptiveFilter::adaptBlock(const float* input, const float* desired,
+                                float* error, unsigned int numSamples){
+  for (unsigned int n=0; n<numSamples; n++){
+    error[n] = step(input[n], desired[n]);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Portable dot product.
+/// @param x      -- First vector.
+/// @param y      -- Second vector.
+/// @param length -- Number of elements.
+/// @return The dot product.
+////////////////////////////////////////////////////////////
+float AdaptiveFilter::scalarDot(const float* x, const float* y,
+                                unsigned int length){
+  float sum = 0.0f;
+  for (unsigned int i=0; i<length; i++){
+    sum += x[i]*y[i];
+  }
+  return sum;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Portable weight update.
+/// @param w      -- The weights, updated in place.
+/// @param x      -- The input window.
+/// @param scale  -- Factor applied to the old weights.
+/// @param gain   -- Factor applied to the window.
+/// @param length -- Number of weights.
+////////////////////////////////////////////////////////////
+void AdaptiveFilter::scalarUpdate(float* w, const float* x, float scale,
+                                  float gain, unsigned int length){
+  for (unsigned int i=0; i<length; i++){
+    w[i] = scale*w[i] + gain*x[i];
+  }
+}
+
+#ifdef ADAPTIVE_FILTER_X86
+////////////////////////////////////////////////////////////
+/// @brief SSE dot product, four lanes per vector. The lanes
+///        are summed at the end, then the leftover elements.
+/// @param x      -- First vector.
+/// @param y      -- Second vector.
+/// @param length -- Number of elements.
+/// @return The dot product.
+////////////////////////////////////////////////////////////
+__attribute__((target("sse")))
+float AdaptiveFilter::sseDot(const float* x, const float* y,
+                             unsigned int length){
+  __m128 lanes = _mm_setzero_ps();
+  unsigned int i = 0;
+  for (; i+4<=length; i+=4){
+    lanes = _mm_add_ps(lanes,
+        _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+  }
+  float partial[4];
+  _mm_storeu_ps(partial, lanes);
+  float sum = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+  for (; i<length; i++){
+    sum += x[i]*y[i];
+  }
+  return sum;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief SSE weight update, four weights per vector.
+/// @param w      -- The weights, updated in place.
+/// @param x      -- The input window.
+/// @param scale  -- Factor applied to the old weights.
+/// @param gain   -- Factor applied to the window.
+/// @param length -- Number of weights.
+////////////////////////////////////////////////////////////
+__attribute__((target("sse")))
+void AdaptiveFilter::sseUpdate(float* w, const float* x, float scale,
+                               float gain, unsigned int length){
+  const __m128 scales = _mm_set1_ps(scale);
+  const __m128 gains = _mm_set1_ps(gain);
+  unsigned int i = 0;
+  for (; i+4<=length; i+=4){
+    _mm_storeu_ps(w + i, _mm_add_ps(
+        _mm_mul_ps(scales, _mm_loadu_ps(w + i)),
+        _mm_mul_ps(gains, _mm_loadu_ps(x + i))));
+  }
+  for (; i<length; i++){
+    w[i] = scale*w[i] + gain*x[i];
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief AVX2 dot product, two accumulators of eight lanes
+///        so consecutive adds do not wait on each other.
+/// @param x      -- First vector.
+/// @param y      -- Second vector.
+/// @param length -- Number of elements.
+/// @return The dot product.
+////////////////////////////////////////////////////////////
+__attribute__((target("avx2")))
+float AdaptiveFilter::avx2Dot(const float* x, const float* y,
+                              unsigned int length){
+  __m256 lanes0 = _mm256_setzero_ps();
+  __m256 lanes1 = _mm256_setzero_ps();
+  unsigned int i = 0;
+  for (; i+16<=length; i+=16){
+    lanes0 = _mm256_add_ps(lanes0,
+        _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    lanes1 = _mm256_add_ps(lanes1,
+        _mm256_mul_ps(_mm256_loadu_ps(x + i + 8),
+                      _mm256_loadu_ps(y + i + 8)));
+  }
+  if (i+8<=length){
+    lanes0 = _mm256_add_ps(lanes0,
+        _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    i += 8;
+  }
+  const __m256 lanes = _mm256_add_ps(lanes0, lanes1);
+  const __m128 half = _mm_add_ps(_mm256_castps256_ps128(lanes),
+                                 _mm256_extractf128_ps(lanes, 1));
+  float partial[4];
+  _mm_storeu_ps(partial, half);
+  float sum = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+  for (; i<length; i++){
+    sum += x[i]*y[i];
+  }
+  return sum;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief AVX2 weight update, eight weights per vector.
+/// @param w      -- The weights, updated in place.
+/// @param x      -- The input window.
+/// @param scale  -- Factor applied to the old weights.
+/// @param gain   -- Factor applied to the window.
+/// @param length -- Number of weights.
+////////////////////////////////////////////////////////////
+__attribute__((target("avx2")))
+void AdaptiveFilter::avx2Update(float* w, const float* x, float scale,
+                                float gain, unsigned int length){
+  const __m256 scales = _mm256_set1_ps(scale);
+  const __m256 gains = _mm256_set1_ps(gain);
+  unsigned int i = 0;
+  for (; i+8<=length; i+=8){
+    _mm256_storeu_ps(w + i, _mm256_add_ps(
+        _mm256_mul_ps(scales, _mm256_loadu_ps(w + i)),
+        _mm256_mul_ps(gains, _mm256_loadu_ps(x + i))));
+  }
+  for (; i<length; i++){
+    w[i] = scale*w[i] + gain*x[i];
+  }
+}
+#else
+////////////////////////////////////////////////////////////
+/// @brief Vector kernels are never selected off x86; these
+///        only satisfy the dispatch table.
+////////////////////////////////////////////////////////////
+float AdaptiveFilter::sseDot(const float* x, const float* y,
+                             unsigned int length){
+  return scalarDot(x, y, length);
+}
+float AdaptiveFilter::avx2Dot(const float* x, const float* y,
+                              unsigned int length){
+  return scalarDot(x, y, length);
+}
+void AdaptiveFilter::sseUpdate(float* w, const float* x, float scale,
+                               float gain, unsigned int length){
+  scalarUpdate(w, x, scale, gain, length);
+}
+void AdaptiveFilter::avx2Update(float* w, const float* x, float scale,
+                                float gain, unsigned int length){
+  scalarUpdate(w, x, scale, gain, length);
+}
+#endif
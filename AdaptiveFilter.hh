@@ -0,0 +1,212 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class defines an adaptive FIR filter whose
+///          weights follow the LMS family of update rules.
+///
+///////////////////////////////////////////////////////////////
+#ifndef ADAPTIVE_FILTER_HH
+#define ADAPTIVE_FILTER_HH
+
+#include "Filter.hh"
+
+#include <stdexcept>
+
+///////////////////////////////////////////////////////////////
+/// @brief Weight update rule of an AdaptiveFilter.
+///////////////////////////////////////////////////////////////
+enum AdaptiveAlgorithm {
+  LMS,
+  NLMS,
+  LEAKY_LMS
+};
+
+///////////////////////////////////////////////////////////////
+/// @brief Everything needed to set up an AdaptiveFilter.
+///////////////////////////////////////////////////////////////
+struct AdaptiveSpec {
+  ////////////////////////////////////////////////////////////
+  /// @brief Weight update rule.
+  ////////////////////////////////////////////////////////////
+  AdaptiveAlgorithm algorithm;
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of FIR weights.
+  ////////////////////////////////////////////////////////////
+  unsigned int numTaps;
+  ////////////////////////////////////////////////////////////
+  /// @brief Step size mu. For NLMS it is divided by the input
+  ///        window's power, and 0 < mu < 2 converges.
+  ////////////////////////////////////////////////////////////
+  float stepSize;
+  ////////////////////////////////////////////////////////////
+  /// @brief Leakage gamma for LEAKY_LMS: each update first
+  ///        scales the weights by 1 - mu*gamma. Otherwise
+  ///        unused.
+  ////////////////////////////////////////////////////////////
+  float leakage;
+  ////////////////////////////////////////////////////////////
+  /// @brief The weights are updated on every updateInterval-th
+  ///        sample only; larger intervals trade convergence
+  ///        speed for throughput. At least 1.
+  ////////////////////////////////////////////////////////////
+  unsigned int updateInterval;
+};
+
+///////////////////////////////////////////////////////////////
+/// @class AdaptiveFilter
+/// @ingroup DSP
+/// @brief FIR filter that adapts its weights to make its
+///        output track a desired signal, as in noise or
+///        vibration cancellation: the reference goes in as
+///        the input, the measured signal as the desired one,
+///        and the error is the cleaned signal. Per sample:
+///
+/// <CENTER>
+///   \f$ y[n] = w \cdot x_n,\quad e[n] = d[n] - y[n],\quad
+///       w \leftarrow \lambda w + \mu' e[n] x_n \f$
+/// </CENTER>
+///
+/// with \f$\mu' = \mu\f$ for LMS, \f$\mu/(\epsilon + x_n \cdot
+/// x_n)\f$ for NLMS, and \f$\lambda = 1 - \mu\gamma\f$ for
+/// LEAKY_LMS (1 otherwise).
+///
+/// The weights and input window live in the Filter storage,
+/// so filter() and filterBlock() run the current weights
+/// without adapting them. The dot products and the weight
+/// update run on SSE or AVX2 kernels, chosen like those of
+/// FilterBank; results differ between kernels only by the
+/// order of the sums.
+///
+/// @code
+///   AdaptiveSpec spec = {NLMS, 64, 0.5f, 0.0f, 1};
+///   AdaptiveFilter canceller(spec);
+///   canceller.adaptBlock(reference, measured, cleaned, numSamples);
+/// @endcode
+///////////////////////////////////////////////////////////////
+class AdaptiveFilter : public Filter {
+
+ public:
+  ////////////////////////////////////////////////////////////
+  /// @brief The vector kernels an adaptive filter can run
+  ///        with.
+  ////////////////////////////////////////////////////////////
+  enum Kernel {
+    SCALAR_KERNEL,
+    SSE_KERNEL,
+    AVX2_KERNEL
+  };
+  ////////////////////////////////////////////////////////////
+  /// @brief Added to the window power for NLMS, so a silent
+  ///        input does not divide by zero.
+  ////////////////////////////////////////////////////////////
+  static constexpr float NLMS_REGULARIZATION = 1e-6f;
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor builds the filter with zeroed
+  ///        weights and history, and selects the widest
+  ///        kernel the CPU supports.
+  /// @param spec -- The algorithm and its settings.
+  /// @throws std::invalid_argument if there are no taps, the
+  ///         step size is not positive and finite, the leakage
+  ///         of a LEAKY_LMS filter is negative or at least
+  ///         1/mu, or the update interval is zero.
+  ////////////////////////////////////////////////////////////
+  explicit AdaptiveFilter(const AdaptiveSpec& spec);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the AdaptiveFilter.
+  ////////////////////////////////////////////////////////////
+  virtual ~AdaptiveFilter();
+  ////////////////////////////////////////////////////////////
+  /// @brief Filters one sample and adapts the weights.
+  /// @param inputValue -- The reference input.
+  /// @param desired    -- The signal the output should match.
+  /// @return The error, desired minus the filter output.
+  ////////////////////////////////////////////////////////////
+  float adapt(float inputValue, float desired);
+  ////////////////////////////////////////////////////////////
+  /// @brief Block version of adapt(); the outputs are
+  ///        bit-identical to calling it once per sample.
+  /// @param input      -- Reference samples, oldest first.
+  /// @param desired    -- Desired samples.
+  /// @param error      -- Receives the errors. May alias input
+  ///                      or desired.
+  /// @param numSamples -- Number of samples in the block.
+  ////////////////////////////////////////////////////////////
+  void adaptBlock(const float* input, const float* desired, float* error,
+                  unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief Zeroes the weights and the history.
+  ////////////////////////////////////////////////////////////
+  void reset(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Selects the kernel used by adapt().
+  /// @param kernel -- The kernel to use.
+  /// @return false if the CPU does not support the kernel,
+  ///         in which case the current kernel is kept.
+  ////////////////////////////////////////////////////////////
+  bool SetKernel(Kernel kernel);
+  ////////////////////////////////////////////////////////////
+  /// @brief Reports whether the CPU can run a given kernel.
+  /// @param kernel -- The kernel to check.
+  /// @return true if the kernel is supported.
+  ////////////////////////////////////////////////////////////
+  static bool IsKernelSupported(Kernel kernel);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the kernel in use.
+  /// @return The active kernel.
+  ////////////////////////////////////////////////////////////
+  inline Kernel GetKernel(void) const { return _kernel; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the settings.
+  /// @return The spec the filter was built from.
+  ////////////////////////////////////////////////////////////
+  inline const AdaptiveSpec& GetSpec(void) const { return _spec; }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Signature of a dot product kernel.
+  ////////////////////////////////////////////////////////////
+  typedef float (*DotKernel)(const float* x, const float* y,
+                             unsigned int length);
+  ////////////////////////////////////////////////////////////
+  /// @brief Signature of a weight update kernel:
+  ///        w = scale*w + gain*x.
+  ////////////////////////////////////////////////////////////
+  typedef void (*UpdateKernel)(float* w, const float* x, float scale,
+                               float gain, unsigned int length);
+  ////////////////////////////////////////////////////////////
+  /// @brief The per kernel routines.
+  ////////////////////////////////////////////////////////////
+  static float scalarDot(const float* x, const float* y,
+                         unsigned int length);
+  static float sseDot(const float* x, const float* y, unsigned int length);
+  static float avx2Dot(const float* x, const float* y, unsigned int length);
+  static void scalarUpdate(float* w, const float* x, float scale,
+                           float gain, unsigned int length);
+  static void sseUpdate(float* w, const float* x, float scale,
+                        float gain, unsigned int length);
+  static void avx2Update(float* w, const float* x, float scale,
+                         float gain, unsigned int length);
+  ////////////////////////////////////////////////////////////
+  /// @brief Filters and adapts one sample.
+  ////////////////////////////////////////////////////////////
+  inline float step(float inputValue, float desired);
+  ////////////////////////////////////////////////////////////
+  /// @brief The algorithm and its settings.
+  ////////////////////////////////////////////////////////////
+  AdaptiveSpec _spec;
+  ////////////////////////////////////////////////////////////
+  /// @brief Weight scale per update: 1 - mu*gamma for
+  ///        LEAKY_LMS, 1 otherwise.
+  ////////////////////////////////////////////////////////////
+  float _retention;
+  ////////////////////////////////////////////////////////////
+  /// @brief Samples left until the next update.
+  ////////////////////////////////////////////////////////////
+  unsigned int _untilUpdate;
+  ////////////////////////////////////////////////////////////
+  /// @brief The active kernel and its routines.
+  ////////////////////////////////////////////////////////////
+  Kernel _kernel;
+  DotKernel _dotKernel;
+  UpdateKernel _updateKernel;
+};
+
+#endif  // ADAPTIVE_FILTER_HH
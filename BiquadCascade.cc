@@ -0,0 +1,336 @@
+#include "BiquadCascade.hh"
+#include "Polynomial.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <stdexcept>
+
+typedef std::complex<double> Complex;
+
+////////////////////////////////////////////////////////////
+/// @brief One first order factor of a transfer function
+///        polynomial in z^-1: (1 - root*z^-1) for a finite
+///        root, or a bare z^-1 for a root at infinity (a
+///        leading zero weight).
+////////////////////////////////////////////////////////////
+struct RootFactor {
+  bool finite;
+  Complex root;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Two factors making up one real second order
+///        polynomial.
+////////////////////////////////////////////////////////////
+struct RootPair {
+  RootFactor first, second;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Orders real factors by decreasing magnitude, with
+///        roots at infinity last.
+////////////////////////////////////////////////////////////
+static bool byDecreasingMagnitude(const RootFactor& lhs,
+                                  const RootFactor& rhs){
+  if (lhs.finite != rhs.finite){
+    return lhs.finite;
+  }
+  return std::abs(lhs.root) > std::abs(rhs.root);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Largest root magnitude in a pair, used to order
+///        the sections.
+////////////////////////////////////////////////////////////
+static double pairMagnitude(const RootPair& pair){
+  return std::max(std::abs(pair.first.root), std::abs(pair.second.root));
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Orders pole pairs by increasing magnitude.
+////////////////////////////////////////////////////////////
+static bool byIncreasingPairMagnitude(const RootPair& lhs,
+                                      const RootPair& rhs){
+  return pairMagnitude(lhs) < pairMagnitude(rhs);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Groups factors into real second order pairs.
+///        Complex roots are matched with their conjugates and
+///        the remaining real roots are paired by magnitude.
+/// @param factors -- The factors; an even number of them.
+/// @param pairs   -- Receives the pairs.
+////////////////////////////////////////////////////////////
+static void pairFactors(std::vector<RootFactor> factors,
+                        std::vector<RootPair>& pairs){
+  std::vector<RootFactor> reals;
+  while (!factors.empty()){
+    RootFactor factor = factors.back();
+    factors.pop_back();
+    if (!factor.finite || factor.root.imag() == 0.0){
+      reals.push_back(factor);
+      continue;
+    }
+    /// Find the conjugate partner.
+    size_t best = factors.size();
+    double bestDistance = std::numeric_limits<double>::max();
+    for (size_t i=0; i<factors.size(); i++){
+      if (!factors[i].finite || factors[i].root.imag()*factor.root.imag() >= 0.0){
+        continue;
+      }
+      const double distance = std::abs(std::conj(factor.root) - factors[i].root);
+      if (distance < bestDistance){
+        bestDistance = distance;
+        best = i;
+      }
+    }
+    if (best == factors.size()){
+      factor.root = Complex(factor.root.real(), 0.0);
+      reals.push_back(factor);
+      continue;
+    }
+    RootPair pair = {factor, factors[best]};
+    factors.erase(factors.begin() + best);
+    pairs.push_back(pair);
+  }
+  std::sort(reals.begin(), reals.end(), byDecreasingMagnitude);
+  for (size_t i=0; i+1<reals.size(); i+=2){
+    RootPair pair = {reals[i], reals[i+1]};
+    pairs.push_back(pair);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Expands a pair of factors into the three weights
+///        of a second order polynomial in z^-1.
+/// @param pair    -- The factor pair.
+/// @param weights -- Receives the three weights.
+////////////////////////////////////////////////////////////
+static void expandPair(const RootPair& pair, double* weights){
+  /// Each factor is c0 + c1*z^-1.
+  const Complex c0 = pair.first.finite ? Complex(1.0) : Complex(0.0);
+  const Complex c1 = pair.first.finite ? -pair.first.root : Complex(1.0);
+  const Complex d0 = pair.second.finite ? Complex(1.0) : Complex(0.0);
+  const Complex d1 = pair.second.finite ? -pair.second.root : Complex(1.0);
+  weights[0] = (c0*d0).real();
+  weights[1] = (c0*d1 + c1*d0).real();
+  weights[2] = (c1*d1).real();
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Distance between a pole pair and a zero pair, used
+///        to put each zero pair with its nearest poles.
+////////////////////////////////////////////////////////////
+static double pairDistance(const RootPair& poles, const RootPair& zeros){
+  if (!zeros.first.finite || !zeros.second.finite){
+    return std::numeric_limits<double>::max();
+  }
+  const Complex pole = poles.first.root.imag() >= 0.0 ?
+                       poles.first.root : poles.second.root;
+  return std::min(std::abs(pole - zeros.first.root),
+                  std::abs(pole - zeros.second.root));
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor copies the sections and zeroes state.
+////////////////////////////////////////////////////////////
+BiquadCascade::BiquadCascade(unsigned int numSections,
+                             const BiquadSection* sections) :
+         _sections(sections, sections + numSections),
+         _state(numSections)
+{
+  if (numSections == 0){
+    throw std::invalid_argument("BiquadCascade needs at least one section");
+  }
+  reset();
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor copies the sections and zeroes state.
+////////////////////////////////////////////////////////////
+BiquadCascade::BiquadCascade(const std::vector<BiquadSection>& sections) :
+         _sections(sections),
+         _state(sections.size())
+{
+  if (sections.empty()){
+    throw std::invalid_argument("BiquadCascade needs at least one section");
+  }
+  reset();
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+BiquadCascade::~BiquadCascade() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Zeroes the state of every section.
+////////////////////////////////////////////////////////////
+void BiquadCascade::reset(void){
+  for (size_t s=0; s<_state.size(); s++){
+    _state[s].z1 = 0.0;
+    _state[s].z2 = 0.0;
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Runs one sample through every section.
+/// @param inputValue  -- Input to the filter.
+/// @return Output from the filter
+////////////////////////////////////////////////////////////
+float BiquadCascade::filter(float inputValue){
+  float value = inputValue;
+  for (size_t s=0; s<_sections.size(); s++){
+    const BiquadSection& w = _sections[s];
+    SectionState& state = _state[s];
+    const float out = w.b0*value + state.z1;
+    state.z1 = w.b1*value - w.a1*out + state.z2;
+    state.z2 = w.b2*value - w.a2*out;
+    value = out;
+  }
+  return value;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Runs a block through each section in turn.
+/// @param input      -- Input samples, oldest first.
+/// @param output     -- Destination for the filter outputs.
+/// @param numSamples -- Number of samples in the block.
+////////////////////////////////////////////////////////////
+void BiquadCascade::filterBlock(const float* input, float* output,
+                                unsigned int numSamples){
+  const float* source = input;
+  for (size_t s=0; s<_sections.size(); s++){
+    const BiquadSection w = _sections[s];
+    float z1 = _state[s].z1;
+    float z2 = _state[s].z2;
+    for (unsigned int n=0; n<numSamples; n++){
+      const float value = source[n];
+      const float out = w.b0*value + z1;
+      z1 = w.b1*value - w.a1*out + z2;
+      z2 = w.b2*value - w.a2*out;
+      output[n] = out;
+    }
+    _state[s].z1 = z1;
+    _state[s].z2 = z2;
+    source = output;
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Factors direct form weights into second order
+///        sections.
+/// @param numInWeights  -- Number of input weights (b).
+/// @param inWeights     -- The input weights.
+/// @param numOutWeights -- Number of output weights (a).
+/// @param outWeights    -- The output weights.
+/// @return The equivalent sections.
+////////////////////////////////////////////////////////////
+std::vector<BiquadSection> BiquadCascade::FromWeights(
+    unsigned int numInWeights, const float* inWeights,
+    unsigned int numOutWeights, const float* outWeights){
+  if (numInWeights == 0 || numOutWeights == 0 || outWeights[0] == 0.0f){
+    throw std::invalid_argument(
+        "BiquadCascade::FromWeights needs b weights and a nonzero a[0]");
+  }
+  /// Normalize by a[0] and pad both polynomials to the filter
+  /// order. Trailing zero weights are poles or zeros at z=0.
+  const unsigned int order = std::max(numInWeights, numOutWeights) - 1;
+  std::vector<double> b(order + 1, 0.0), a(order + 1, 0.0);
+  for (unsigned int i=0; i<numInWeights; i++){
+    b[i] = static_cast<double>(inWeights[i])/outWeights[0];
+  }
+  for (unsigned int i=0; i<numOutWeights; i++){
+    a[i] = static_cast<double>(outWeights[i])/outWeights[0];
+  }
+  unsigned int delay = 0;
+  while (delay <= order && b[delay] == 0.0){
+    delay++;
+  }
+  if (delay > order){
+    /// All zero numerator.
+    BiquadSection section = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    return std::vector<BiquadSection>(1, section);
+  }
+  std::vector<Complex> zeros, poles;
+  polynomialRoots(std::vector<double>(b.begin() + delay, b.end()), zeros);
+  polynomialRoots(a, poles);
+  return FromZerosPoles(zeros, poles, b[delay]);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Pairs zeros and poles into second order sections.
+/// @param zeros -- The filter's zeros.
+/// @param poles -- The filter's poles.
+/// @param gain  -- The overall gain.
+/// @return The equivalent sections.
+////////////////////////////////////////////////////////////
+std::vector<BiquadSection> BiquadCascade::FromZerosPoles(
+    const std::vector<Complex>& zeros,
+    const std::vector<Complex>& poles,
+    double gain){
+  /// Written in z^-1, each missing zero is a bare z^-1 factor
+  /// (a root at infinity) and each missing pole a pole at 0.
+  std::vector<RootFactor> zeroFactors, poleFactors;
+  for (size_t i=0; i<zeros.size(); i++){
+    RootFactor factor = {true, zeros[i]};
+    zeroFactors.push_back(factor);
+  }
+  for (size_t i=0; i<poles.size(); i++){
+    RootFactor factor = {true, poles[i]};
+    poleFactors.push_back(factor);
+  }
+  while (zeroFactors.size() < poleFactors.size()){
+    RootFactor factor = {false, Complex(0.0)};
+    zeroFactors.push_back(factor);
+  }
+  while (poleFactors.size() < zeroFactors.size()){
+    RootFactor factor = {true, Complex(0.0)};
+    poleFactors.push_back(factor);
+  }
+  if (poleFactors.empty()){
+    BiquadSection section = {static_cast<float>(gain),
+                             0.0f, 0.0f, 0.0f, 0.0f};
+    return std::vector<BiquadSection>(1, section);
+  }
+  if (poleFactors.size() % 2 != 0){
+    RootFactor origin = {true, Complex(0.0)};
+    zeroFactors.push_back(origin);
+    poleFactors.push_back(origin);
+  }
+
+  std::vector<RootPair> zeroPairs, polePairs;
+  pairFactors(zeroFactors, zeroPairs);
+  pairFactors(poleFactors, polePairs);
+  std::sort(polePairs.begin(), polePairs.end(), byIncreasingPairMagnitude);
+
+  /// Give each pole pair, starting with those nearest the unit
+  /// circle, the closest remaining zero pair.
+  std::vector<BiquadSection> sections(polePairs.size());
+  for (size_t s=polePairs.size(); s-- > 0; ){
+    size_t best = 0;
+    double bestDistance = pairDistance(polePairs[s], zeroPairs[0]);
+    for (size_t i=1; i<zeroPairs.size(); i++){
+      const double distance = pairDistance(polePairs[s], zeroPairs[i]);
+      if (distance < bestDistance){
+        bestDistance = distance;
+        best = i;
+      }
+    }
+    double num[3], den[3];
+    expandPair(zeroPairs[best], num);
+    expandPair(polePairs[s], den);
+    zeroPairs.erase(zeroPairs.begin() + best);
+    const double scale = (s == 0) ? gain : 1.0;
+    sections[s].b0 = static_cast<float>(scale*num[0]);
+    sections[s].b1 = static_cast<float>(scale*num[1]);
+    sections[s].b2 = static_cast<float>(scale*num[2]);
+    sections[s].a1 = static_cast<float>(den[1]);
+    sections[s].a2 = static_cast<float>(den[2]);
+  }
+  return sections;
+}
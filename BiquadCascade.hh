@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class defines a digital filter built from a
+///          cascade of second order sections (biquads).
+///
+///////////////////////////////////////////////////////////////
+#ifndef BIQUAD_CASCADE_HH
+#define BIQUAD_CASCADE_HH
+
+#include <complex>
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @brief Weights of one second order section, normalized so
+///        that a[0] is one: \par
+///
+/// <CENTER>
+///   \f$ H(z) = \frac{b0 + b1 z^{-1} + b2 z^{-2}}
+///                   {1 + a1 z^{-1} + a2 z^{-2}} \f$
+/// </CENTER>
+///////////////////////////////////////////////////////////////
+struct BiquadSection {
+  float b0, b1, b2;
+  float a1, a2;
+};
+
+///////////////////////////////////////////////////////////////
+/// @class BiquadCascade
+/// @ingroup DSP
+/// @brief Digital filter evaluated as a series of second order
+///        sections, each in transposed direct form II. Unlike
+///        the single difference equation in Filter, a cascade
+///        keeps every section's poles well conditioned, so
+///        high order designs (8th order Butterworth and up)
+///        stay stable in single precision.
+///
+/// Existing Filter weights can be converted with FromWeights:
+///
+/// @code
+///   BiquadCascade cascade(BiquadCascade::FromWeights(
+///       numInWeights, inWeights, numOutWeights, outWeights));
+/// @endcode
+///////////////////////////////////////////////////////////////
+class BiquadCascade {
+
+ public:
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor builds the cascade from its
+  ///        sections with zeroed state.
+  /// @param numSections -- Number of sections.
+  /// @param sections    -- The sections, applied in order.
+  /// @throws std::invalid_argument if there are no sections.
+  ////////////////////////////////////////////////////////////
+  BiquadCascade(unsigned int numSections, const BiquadSection* sections);
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor builds the cascade from its
+  ///        sections with zeroed state.
+  /// @param sections -- The sections, applied in order.
+  /// @throws std::invalid_argument if there are no sections.
+  ////////////////////////////////////////////////////////////
+  explicit BiquadCascade(const std::vector<BiquadSection>& sections);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the BiquadCascade
+  ////////////////////////////////////////////////////////////
+  ~BiquadCascade();
+  ////////////////////////////////////////////////////////////
+  /// @brief Converts direct form filter weights, as used by
+  ///        Filter, to second order sections. The numerator
+  ///        and denominator are factored into zeros and poles,
+  ///        conjugate pairs are grouped, and each pole pair is
+  ///        matched with its nearest zero pair. Sections with
+  ///        poles closest to the unit circle come last, and the
+  ///        overall gain is applied to the first section.
+  /// @param numInWeights  -- Number of input weights (b).
+  /// @param inWeights     -- The input weights.
+  /// @param numOutWeights -- Number of output weights (a).
+  /// @param outWeights    -- The output weights.
+  /// @return The equivalent sections.
+  /// @throws std::invalid_argument if a[0] is zero or either
+  ///         weight list is empty.
+  ////////////////////////////////////////////////////////////
+  static std::vector<BiquadSection> FromWeights(
+      unsigned int numInWeights, const float* inWeights,
+      unsigned int numOutWeights, const float* outWeights);
+  ////////////////////////////////////////////////////////////
+  /// @brief Groups a digital filter's zeros and poles into
+  ///        second order sections, the same way FromWeights
+  ///        does, for the transfer function \par
+  ///
+  /// <CENTER>
+  ///   \f$ H(z) = k \frac{\prod (z - zeros_i)}{\prod (z - poles_i)} \f$
+  /// </CENTER>
+  ///
+  /// Complex zeros and poles must come in conjugate pairs.
+  /// When there are fewer zeros than poles the difference is
+  /// realized as a delay.
+  /// @param zeros -- The filter's zeros.
+  /// @param poles -- The filter's poles.
+  /// @param gain  -- The gain k.
+  /// @return The equivalent sections.
+  ////////////////////////////////////////////////////////////
+  static std::vector<BiquadSection> FromZerosPoles(
+      const std::vector<std::complex<double> >& zeros,
+      const std::vector<std::complex<double> >& poles,
+      double gain);
+  ////////////////////////////////////////////////////////////
+  /// @brief Main filter routine.
+  /// @param inputValue input value.
+  /// @return Output from the filter
+  ////////////////////////////////////////////////////////////
+  float filter(float inputValue);
+  ////////////////////////////////////////////////////////////
+  /// @brief Block filter routine. Each section runs over the
+  ///        whole block before the next, so its weights and
+  ///        state stay in registers.
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for the filter outputs.
+  ///                      May alias input.
+  /// @param numSamples -- Number of samples in the block.
+  ////////////////////////////////////////////////////////////
+  void filterBlock(const float* input, float* output,
+                   unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief Zeroes the state of every section.
+  ////////////////////////////////////////////////////////////
+  void reset(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the section count.
+  /// @return The number of sections.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetNumSections(void) const {
+                 return static_cast<unsigned int>(_sections.size()); }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the sections.
+  /// @return The sections, in the order they are applied.
+  ////////////////////////////////////////////////////////////
+  inline const BiquadSection* GetSections(void) const {
+                                  return &_sections[0]; }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Transposed direct form II state of one section.
+  ////////////////////////////////////////////////////////////
+  struct SectionState {
+    float z1, z2;
+  };
+  ////////////////////////////////////////////////////////////
+  /// @brief The sections, applied in order.
+  ////////////////////////////////////////////////////////////
+  std::vector<BiquadSection> _sections;
+  ////////////////////////////////////////////////////////////
+  /// @brief State of each section.
+  ////////////////////////////////////////////////////////////
+  std::vector<SectionState> _state;
+};
+
+#endif  // BIQUAD_CASCADE_HH
@@ -1,17 +1,70 @@
 #include "ButterworthLowPass3rdOrder.hh"
+#include "FilterDesign.hh"
+
+////////////////////////////////////////////////////////////
+/// @brief Filter weights, fixed at compile time.
+////////////////////////////////////////////////////////////
+static constexpr StaticFilter<3, 3>::Coefficients kWeights = {
+  {0.33333f, 0.33333f, 0.33333f},
+  {1.0f, 0.0f, 0.0f}
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Weights of a second order Butterworth design, a
+///        single biquad section.
+////////////////////////////////////////////////////////////
+static StaticFilter<3, 3>::Coefficients designedWeights(double cutoff,
+                                                        double sampleRate){
+  const BiquadSection section =
+      designButterworthSections<2>(LOW_PASS, cutoff, sampleRate).sections[0];
+  const StaticFilter<3, 3>::Coefficients weights = {
+    {section.b0, section.b1, section.b2},
+    {1.0f, section.a1, section.a2}
+  };
+  return weights;
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the filter weights
+///        necessary for a three point moving average.
+////////////////////////////////////////////////////////////
+StaticButterworthLowPass3rdOrder::StaticButterworthLowPass3rdOrder() :
+         StaticFilter<3, 3>(kWeights)
+{
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor loads the designed weights.
+////////////////////////////////////////////////////////////
+StaticButterworthLowPass3rdOrder::StaticButterworthLowPass3rdOrder(
+    double cutoff, double sampleRate) :
+         StaticFilter<3, 3>(designedWeights(cutoff, sampleRate))
+{
+}
 
 //////////////////////////////////////////////////////////
 /// @brief The c'tor constructs the filter weights
 ///        necessary for a three point moving average.
 ////////////////////////////////////////////////////////////
-ButterworthLowPass3rdOrder::ButterworthLowPass3rdOrder()
+ButterworthLowPass3rdOrder::ButterworthLowPass3rdOrder() :
+         Filter(std::vector<float>(kWeights.inputWeights,
+                                   kWeights.inputWeights + 3),
+                std::vector<float>(kWeights.outputWeights,
+                                   kWeights.outputWeights + 3))
+{
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor loads the weights of a second order
+///        Butterworth design, a single biquad section.
+////////////////////////////////////////////////////////////
+ButterworthLowPass3rdOrder::ButterworthLowPass3rdOrder(double cutoff,
+                                                       double sampleRate) :
+         ButterworthLowPass3rdOrder()
 {
-  _numInWeights = 3;
-  _numOutWeights = 3;
-  _inputWeights[0] = 0.33333;
-  _inputWeights[1] = 0.33333;
-  _inputWeights[2] = 0.33333;
-  _outputWeights[0]   = 1;
+  StaticFilter<3, 3>::Coefficients weights =
+      designedWeights(cutoff, sampleRate);
+  SetWeights(3, weights.inputWeights, 3, weights.outputWeights);
 }
 
 ////////////////////////////////////////////////////////////
@@ -20,3 +73,24 @@ ButterworthLowPass3rdOrder::ButterworthLowPass3rdOrder()
 ButterworthLowPass3rdOrder::~ButterworthLowPass3rdOrder() {
 
 }
+
+////////////////////////////////////////////////////////////
+/// @brief Three input, three output tap block loop.
+/// @param input      -- Input samples, oldest first.
+/// @param output     -- Destination for the filter outputs.
+/// @param numSamples -- Number of samples in the block.
+////////////////////////////////////////////////////////////
+void ButterworthLowPass3rdOrder::filterBlock(const float* input,
+                                             float* output,
+                                             unsigned int numSamples) {
+  staticFilterBlock<StaticFilter<3, 3> >(input, output, numSamples);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief staticFilterBlock runs the same equation as
+///        Filter::filter.
+/// @return true.
+////////////////////////////////////////////////////////////
+bool ButterworthLowPass3rdOrder::IsDifferenceEquation(void) const {
+  return true;
+}
@@ -1,7 +1,8 @@
 ///////////////////////////////////////////////////////////////
 /// @ingroup This class defines a three point moving average
 ///          filter. It derives from the generic digital
-///          Filter base class.
+///          Filter base class. A compile time StaticFilter
+///          version is defined alongside it.
 ///
 /// @author
 ///         $Author: Mike Moore $
@@ -15,6 +16,35 @@
 #define BUTTERWORTH_LOW_PASS_3RD_ORDER_HH
 
 #include "Filter.hh"
+#include "StaticFilter.hh"
+
+///////////////////////////////////////////////////////////////
+/// @class StaticButterworthLowPass3rdOrder
+/// @ingroup DSP
+/// @brief ButterworthLowPass3rdOrder as a StaticFilter, for
+///        use where the tap counts must be known at compile
+///        time, such as a StaticFilterChain stage.
+///////////////////////////////////////////////////////////////
+class StaticButterworthLowPass3rdOrder : public StaticFilter<3, 3> {
+
+ public:
+  //////////////////////////////////////////////////////////
+  /// @brief The default c'tor constructs the
+  ///        StaticButterworthLowPass3rdOrder class with the
+  ///        same weights as ButterworthLowPass3rdOrder.
+  ////////////////////////////////////////////////////////////
+  StaticButterworthLowPass3rdOrder();
+  //////////////////////////////////////////////////////////
+  /// @brief This c'tor builds the same designed low pass as
+  ///        the matching ButterworthLowPass3rdOrder c'tor.
+  /// @param cutoff     -- Cutoff in Hz.
+  /// @param sampleRate -- Sample rate in Hz.
+  /// @throws std::invalid_argument if the cutoff is not
+  ///         between 0 and sampleRate/2.
+  ////////////////////////////////////////////////////////////
+  StaticButterworthLowPass3rdOrder(double cutoff, double sampleRate);
+
+};
 
 ///////////////////////////////////////////////////////////////
 /// @class ButterworthLowPass3rdOrder class defines a three point
@@ -31,10 +61,36 @@ class ButterworthLowPass3rdOrder : public Filter {
   ////////////////////////////////////////////////////////////
   ButterworthLowPass3rdOrder();
   //////////////////////////////////////////////////////////
+  /// @brief This c'tor builds a true second order (three
+  ///        weight) Butterworth low pass with the given
+  ///        cutoff, designed with designButterworthSections.
+  /// @param cutoff     -- Cutoff in Hz.
+  /// @param sampleRate -- Sample rate in Hz.
+  /// @throws std::invalid_argument if the cutoff is not
+  ///         between 0 and sampleRate/2.
+  ////////////////////////////////////////////////////////////
+  ButterworthLowPass3rdOrder(double cutoff, double sampleRate);
+  //////////////////////////////////////////////////////////
   /// @brief The default d'tor destructs the
   ///        ButterworthLowPass3rdOrder class
   ////////////////////////////////////////////////////////////
   ~ButterworthLowPass3rdOrder();
+  ////////////////////////////////////////////////////////////
+  /// @brief Block filter routine specialized for this
+  ///        filter's fixed tap counts. The block runs through
+  ///        a StaticFilter<3, 3> loaded from this filter's
+  ///        state (see Filter::staticFilterBlock).
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for the filter outputs.
+  /// @param numSamples -- Number of samples in the block.
+  ////////////////////////////////////////////////////////////
+  virtual void filterBlock(const float* input, float* output,
+                           unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief The block routine is the difference equation.
+  /// @return true.
+  ////////////////////////////////////////////////////////////
+  virtual bool IsDifferenceEquation(void) const;
 
 };
 
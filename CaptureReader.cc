@@ -0,0 +1,478 @@
+#include "CaptureReader.hh"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////
+/// @brief Magic at the start of a packed binary capture,
+///        including its terminating nul.
+////////////////////////////////////////////////////////////
+static const char BINARY_MAGIC[8] = "FLTCAP1";
+
+////////////////////////////////////////////////////////////
+/// @brief Size of the fixed part of the binary header: the
+///        magic, the column count and the data offset.
+////////////////////////////////////////////////////////////
+static const size_t BINARY_HEADER_SIZE = 16;
+
+////////////////////////////////////////////////////////////
+/// @brief Powers of ten that are exact in double.
+////////////////////////////////////////////////////////////
+static const double EXACT_POWERS_OF_TEN[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Largest mantissa that still has room for one more
+///        digit while staying exact in double.
+////////////////////////////////////////////////////////////
+static const uint64_t MANTISSA_LIMIT = (uint64_t(1) << 53)/10;
+
+////////////////////////////////////////////////////////////
+/// @brief True at the end of a CSV field.
+////////////////////////////////////////////////////////////
+static inline bool isDelimiter(char c){
+  return c == ',' || c == '\n' || c == '\r';
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Parses a decimal number in place, without the nul
+///        terminator strtof needs, so the mapping is read
+///        directly. Mantissas up to 2^53 with exponents up to
+///        22 are converted exactly; longer numbers fall back
+///        to pow.
+/// @param p     -- Start of the field; left at the delimiter.
+/// @param end   -- End of the mapping.
+/// @param value -- Receives the number.
+/// @return false if the field is not a number.
+////////////////////////////////////////////////////////////
+static bool parseNumber(const char*& p, const char* end, float& value){
+  while (p < end && (*p == ' ' || *p == '\t')) { ++p; }
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')){
+    negative = (*p == '-');
+    ++p;
+  }
+  uint64_t mantissa = 0;
+  int exponent = 0;
+  unsigned int digits = 0;
+  for (; p < end && *p >= '0' && *p <= '9'; ++p, ++digits){
+    if (mantissa < MANTISSA_LIMIT){
+      mantissa = mantissa*10 + (*p - '0');
+    } else {
+      exponent++;
+    }
+  }
+  if (p < end && *p == '.'){
+    for (++p; p < end && *p >= '0' && *p <= '9'; ++p, ++digits){
+      if (mantissa < MANTISSA_LIMIT){
+        mantissa = mantissa*10 + (*p - '0');
+        exponent--;
+      }
+    }
+  }
+  if (digits == 0){
+    return false;
+  }
+  if (p < end && (*p == 'e' || *p == 'E')){
+    ++p;
+    bool negativeExponent = false;
+    if (p < end && (*p == '-' || *p == '+')){
+      negativeExponent = (*p == '-');
+      ++p;
+    }
+    if (p == end || *p < '0' || *p > '9'){
+      return false;
+    }
+    int written = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p){
+      if (written < 10000){
+        written = written*10 + (*p - '0');
+      }
+    }
+    exponent += negativeExponent ? -written : written;
+  }
+  while (p < end && (*p == ' ' || *p == '\t')) { ++p; }
+  if (p < end && !isDelimiter(*p)){
+    return false;
+  }
+  double result = static_cast<double>(mantissa);
+  if (exponent > 0 && exponent <= 22){
+    result *= EXACT_POWERS_OF_TEN[exponent];
+  } else if (exponent < 0 && exponent >= -22){
+    result /= EXACT_POWERS_OF_TEN[-exponent];
+  } else if (exponent != 0){
+    result *= std::pow(10.0, exponent);
+  }
+  value = static_cast<float>(negative ? -result : result);
+  return true;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Strips blanks and surrounding quotes from a CSV
+///        header field.
+////////////////////////////////////////////////////////////
+static std::string trimField(const char* begin, const char* end){
+  while (begin < end && (*begin == ' ' || *begin == '\t')) { ++begin; }
+  while (end > begin && (end[-1] == ' ' || end[-1] == '\t' ||
+                         end[-1] == '\r')) { --end; }
+  if (end - begin >= 2 && *begin == '"' && end[-1] == '"'){
+    ++begin;
+    --end;
+  }
+  return std::string(begin, end);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Reads a little endian uint32 from the mapping.
+////////////////////////////////////////////////////////////
+static uint32_t readUint32(const char* p){
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(p);
+  return uint32_t(bytes[0]) | (uint32_t(bytes[1]) << 8) |
+         (uint32_t(bytes[2]) << 16) | (uint32_t(bytes[3]) << 24);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Appends a little endian uint32 to a header.
+////////////////////////////////////////////////////////////
+static void appendUint32(std::string& header, uint32_t value){
+  for (unsigned int i=0; i<4; i++){
+    header.push_back(static_cast<char>((value >> (8*i)) & 0xff));
+  }
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor maps the capture and reads its header.
+////////////////////////////////////////////////////////////
+CaptureReader::CaptureReader(const std::string& path) :
+         _data(NULL),
+         _size(0),
+         _format(CSV_FORMAT),
+         _columnNames(),
+         _selected(),
+         _slots(),
+         _dataOffset(0),
+         _position(0),
+         _line(1)
+{
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0){
+    throw std::runtime_error("CaptureReader cannot open " + path + ": " +
+                             std::strerror(errno));
+  }
+  struct stat info;
+  if (::fstat(fd, &info) != 0 || info.st_size <= 0){
+    ::close(fd);
+    throw std::runtime_error("CaptureReader found no data in " + path);
+  }
+  _size = static_cast<size_t>(info.st_size);
+  void* mapping = ::mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED){
+    throw std::runtime_error("CaptureReader cannot map " + path + ": " +
+                             std::strerror(errno));
+  }
+  _data = static_cast<const char*>(mapping);
+  ::madvise(mapping, _size, MADV_SEQUENTIAL);
+  try {
+    if (_size >= sizeof(BINARY_MAGIC) &&
+        std::memcmp(_data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0){
+      _format = BINARY_FORMAT;
+      parseBinaryHeader();
+    } else {
+      parseCsvHeader();
+    }
+    std::vector<unsigned int> all;
+    for (unsigned int i=0; i<_columnNames.size(); i++){
+      all.push_back(i);
+    }
+    selectColumns(all);
+  } catch (...) {
+    ::munmap(mapping, _size);
+    throw;
+  }
+  _position = _dataOffset;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+CaptureReader::~CaptureReader() {
+  ::munmap(const_cast<char*>(_data), _size);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Splits the first line on commas.
+////////////////////////////////////////////////////////////
+void CaptureReader::parseCsvHeader(void){
+  const char* end = _data + _size;
+  const char* lineEnd = static_cast<const char*>(
+      std::memchr(_data, '\n', _size));
+  if (lineEnd == NULL){
+    lineEnd = end;
+  }
+  const char* field = _data;
+  for (const char* p = _data; ; ++p){
+    if (p == lineEnd || *p == ','){
+      _columnNames.push_back(trimField(field, p));
+      field = p + 1;
+      if (p == lineEnd){
+        break;
+      }
+    }
+  }
+  _dataOffset = (lineEnd == end) ? _size : (lineEnd - _data) + 1;
+  _line = 2;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Reads the column count, data offset and names.
+////////////////////////////////////////////////////////////
+void CaptureReader::parseBinaryHeader(void){
+  if (_size < BINARY_HEADER_SIZE){
+    throw std::runtime_error("CaptureReader binary header is truncated");
+  }
+  const uint32_t numColumns = readUint32(_data + 8);
+  _dataOffset = readUint32(_data + 12);
+  /// The frames are read in place as floats, so they must
+  /// start on a float boundary of the page aligned mapping.
+  if (numColumns == 0 || _dataOffset < BINARY_HEADER_SIZE ||
+      _dataOffset > _size || _dataOffset % sizeof(float) != 0){
+    throw std::runtime_error("CaptureReader binary header is malformed");
+  }
+  const char* p = _data + BINARY_HEADER_SIZE;
+  const char* end = _data + _dataOffset;
+  while (_columnNames.size() < numColumns){
+    const char* lineEnd = static_cast<const char*>(
+        std::memchr(p, '\n', end - p));
+    if (lineEnd == NULL){
+      throw std::runtime_error("CaptureReader binary header is missing "
+                               "column names");
+    }
+    _columnNames.push_back(std::string(p, lineEnd));
+    p = lineEnd + 1;
+  }
+  if ((_size - _dataOffset) % (numColumns*sizeof(float)) != 0){
+    throw std::runtime_error("CaptureReader binary capture ends in a "
+                             "partial frame");
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Points into the mapping past the binary header.
+/// @return The first frame, or NULL for a CSV capture.
+////////////////////////////////////////////////////////////
+const float* CaptureReader::GetBinaryFrames(void) const {
+  if (_format != BINARY_FORMAT){
+    return NULL;
+  }
+  return reinterpret_cast<const float*>(_data + _dataOffset);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Counts the whole frames after the binary header.
+/// @return The number of frames; zero for a CSV capture.
+////////////////////////////////////////////////////////////
+size_t CaptureReader::GetNumBinaryFrames(void) const {
+  if (_format != BINARY_FORMAT){
+    return 0;
+  }
+  return (_size - _dataOffset)/(_columnNames.size()*sizeof(float));
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Looks up a column by name or index.
+/// @param name -- Column name or index.
+/// @return The column index.
+////////////////////////////////////////////////////////////
+unsigned int CaptureReader::findColumn(const std::string& name) const {
+  for (unsigned int i=0; i<_columnNames.size(); i++){
+    if (_columnNames[i] == name){
+      return i;
+    }
+  }
+  if (!name.empty() &&
+      name.find_first_not_of("0123456789") == std::string::npos){
+    const unsigned long index = std::strtoul(name.c_str(), NULL, 10);
+    if (index < _columnNames.size()){
+      return static_cast<unsigned int>(index);
+    }
+  }
+  throw std::invalid_argument("CaptureReader has no column '" + name + "'");
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Replaces the selection with a single column.
+/// @param column -- Column index.
+////////////////////////////////////////////////////////////
+void CaptureReader::selectColumn(unsigned int column){
+  selectColumns(std::vector<unsigned int>(1, column));
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Replaces the selection.
+/// @param columns -- Column indices, in frame order.
+////////////////////////////////////////////////////////////
+void CaptureReader::selectColumns(const std::vector<unsigned int>& columns){
+  if (columns.empty()){
+    throw std::invalid_argument("CaptureReader needs at least one column");
+  }
+  std::vector<int> slots(_columnNames.size(), -1);
+  for (unsigned int i=0; i<columns.size(); i++){
+    if (columns[i] >= _columnNames.size()){
+      throw std::invalid_argument("CaptureReader column index out of range");
+    }
+    slots[columns[i]] = static_cast<int>(i);
+  }
+  _selected = columns;
+  _slots.swap(slots);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Decodes the next frames of the selected columns.
+/// @param output    -- Receives the interleaved frames.
+/// @param maxFrames -- Capacity of output in frames.
+/// @return The number of frames decoded.
+////////////////////////////////////////////////////////////
+unsigned int CaptureReader::readFrames(float* output,
+                                       unsigned int maxFrames){
+  if (_format == BINARY_FORMAT){
+    return readBinaryFrames(output, maxFrames);
+  }
+  return readCsvFrames(output, maxFrames);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Starts reading again from the first frame.
+////////////////////////////////////////////////////////////
+void CaptureReader::rewind(void){
+  _position = _dataOffset;
+  _line = 2;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Decodes CSV rows. Unselected fields are skipped
+///        without being parsed, and blank lines are ignored.
+///        A column selected twice is decoded into the last
+///        slot naming it and copied to the others.
+////////////////////////////////////////////////////////////
+unsigned int CaptureReader::readCsvFrames(float* output,
+                                          unsigned int maxFrames){
+  const char* p = _data + _position;
+  const char* end = _data + _size;
+  const unsigned int numSelected = GetNumSelected();
+  const unsigned int numColumns = static_cast<unsigned int>(_slots.size());
+  unsigned int numFrames = 0;
+  while (numFrames < maxFrames && p < end){
+    if (*p == '\n' || *p == '\r'){
+      if (*p == '\n') { _line++; }
+      ++p;
+      continue;
+    }
+    float* frame = output + numFrames*numSelected;
+    unsigned int found = 0;
+    for (unsigned int column=0; ; column++){
+      const int slot = column < numColumns ? _slots[column] : -1;
+      if (slot >= 0){
+        if (!parseNumber(p, end, frame[slot])){
+          _position = p - _data;
+          throw std::runtime_error("CaptureReader found a malformed number "
+                                   "in '" + _columnNames[column] +
+                                   "' on line " + std::to_string(_line));
+        }
+        found++;
+      } else {
+        while (p < end && *p != ',' && *p != '\n') { ++p; }
+      }
+      if (p < end && *p == ','){
+        ++p;
+        continue;
+      }
+      break;
+    }
+    while (p < end && *p != '\n') { ++p; }
+    if (p < end) { ++p; }
+    if (found < numSelected){
+      for (unsigned int i=0; i<numSelected; i++){
+        const unsigned int column = _selected[i];
+        if (static_cast<unsigned int>(_slots[column]) != i){
+          frame[i] = frame[_slots[column]];
+          found++;
+        }
+      }
+      if (found < numSelected){
+        _position = p - _data;
+        throw std::runtime_error("CaptureReader found a short row on line " +
+                                 std::to_string(_line));
+      }
+    }
+    _line++;
+    numFrames++;
+  }
+  _position = p - _data;
+  return numFrames;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Decodes packed binary frames. A selection of every
+///        column in order is a straight copy.
+////////////////////////////////////////////////////////////
+unsigned int CaptureReader::readBinaryFrames(float* output,
+                                             unsigned int maxFrames){
+  const size_t numColumns = _columnNames.size();
+  const size_t frameBytes = numColumns*sizeof(float);
+  const size_t available = (_size - _position)/frameBytes;
+  const unsigned int numFrames = static_cast<unsigned int>(
+      available < maxFrames ? available : maxFrames);
+  const char* frame = _data + _position;
+  const unsigned int numSelected = GetNumSelected();
+  bool identity = (numSelected == numColumns);
+  for (unsigned int i=0; identity && i<numSelected; i++){
+    identity = (_selected[i] == i);
+  }
+  if (identity){
+    std::memcpy(output, frame, numFrames*frameBytes);
+  } else {
+    for (unsigned int n=0; n<numFrames; n++, frame += frameBytes){
+      for (unsigned int i=0; i<numSelected; i++){
+        std::memcpy(output++, frame + _selected[i]*sizeof(float),
+                    sizeof(float));
+      }
+    }
+  }
+  _position += numFrames*frameBytes;
+  return numFrames;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Writes a packed binary capture header, padded so
+///        the frames start on a float boundary.
+/// @param file        -- Destination.
+/// @param columnNames -- Names of the columns in each frame.
+/// @return false if the write failed.
+////////////////////////////////////////////////////////////
+bool CaptureReader::writeBinaryHeader(std::FILE* file,
+                                      const std::vector<std::string>& columnNames){
+  std::string names;
+  for (size_t i=0; i<columnNames.size(); i++){
+    names += columnNames[i];
+    names += '\n';
+  }
+  while ((BINARY_HEADER_SIZE + names.size()) % sizeof(float) != 0){
+    names += '\0';
+  }
+  std::string header(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  appendUint32(header, static_cast<uint32_t>(columnNames.size()));
+  appendUint32(header, static_cast<uint32_t>(BINARY_HEADER_SIZE + names.size()));
+  header += names;
+  return std::fwrite(header.data(), 1, header.size(), file) == header.size();
+}
@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class reads recorded captures, such as the
+///          500 Hz motor control test stand CSV files, straight
+///          out of a memory mapping so large captures can be
+///          replayed through the filters without copying them.
+///
+///////////////////////////////////////////////////////////////
+#ifndef CAPTURE_READER_HH
+#define CAPTURE_READER_HH
+
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @class CaptureReader
+/// @ingroup DSP
+/// @brief Memory maps a capture and decodes a selection of its
+///        columns into caller supplied blocks of interleaved
+///        float frames. Two formats are understood:
+///
+///   - CSV, with a header row naming the columns, as written
+///     by the test stand and read by ChupacabraAnalysis.py.
+///   - Packed binary: the 8 byte magic "FLTCAP1", a uint32
+///     column count, a uint32 offset to the first frame (a
+///     multiple of 4), the column names one per line, padded
+///     to that offset, then little endian float32
+///     frames, one value per column. writeBinaryHeader emits
+///     the header.
+///
+/// The format is detected from the magic. Decoding happens in
+/// readFrames directly from the mapping; nothing is allocated
+/// per row.
+///
+/// @code
+///   CaptureReader capture("MotorControlTestStandVelocityControl_500Hz.csv");
+///   capture.selectColumn(capture.findColumn("Sensed Velocity (rpm)"));
+///   float block[4096];
+///   unsigned int numFrames;
+///   while ((numFrames = capture.readFrames(block, 4096)) > 0){ ... }
+/// @endcode
+///////////////////////////////////////////////////////////////
+class CaptureReader {
+
+ public:
+  ////////////////////////////////////////////////////////////
+  /// @brief The capture formats a reader understands.
+  ////////////////////////////////////////////////////////////
+  enum Format {
+    CSV_FORMAT,
+    BINARY_FORMAT
+  };
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor maps the capture and reads its
+  ///        header. Every column starts out selected.
+  /// @param path -- Path of the capture file.
+  /// @throws std::runtime_error if the file cannot be mapped
+  ///         or its header is malformed.
+  ////////////////////////////////////////////////////////////
+  explicit CaptureReader(const std::string& path);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the CaptureReader
+  ///        and unmaps the capture.
+  ////////////////////////////////////////////////////////////
+  ~CaptureReader();
+  CaptureReader(const CaptureReader&) = delete;
+  CaptureReader& operator=(const CaptureReader&) = delete;
+  ////////////////////////////////////////////////////////////
+  /// @brief Looks up a column by name. A name that is a
+  ///        plain number is taken as a column index.
+  /// @param name -- Column name or index.
+  /// @return The column index.
+  /// @throws std::invalid_argument if there is no such column.
+  ////////////////////////////////////////////////////////////
+  unsigned int findColumn(const std::string& name) const;
+  ////////////////////////////////////////////////////////////
+  /// @brief Replaces the selection with a single column.
+  /// @param column -- Column index.
+  /// @throws std::invalid_argument if the index is out of
+  ///         range.
+  ////////////////////////////////////////////////////////////
+  void selectColumn(unsigned int column);
+  ////////////////////////////////////////////////////////////
+  /// @brief Replaces the selection. Frames hold the selected
+  ///        columns in the order given here.
+  /// @param columns -- Column indices.
+  /// @throws std::invalid_argument if the list is empty or an
+  ///         index is out of range.
+  ////////////////////////////////////////////////////////////
+  void selectColumns(const std::vector<unsigned int>& columns);
+  ////////////////////////////////////////////////////////////
+  /// @brief Decodes the next frames of the selected columns.
+  /// @param output    -- Receives up to
+  ///                     maxFrames*GetNumSelected() samples,
+  ///                     interleaved by frame.
+  /// @param maxFrames -- Capacity of output in frames.
+  /// @return The number of frames decoded; zero at the end of
+  ///         the capture.
+  /// @throws std::runtime_error if a CSV row is missing a
+  ///         selected column or holds a malformed number.
+  ////////////////////////////////////////////////////////////
+  unsigned int readFrames(float* output, unsigned int maxFrames);
+  ////////////////////////////////////////////////////////////
+  /// @brief Starts reading again from the first frame.
+  ////////////////////////////////////////////////////////////
+  void rewind(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Writes a packed binary capture header. The frames
+  ///        follow as float32 values.
+  /// @param file        -- Destination, positioned at its
+  ///                       start.
+  /// @param columnNames -- Names of the columns in each frame.
+  /// @return false if the write failed.
+  ////////////////////////////////////////////////////////////
+  static bool writeBinaryHeader(std::FILE* file,
+                                const std::vector<std::string>& columnNames);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the capture format.
+  /// @return The detected format.
+  ////////////////////////////////////////////////////////////
+  inline Format GetFormat(void) const { return _format; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the column names.
+  /// @return The names from the capture header.
+  ////////////////////////////////////////////////////////////
+  inline const std::vector<std::string>& GetColumnNames(void) const {
+                                  return _columnNames; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the selection size.
+  /// @return The number of samples in each decoded frame.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetNumSelected(void) const {
+                                  return static_cast<unsigned int>(_selected.size()); }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the selection.
+  /// @return The selected column indices, in frame order.
+  ////////////////////////////////////////////////////////////
+  inline const std::vector<unsigned int>& GetSelectedColumns(void) const {
+                                  return _selected; }
+  ////////////////////////////////////////////////////////////
+  /// @brief Direct access to a packed binary capture's frames
+  ///        in the mapping, for tools that work on the whole
+  ///        capture at once. Frames hold every column,
+  ///        whatever the selection.
+  /// @return The first frame, or NULL for a CSV capture.
+  ////////////////////////////////////////////////////////////
+  const float* GetBinaryFrames(void) const;
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get a packed binary
+  ///        capture's length.
+  /// @return The number of frames; zero for a CSV capture.
+  ////////////////////////////////////////////////////////////
+  size_t GetNumBinaryFrames(void) const;
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Decodes CSV rows.
+  ////////////////////////////////////////////////////////////
+  unsigned int readCsvFrames(float* output, unsigned int maxFrames);
+  ////////////////////////////////////////////////////////////
+  /// @brief Decodes packed binary frames.
+  ////////////////////////////////////////////////////////////
+  unsigned int readBinaryFrames(float* output, unsigned int maxFrames);
+  ////////////////////////////////////////////////////////////
+  /// @brief Reads the CSV header row.
+  ////////////////////////////////////////////////////////////
+  void parseCsvHeader(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Reads the packed binary header.
+  ////////////////////////////////////////////////////////////
+  void parseBinaryHeader(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Start of the mapping.
+  ////////////////////////////////////////////////////////////
+  const char* _data;
+  ////////////////////////////////////////////////////////////
+  /// @brief Size of the mapping in bytes.
+  ////////////////////////////////////////////////////////////
+  size_t _size;
+  ////////////////////////////////////////////////////////////
+  /// @brief The capture format.
+  ////////////////////////////////////////////////////////////
+  Format _format;
+  ////////////////////////////////////////////////////////////
+  /// @brief Column names from the header.
+  ////////////////////////////////////////////////////////////
+  std::vector<std::string> _columnNames;
+  ////////////////////////////////////////////////////////////
+  /// @brief Selected columns, in frame order.
+  ////////////////////////////////////////////////////////////
+  std::vector<unsigned int> _selected;
+  ////////////////////////////////////////////////////////////
+  /// @brief For every column, its slot in a decoded frame, or
+  ///        -1 if it is not selected.
+  ////////////////////////////////////////////////////////////
+  std::vector<int> _slots;
+  ////////////////////////////////////////////////////////////
+  /// @brief Offset of the first frame or data row.
+  ////////////////////////////////////////////////////////////
+  size_t _dataOffset;
+  ////////////////////////////////////////////////////////////
+  /// @brief Offset of the next frame or row to decode.
+  ////////////////////////////////////////////////////////////
+  size_t _position;
+  ////////////////////////////////////////////////////////////
+  /// @brief Line number of the next CSV row, for errors.
+  ////////////////////////////////////////////////////////////
+  unsigned long _line;
+};
+
+#endif  // CAPTURE_READER_HH
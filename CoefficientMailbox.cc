@@ -0,0 +1,74 @@
+#include "CoefficientMailbox.hh"
+#include "SampleTraits.hh"
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members.
+////////////////////////////////////////////////////////////
+CoefficientMailbox::CoefficientMailbox(unsigned int maxInWeights,
+                                       unsigned int maxOutWeights) :
+         _maxInWeights(maxInWeights),
+         _maxOutWeights(maxOutWeights),
+         _middle(1),
+         _back(0),
+         _front(2)
+{
+  if (maxInWeights == 0 || maxOutWeights == 0){
+    throw std::invalid_argument("CoefficientMailbox weight counts must be at "
+                                "least 1");
+  }
+  for (unsigned int s=0; s<3; s++){
+    _slots[s].numInWeights = 0;
+    _slots[s].numOutWeights = 0;
+    _slots[s].inWeights.assign(maxInWeights, 0.0f);
+    _slots[s].outWeights.assign(maxOutWeights, 0.0f);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+CoefficientMailbox::~CoefficientMailbox() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Fills the control thread's slot, then swaps it
+///        with the shared one. The release half of the
+///        exchange orders the slot's contents before the
+///        index the filter thread will read.
+/// @param inWeights  -- The input weights (b).
+/// @param outWeights -- The output weights (a).
+////////////////////////////////////////////////////////////
+void CoefficientMailbox::publish(const std::vector<float>& inWeights,
+                                 const std::vector<float>& outWeights){
+  if (inWeights.empty() || outWeights.empty() ||
+      inWeights.size() > _maxInWeights || outWeights.size() > _maxOutWeights){
+    throw std::invalid_argument("CoefficientMailbox weight counts must be 1 "
+                                "to the mailbox maximum");
+  }
+  CoefficientSet& slot = _slots[_back];
+  const unsigned int numInWeights = static_cast<unsigned int>(inWeights.size());
+  const unsigned int numOutWeights =
+      static_cast<unsigned int>(outWeights.size());
+  normalizeWeights<SampleTraits<float> >(numInWeights, inWeights.data(),
+                                         numOutWeights, outWeights.data(),
+                                         slot.inWeights.data(),
+                                         slot.outWeights.data());
+  slot.numInWeights = numInWeights;
+  slot.numOutWeights = numOutWeights;
+  _back = _middle.exchange(_back | FRESH, std::memory_order_acq_rel) & 3;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Swaps the shared slot in if it holds a new set.
+///        The acquire half of the exchange makes the slot's
+///        contents visible.
+/// @return The new set, or NULL.
+////////////////////////////////////////////////////////////
+const CoefficientSet* CoefficientMailbox::take(void){
+  if ((_middle.load(std::memory_order_relaxed) & FRESH) == 0){
+    return NULL;
+  }
+  _front = _middle.exchange(_front, std::memory_order_acq_rel) & 3;
+  return &_slots[_front];
+}
@@ -0,0 +1,140 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup Lock free triple buffer that hands new filter
+///          weights from a control thread to a filter thread.
+///
+///////////////////////////////////////////////////////////////
+#ifndef COEFFICIENT_MAILBOX_HH
+#define COEFFICIENT_MAILBOX_HH
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @brief One set of weights, normalized so a[0] is 1.
+///////////////////////////////////////////////////////////////
+struct CoefficientSet {
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of input weights in use.
+  ////////////////////////////////////////////////////////////
+  unsigned int numInWeights;
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of output weights in use.
+  ////////////////////////////////////////////////////////////
+  unsigned int numOutWeights;
+  ////////////////////////////////////////////////////////////
+  /// @brief Input weights (b), sized to the mailbox maximum.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> inWeights;
+  ////////////////////////////////////////////////////////////
+  /// @brief Output weights (a), sized to the mailbox maximum.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> outWeights;
+};
+
+///////////////////////////////////////////////////////////////
+/// @class CoefficientMailbox
+/// @ingroup DSP
+/// @brief Passes weight sets from exactly one control thread
+///        to exactly one filter thread. Neither side locks,
+///        waits or allocates: publish() writes a private
+///        slot and swaps it into the shared middle slot, and
+///        take() swaps the middle slot out when it holds a set
+///        the filter thread has not seen. Of several sets
+///        published between two takes, only the newest is
+///        delivered. A set is never read while it is written.
+///
+/// The weights are checked and normalized by publish(), on
+/// the control thread, so the filter thread has nothing left
+/// to fail. Every slot is sized for the largest counts at
+/// construction.
+///
+/// @code
+///   CoefficientMailbox mailbox(5, 5);
+///   TunableFilter lowPass(b, a, mailbox);   // filter thread
+///   mailbox.publish(newB, newA);            // control thread
+/// @endcode
+///////////////////////////////////////////////////////////////
+class CoefficientMailbox {
+
+ public:
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor sizes the slots.
+  /// @param maxInWeights  -- Most input weights a set has.
+  /// @param maxOutWeights -- Most output weights a set has.
+  /// @throws std::invalid_argument if a maximum is zero.
+  ////////////////////////////////////////////////////////////
+  CoefficientMailbox(unsigned int maxInWeights, unsigned int maxOutWeights);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the mailbox.
+  ////////////////////////////////////////////////////////////
+  ~CoefficientMailbox();
+  CoefficientMailbox(const CoefficientMailbox&) = delete;
+  CoefficientMailbox& operator=(const CoefficientMailbox&) = delete;
+  ////////////////////////////////////////////////////////////
+  /// @brief Control thread: publishes new weights. They are
+  ///        divided by a[0] here, as by Filter::SetWeights.
+  /// @param inWeights  -- The input weights (b).
+  /// @param outWeights -- The output weights (a).
+  /// @throws std::invalid_argument if a count is zero or
+  ///         above the maximum, a[0] is zero or not finite, or
+  ///         a normalized weight is not finite. Nothing is
+  ///         published then.
+  ////////////////////////////////////////////////////////////
+  void publish(const std::vector<float>& inWeights,
+               const std::vector<float>& outWeights);
+  ////////////////////////////////////////////////////////////
+  /// @brief Filter thread: collects the newest published set.
+  /// @return The set, valid until the next take(), or NULL if
+  ///         nothing was published since the last take().
+  ////////////////////////////////////////////////////////////
+  const CoefficientSet* take(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the input maximum.
+  /// @return Most input weights a set has.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetMaxInWeights(void) const { return _maxInWeights; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the output maximum.
+  /// @return Most output weights a set has.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetMaxOutWeights(void) const { return _maxOutWeights; }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Flag in _middle marking a set not yet taken.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int FRESH = 4;
+  ////////////////////////////////////////////////////////////
+  /// @brief Most input weights a set has.
+  ////////////////////////////////////////////////////////////
+  unsigned int _maxInWeights;
+  ////////////////////////////////////////////////////////////
+  /// @brief Most output weights a set has.
+  ////////////////////////////////////////////////////////////
+  unsigned int _maxOutWeights;
+  ////////////////////////////////////////////////////////////
+  /// @brief The three slots. At any time one belongs to each
+  ///        thread and one is shared.
+  ////////////////////////////////////////////////////////////
+  CoefficientSet _slots[3];
+  char _padShared[64];
+  ////////////////////////////////////////////////////////////
+  /// @brief Index of the shared slot, plus FRESH if it holds
+  ///        a set the filter thread has not taken.
+  ////////////////////////////////////////////////////////////
+  std::atomic<unsigned int> _middle;
+  char _padControl[64];
+  ////////////////////////////////////////////////////////////
+  /// @brief Index of the control thread's slot.
+  ////////////////////////////////////////////////////////////
+  unsigned int _back;
+  char _padFilter[64];
+  ////////////////////////////////////////////////////////////
+  /// @brief Index of the filter thread's slot.
+  ////////////////////////////////////////////////////////////
+  unsigned int _front;
+  char _padEnd[64];
+};
+
+#endif  // COEFFICIENT_MAILBOX_HH
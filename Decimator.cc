@@ -0,0 +1,89 @@
+#include "Decimator.hh"
+
+#include <cmath>
+#include <stdexcept>
+
+////////////////////////////////////////////////////////////
+/// @brief Rejects empty or non-finite taps and a zero factor.
+/// @param taps   -- The FIR weights.
+/// @param factor -- Inputs per output.
+/// @return taps.
+////////////////////////////////////////////////////////////
+static const std::vector<float>& checkedTaps(const std::vector<float>& taps,
+                                             unsigned int factor){
+  if (factor == 0){
+    throw std::invalid_argument("Decimator factor must be nonzero");
+  }
+  if (taps.empty()){
+    throw std::invalid_argument("Decimator needs at least one tap");
+  }
+  for (size_t i=0; i<taps.size(); i++){
+    if (!std::isfinite(taps[i])){
+      throw std::invalid_argument("Decimator taps must be finite");
+    }
+  }
+  return taps;
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members.
+////////////////////////////////////////////////////////////
+Decimator::Decimator(const std::vector<float>& taps, unsigned int factor) :
+         _factor(factor),
+         _taps(checkedTaps(taps, factor)),
+         _history(2*taps.size(), 0.0f),
+         _head(0),
+         _skip(0)
+{
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+Decimator::~Decimator() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Zeroes the history.
+////////////////////////////////////////////////////////////
+void Decimator::reset(void){
+  _history.assign(_history.size(), 0.0f);
+  _head = 0;
+  _skip = 0;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Every input goes into the history; only every
+///        _factor-th one is followed by a pass over the taps.
+/// @param input      -- Input samples, oldest first.
+/// @param output     -- Destination for the outputs.
+/// @param numSamples -- Number of input samples.
+/// @return Number of outputs written.
+////////////////////////////////////////////////////////////
+unsigned int Decimator::filterBlock(const float* input, float* output,
+                                    unsigned int numSamples){
+  const unsigned int numTaps = static_cast<unsigned int>(_taps.size());
+  const float* taps = &_taps[0];
+  float* history = &_history[0];
+  unsigned int count = 0;
+  for (unsigned int n=0; n<numSamples; n++){
+    _head = (_head == 0 ? numTaps : _head) - 1;
+    history[_head] = input[n];
+    history[_head + numTaps] = input[n];
+    if (_skip != 0){
+      _skip--;
+      continue;
+    }
+    const float* newest = history + _head;
+    float sum = 0.0f;
+    for (unsigned int k=0; k<numTaps; k++){
+      sum += taps[k]*newest[k];
+    }
+    /// Writing output[count] cannot clobber an unread input:
+    /// count <= n.
+    output[count++] = sum;
+    _skip = _factor - 1;
+  }
+  return count;
+}
@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class defines a decimating FIR filter that
+///          only computes the outputs it keeps.
+///
+///////////////////////////////////////////////////////////////
+#ifndef DECIMATOR_HH
+#define DECIMATOR_HH
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @class Decimator
+/// @ingroup DSP
+/// @brief Low pass filters and downsamples by an integer
+///        factor M. The output is what a direct form Filter
+///        built from the same b weights (a = {1}) would give
+///        for inputs 0, M, 2M, ..., but the M-1 outputs in
+///        between that would be thrown away are never
+///        computed, so the filtering work drops by M.
+///
+/// This is the polyphase form of the decimator: each kept
+/// output sums, over the phases p < M, phase p's taps
+/// h[p], h[p+M], ... applied to the inputs p, p+M, ... samples
+/// back; evaluated together that is one pass over the taps
+/// against the input history.
+///
+/// @code
+///   Decimator toArchive(lowPass, 10);  // 500 Hz to 50 Hz
+///   float archived[BLOCK/10 + 1];
+///   unsigned int count = toArchive.filterBlock(input, archived, BLOCK);
+/// @endcode
+///////////////////////////////////////////////////////////////
+class Decimator {
+
+ public:
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor builds the decimator with
+  ///        zeroed history. The next input gives an output.
+  /// @param taps   -- The FIR weights (b), at the input rate.
+  /// @param factor -- Inputs per output, at least 1.
+  /// @throws std::invalid_argument if there are no taps, a
+  ///         tap is not finite, or the factor is zero.
+  ////////////////////////////////////////////////////////////
+  Decimator(const std::vector<float>& taps, unsigned int factor);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the Decimator.
+  ////////////////////////////////////////////////////////////
+  ~Decimator();
+  ////////////////////////////////////////////////////////////
+  /// @brief Filters and downsamples a block of inputs.
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for the outputs; needs
+  ///                      room for GetMaxOutputs(numSamples).
+  ///                      May alias input.
+  /// @param numSamples -- Number of input samples.
+  /// @return Number of outputs written.
+  ////////////////////////////////////////////////////////////
+  unsigned int filterBlock(const float* input, float* output,
+                           unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief Zeroes the history; the next input gives an
+  ///        output.
+  ////////////////////////////////////////////////////////////
+  void reset(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Most outputs a block of inputs can give.
+  /// @param numSamples -- Number of input samples.
+  /// @return Upper bound on filterBlock's return value.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetMaxOutputs(unsigned int numSamples) const {
+                                  return (numSamples + _factor - 1)/_factor; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the factor.
+  /// @return Inputs per output.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetFactor(void) const { return _factor; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the tap count.
+  /// @return Number of FIR weights.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetNumTaps(void) const {
+                                  return static_cast<unsigned int>(
+                                      _taps.size()); }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Inputs per output.
+  ////////////////////////////////////////////////////////////
+  unsigned int _factor;
+  ////////////////////////////////////////////////////////////
+  /// @brief The FIR weights.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> _taps;
+  ////////////////////////////////////////////////////////////
+  /// @brief The last GetNumTaps() inputs, stored twice over so
+  ///        that they read newest first from _history[_head]
+  ///        without wrapping.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> _history;
+  ////////////////////////////////////////////////////////////
+  /// @brief Position of the newest input in _history.
+  ////////////////////////////////////////////////////////////
+  unsigned int _head;
+  ////////////////////////////////////////////////////////////
+  /// @brief Inputs still to come before the next output; 0
+  ///        when the next input gives one.
+  ////////////////////////////////////////////////////////////
+  unsigned int _skip;
+};
+
+#endif  // DECIMATOR_HH
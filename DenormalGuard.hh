@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class switches the floating point unit to
+///          flush denormals to zero for a scope.
+///
+///////////////////////////////////////////////////////////////
+#ifndef DENORMAL_GUARD_HH
+#define DENORMAL_GUARD_HH
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    defined(__SSE__)
+#define DENORMAL_GUARD_MXCSR 1
+#include <xmmintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////
+/// @class DenormalGuard
+/// @ingroup DSP
+/// @brief Sets flush to zero (FTZ) and denormals are zero
+///        (DAZ) in the SSE control register for the lifetime
+///        of the guard, and puts the previous mode back when
+///        it goes out of scope.
+///
+/// An IIR filter whose state decays toward zero spends its
+/// quiet periods on denormal numbers, which x86 handles in
+/// microcode at tens to hundreds of times the normal cost per
+/// operation. With FTZ and DAZ set, denormal results and
+/// operands are treated as zero instead, which changes
+/// results only below about 1.2e-38.
+///
+/// The mode belongs to the thread, so the guard must be
+/// created and destroyed on the thread doing the filtering.
+/// Writing the control register is not free; when the mode is
+/// already set the guard only reads it, so guards nest
+/// cheaply and one held around a loop of filter() calls makes
+/// the per call guards inside it nearly free. Off x86, or
+/// without SSE, the guard does nothing.
+///
+/// @code
+///   {
+///     DenormalGuard flushDenormals;
+///     lowPass.filterBlock(input, output, numSamples);
+///   }
+/// @endcode
+///////////////////////////////////////////////////////////////
+class DenormalGuard {
+
+ public:
+  ////////////////////////////////////////////////////////////
+  /// @brief Bits of the control register the guard sets:
+  ///        FTZ (bit 15) and DAZ (bit 6).
+  ////////////////////////////////////////////////////////////
+  static const unsigned int FLUSH_BITS = 0x8040;
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor saves the mode and sets FTZ and
+  ///        DAZ if they are not already set.
+  ////////////////////////////////////////////////////////////
+  inline DenormalGuard() : _saved(0) {
+#ifdef DENORMAL_GUARD_MXCSR
+    _saved = _mm_getcsr();
+    if ((_saved & FLUSH_BITS) != FLUSH_BITS){
+      _mm_setcsr(_saved | FLUSH_BITS);
+    }
+#endif
+  }
+  //////////////////////////////////////////////////////////
+  /// @brief The d'tor restores the saved mode.
+  ////////////////////////////////////////////////////////////
+  inline ~DenormalGuard() {
+#ifdef DENORMAL_GUARD_MXCSR
+    if ((_saved & FLUSH_BITS) != FLUSH_BITS){
+      _mm_setcsr(_saved);
+    }
+#endif
+  }
+  DenormalGuard(const DenormalGuard&) = delete;
+  DenormalGuard& operator=(const DenormalGuard&) = delete;
+  ////////////////////////////////////////////////////////////
+  /// @brief Reports whether this build can flush denormals.
+  /// @return true if the guard changes the mode.
+  ////////////////////////////////////////////////////////////
+  static inline bool IsSupported(void){
+#ifdef DENORMAL_GUARD_MXCSR
+    return true;
+#else
+    return false;
+#endif
+  }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief The control register as the guard found it.
+  ////////////////////////////////////////////////////////////
+  unsigned int _saved;
+};
+
+#endif  // DENORMAL_GUARD_HH
@@ -0,0 +1,188 @@
+#include "Fft.hh"
+
+#include <cmath>
+#include <stdexcept>
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor builds the tables.
+////////////////////////////////////////////////////////////
+Fft::Fft(unsigned int size) :
+         _size(size),
+         _swaps(),
+         _twiddles(),
+         _splitTwiddles(),
+         _work()
+{
+  if (size < 2 || (size & (size - 1)) != 0){
+    throw std::invalid_argument("Fft size must be a power of two of at "
+                                "least 2");
+  }
+  const unsigned int half = size/2;
+  const double pi = 3.14159265358979323846;
+  unsigned int bits = 0;
+  while ((1u << bits) < half){
+    bits++;
+  }
+  for (unsigned int i=0; i<half; i++){
+    unsigned int reversed = 0;
+    for (unsigned int b=0; b<bits; b++){
+      reversed |= ((i >> b) & 1u) << (bits - 1 - b);
+    }
+    if (i < reversed){
+      _swaps.push_back(i);
+      _swaps.push_back(reversed);
+    }
+  }
+  for (unsigned int length=8; length<=half; length<<=1){
+    for (unsigned int k=0; k<length/2; k++){
+      const double angle = -2.0*pi*k/length;
+      _twiddles.push_back(std::complex<float>(
+          static_cast<float>(std::cos(angle)),
+          static_cast<float>(std::sin(angle))));
+    }
+  }
+  for (unsigned int k=0; k<=half; k++){
+    const double angle = -2.0*pi*k/size;
+    _splitTwiddles.push_back(std::complex<float>(
+        static_cast<float>(std::cos(angle)),
+        static_cast<float>(std::sin(angle))));
+  }
+  _work.resize(half);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+Fft::~Fft() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Iterative decimation in time radix-2 transform.
+///        The first two passes, whose twiddles are 1 and -i,
+///        run together without multiplies; the later passes
+///        read their twiddles contiguously. The complex
+///        products are written out by hand; the library
+///        operator checks for infinities and is much slower.
+/// @param data    -- _size/2 points, in natural order.
+/// @param inverse -- true for the inverse direction.
+////////////////////////////////////////////////////////////
+void Fft::transform(std::complex<float>* data, bool inverse) const {
+  const unsigned int points = _size/2;
+  for (size_t s=0; s<_swaps.size(); s+=2){
+    std::swap(data[_swaps[s]], data[_swaps[s + 1]]);
+  }
+  if (points < 4){
+    if (points == 2){
+      const std::complex<float> u = data[0];
+      data[0] = u + data[1];
+      data[1] = u - data[1];
+    }
+    return;
+  }
+  const float sign = inverse ? -1.0f : 1.0f;
+  for (unsigned int start=0; start<points; start+=4){
+    const std::complex<float> a = data[start];
+    const std::complex<float> b = data[start + 1];
+    const std::complex<float> c = data[start + 2];
+    const std::complex<float> d = data[start + 3];
+    const float sr = a.real() + b.real(), si = a.imag() + b.imag();
+    const float dr = a.real() - b.real(), di = a.imag() - b.imag();
+    const float tr = c.real() + d.real(), ti = c.imag() + d.imag();
+    /// (c - d) times -i, or +i for the inverse.
+    const float ur = sign*(c.imag() - d.imag());
+    const float ui = -sign*(c.real() - d.real());
+    data[start] = std::complex<float>(sr + tr, si + ti);
+    data[start + 2] = std::complex<float>(sr - tr, si - ti);
+    data[start + 1] = std::complex<float>(dr + ur, di + ui);
+    data[start + 3] = std::complex<float>(dr - ur, di - ui);
+  }
+  /// The remaining passes work on the interleaved floats
+  /// directly, which the compiler handles much better than
+  /// std::complex values.
+  float* values = reinterpret_cast<float*>(data);
+  const float* twiddles = reinterpret_cast<const float*>(_twiddles.data());
+  for (unsigned int length=8; length<=points; length<<=1){
+    const unsigned int half = length/2;
+    for (unsigned int start=0; start<points; start+=length){
+      float* top = values + 2*start;
+      float* bottom = top + 2*half;
+      for (unsigned int k=0; k<half; k++){
+        const float wr = twiddles[2*k];
+        const float wi = sign*twiddles[2*k + 1];
+        const float xr = bottom[2*k], xi = bottom[2*k + 1];
+        const float vr = xr*wr - xi*wi;
+        const float vi = xr*wi + xi*wr;
+        const float ur = top[2*k], ui = top[2*k + 1];
+        top[2*k] = ur + vr;
+        top[2*k + 1] = ui + vi;
+        bottom[2*k] = ur - vr;
+        bottom[2*k + 1] = ui - vi;
+      }
+    }
+    twiddles += 2*half;
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Packs the even and odd samples into one complex
+///        signal, transforms it, and splits the result:
+///        X[k] = E[k] + W^k O[k], where E and O are the
+///        spectra of the even and odd samples.
+/// @param input    -- GetSize() real samples.
+/// @param spectrum -- Receives GetNumBins() bins.
+////////////////////////////////////////////////////////////
+void Fft::forward(const float* input, std::complex<float>* spectrum){
+  const unsigned int half = _size/2;
+  for (unsigned int k=0; k<half; k++){
+    _work[k] = std::complex<float>(input[2*k], input[2*k + 1]);
+  }
+  transform(&_work[0], false);
+  spectrum[0] = std::complex<float>(_work[0].real() + _work[0].imag(), 0.0f);
+  spectrum[half] = std::complex<float>(_work[0].real() - _work[0].imag(),
+                                       0.0f);
+  for (unsigned int k=1; k<half; k++){
+    const std::complex<float> z = _work[k];
+    const std::complex<float> mirror = std::conj(_work[half - k]);
+    const float er = 0.5f*(z.real() + mirror.real());
+    const float ei = 0.5f*(z.imag() + mirror.imag());
+    /// O = (z - mirror)/2i
+    const float orr = 0.5f*(z.imag() - mirror.imag());
+    const float oi = -0.5f*(z.real() - mirror.real());
+    const float wr = _splitTwiddles[k].real();
+    const float wi = _splitTwiddles[k].imag();
+    spectrum[k] = std::complex<float>(er + orr*wr - oi*wi,
+                                      ei + orr*wi + oi*wr);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Rebuilds the packed even/odd spectrum from the
+///        real spectrum, inverts it, and unpacks the samples.
+///        The even and odd spectra are formed at twice their
+///        size so the result is scaled by GetSize().
+/// @param spectrum -- GetNumBins() bins.
+/// @param output   -- Receives GetSize() real samples.
+////////////////////////////////////////////////////////////
+void Fft::inverse(const std::complex<float>* spectrum, float* output){
+  const unsigned int half = _size/2;
+  for (unsigned int k=0; k<half; k++){
+    const std::complex<float> x = spectrum[k];
+    const std::complex<float> mirror = std::conj(spectrum[half - k]);
+    const float er = x.real() + mirror.real();
+    const float ei = x.imag() + mirror.imag();
+    const float dr = x.real() - mirror.real();
+    const float di = x.imag() - mirror.imag();
+    /// O = (x - mirror)*conj(W^k); Z = E + iO
+    const float wr = _splitTwiddles[k].real();
+    const float wi = -_splitTwiddles[k].imag();
+    const float orr = dr*wr - di*wi;
+    const float oi = dr*wi + di*wr;
+    _work[k] = std::complex<float>(er - oi, ei + orr);
+  }
+  transform(&_work[0], true);
+  for (unsigned int k=0; k<half; k++){
+    output[2*k] = _work[k].real();
+    output[2*k + 1] = _work[k].imag();
+  }
+}
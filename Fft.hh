@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class computes the discrete Fourier transform
+///          of real signals with a radix-2 FFT.
+///
+///////////////////////////////////////////////////////////////
+#ifndef FFT_HH
+#define FFT_HH
+
+#include <complex>
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @class Fft
+/// @ingroup DSP
+/// @brief Forward and inverse DFT of a real signal whose
+///        length is a power of two. The real transform is
+///        computed as a complex transform of half the length
+///        (even samples as the real part, odd samples as the
+///        imaginary part) followed by a split step, with an
+///        iterative radix-2 transform and twiddle factors
+///        computed once, in double precision, by the c'tor.
+///
+/// Neither direction is scaled, so inverse(forward(x)) is
+/// GetSize() times x:
+///
+/// @code
+///   Fft fft(256);
+///   std::vector<std::complex<float> > spectrum(fft.GetNumBins());
+///   fft.forward(&signal[0], &spectrum[0]);
+///   fft.inverse(&spectrum[0], &signal[0]);  // 256*signal
+/// @endcode
+///////////////////////////////////////////////////////////////
+class Fft {
+
+ public:
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor computes the twiddle factors
+  ///        and bit reversal table.
+  /// @param size -- Length of the real signal, a power of two
+  ///                of at least 2.
+  /// @throws std::invalid_argument if size is not a power of
+  ///         two of at least 2.
+  ////////////////////////////////////////////////////////////
+  explicit Fft(unsigned int size);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the Fft.
+  ////////////////////////////////////////////////////////////
+  ~Fft();
+  ////////////////////////////////////////////////////////////
+  /// @brief Forward transform.
+  /// @param input    -- GetSize() real samples.
+  /// @param spectrum -- Receives bins 0 to GetSize()/2; the
+  ///                    rest follow by conjugate symmetry.
+  ////////////////////////////////////////////////////////////
+  void forward(const float* input, std::complex<float>* spectrum);
+  ////////////////////////////////////////////////////////////
+  /// @brief Inverse transform, unscaled.
+  /// @param spectrum -- Bins 0 to GetSize()/2 of a real
+  ///                    signal's spectrum.
+  /// @param output   -- Receives GetSize() real samples.
+  ////////////////////////////////////////////////////////////
+  void inverse(const std::complex<float>* spectrum, float* output);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the transform size.
+  /// @return Length of the real signal.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetSize(void) const { return _size; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the bin count.
+  /// @return GetSize()/2 + 1.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetNumBins(void) const { return _size/2 + 1; }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief In place complex transform of _size/2 points.
+  /// @param data    -- The points, in natural order.
+  /// @param inverse -- true for the inverse direction.
+  ////////////////////////////////////////////////////////////
+  void transform(std::complex<float>* data, bool inverse) const;
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the real signal.
+  ////////////////////////////////////////////////////////////
+  unsigned int _size;
+  ////////////////////////////////////////////////////////////
+  /// @brief Pairs of indices swapped by the bit reversal of
+  ///        the complex transform.
+  ////////////////////////////////////////////////////////////
+  std::vector<unsigned int> _swaps;
+  ////////////////////////////////////////////////////////////
+  /// @brief Twiddles of each pass after the second: for pass
+  ///        length L = 8, 16, ... up to _size/2, in turn,
+  ///        exp(-2 pi i k/L) for k < L/2.
+  ////////////////////////////////////////////////////////////
+  std::vector<std::complex<float> > _twiddles;
+  ////////////////////////////////////////////////////////////
+  /// @brief exp(-2 pi i k/_size) for k <= _size/2, used by
+  ///        the split step.
+  ////////////////////////////////////////////////////////////
+  std::vector<std::complex<float> > _splitTwiddles;
+  ////////////////////////////////////////////////////////////
+  /// @brief Work space for the half length transform.
+  ////////////////////////////////////////////////////////////
+  std::vector<std::complex<float> > _work;
+};
+
+#endif  // FFT_HH
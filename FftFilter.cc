@@ -0,0 +1,332 @@
+#include "FftFilter.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+////////////////////////////////////////////////////////////
+/// @brief Outputs filterBlock computes together in the head.
+///        A fixed count lets the compiler keep them in one
+///        vector register.
+////////////////////////////////////////////////////////////
+static const unsigned int HEAD_LANES = 8;
+
+////////////////////////////////////////////////////////////
+/// @brief Checks the partition size before the transform is
+///        built from it.
+/// @param partitionSize -- Samples per partition.
+/// @return The transform size, 2*partitionSize.
+////////////////////////////////////////////////////////////
+static unsigned int transformSize(unsigned int partitionSize){
+  if (partitionSize == 0 || (partitionSize & (partitionSize - 1)) != 0 ||
+      partitionSize > (1u << 30)){
+    throw std::invalid_argument("FftFilter partition size must be a power "
+                                "of two");
+  }
+  return 2*partitionSize;
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members.
+////////////////////////////////////////////////////////////
+FftFilter::FftFilter(const std::vector<float>& taps,
+                     unsigned int partitionSize) :
+         Filter(),
+         _numTaps(0),
+         _partitionSize(partitionSize),
+         _numTailPartitions(0),
+         _fft(transformSize(partitionSize)),
+         _headTaps(),
+         _tailSpectra(),
+         _inputSpectra(),
+         _newestSpectrum(0),
+         _frame(),
+         _fill(0),
+         _tailOutput(),
+         _sum(),
+         _inverse(),
+         _blockHead()
+{
+  const float leading = 1.0f;
+  SetWeights(static_cast<unsigned int>(taps.size()), taps.data(),
+             1, &leading);
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members.
+////////////////////////////////////////////////////////////
+FftFilter::FftFilter(unsigned int numInWeights, const float* inWeights,
+                     unsigned int numOutWeights, const float* outWeights,
+                     unsigned int partitionSize) :
+         Filter(),
+         _numTaps(0),
+         _partitionSize(partitionSize),
+         _numTailPartitions(0),
+         _fft(transformSize(partitionSize)),
+         _headTaps(),
+         _tailSpectra(),
+         _inputSpectra(),
+         _newestSpectrum(0),
+         _frame(),
+         _fill(0),
+         _tailOutput(),
+         _sum(),
+         _inverse(),
+         _blockHead()
+{
+  SetWeights(numInWeights, inWeights, numOutWeights, outWeights);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+FftFilter::~FftFilter() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Checks for an FIR weight set, stores it in the
+///        base class, then rebuilds the partitions and their
+///        state from the carried over history.
+/// @param numInWeights  -- Number of input weights (b).
+/// @param inWeights     -- The input weights.
+/// @param numOutWeights -- Number of output weights (a).
+/// @param outWeights    -- The output weights.
+////////////////////////////////////////////////////////////
+void FftFilter::SetWeights(unsigned int numInWeights, const float* inWeights,
+                           unsigned int numOutWeights,
+                           const float* outWeights){
+  if (numOutWeights != 1){
+    throw std::invalid_argument("FftFilter needs exactly one output weight");
+  }
+  Filter::SetWeights(numInWeights, inWeights, numOutWeights, outWeights);
+  setTaps();
+  replayHistory();
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Splits the base class weights, already divided by
+///        a[0] and checked, into the head and the transformed
+///        tail partitions.
+////////////////////////////////////////////////////////////
+void FftFilter::setTaps(void){
+  const float* taps = _inputWeights;
+  const unsigned int size = _partitionSize;
+  const unsigned int numBins = size + 1;
+  _numTaps = _numInWeights;
+  _numTailPartitions = (_numTaps - 1)/size;
+
+  _headTaps.assign(taps, taps + std::min(size, _numTaps));
+  _tailSpectra.assign(_numTailPartitions*numBins, std::complex<float>());
+  std::vector<float> block(2*size);
+  const float scale = 1.0f/(2*size);
+  for (unsigned int p=0; p<_numTailPartitions; p++){
+    block.assign(2*size, 0.0f);
+    for (unsigned int k=0; k<size; k++){
+      const unsigned int tap = (p + 1)*size + k;
+      if (tap < _numTaps){
+        block[k] = scale*taps[tap];
+      }
+    }
+    _fft.forward(&block[0], &_tailSpectra[p*numBins]);
+  }
+  _inputSpectra.assign(_numTailPartitions*numBins, std::complex<float>());
+  _frame.assign(2*size, 0.0f);
+  _tailOutput.assign(size, 0.0f);
+  _sum.assign(numBins, std::complex<float>());
+  _inverse.assign(2*size, 0.0f);
+  _blockHead.assign(size, 0.0f);
+  _newestSpectrum = 0;
+  _fill = 0;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Zeroes the input spectra and pending outputs.
+////////////////////////////////////////////////////////////
+void FftFilter::clearPartitions(void){
+  _inputSpectra.assign(_inputSpectra.size(), std::complex<float>());
+  _frame.assign(_frame.size(), 0.0f);
+  _tailOutput.assign(_tailOutput.size(), 0.0f);
+  _newestSpectrum = 0;
+  _fill = 0;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Zeroes the partitions and the delay lines.
+////////////////////////////////////////////////////////////
+void FftFilter::reset(void){
+  clearPartitions();
+  initBuffer(_inputBuffer, 2*_numInWeights);
+  initBuffer(_outputBuffer, 2*_numOutWeights);
+  _inputHead = 0;
+  _outputHead = 0;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The filter is linear and its state starts at zero,
+///        so the replay can skip the zero inputs older than
+///        the oldest nonzero one. Replaying writes the same
+///        inputs back into the delay line; the restored output
+///        is put back afterwards.
+////////////////////////////////////////////////////////////
+void FftFilter::replayHistory(void){
+  std::vector<float> history(_numInWeights);
+  GetInputBufferSnapshot(history.data());
+  const float lastOutput = _outputBuffer[_outputHead];
+  clearPartitions();
+  unsigned int oldest = _numInWeights;
+  while (oldest > 0 && history[oldest - 1] == 0.0f){
+    oldest--;
+  }
+  for (unsigned int i=oldest; i>0; i--){
+    step(history[i - 1]);
+  }
+  _outputBuffer[_outputHead] = lastOutput;
+  _outputBuffer[_outputHead + _numOutWeights] = lastOutput;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Rebuilds the partitions from the new history.
+////////////////////////////////////////////////////////////
+void FftFilter::delayLinesChanged(void){
+  replayHistory();
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Same delay line update as Filter::filter, for a
+///        single output weight.
+/// @param inputValue  -- The input.
+/// @param outputValue -- Its output.
+////////////////////////////////////////////////////////////
+inline void FftFilter::recordSample(float inputValue, float outputValue){
+  _inputHead = (_inputHead == 0 ? _numInWeights : _inputHead) - 1;
+  _inputBuffer[_inputHead] = inputValue;
+  _inputBuffer[_inputHead + _numInWeights] = inputValue;
+  _outputBuffer[_outputHead] = outputValue;
+  _outputBuffer[_outputHead + 1] = outputValue;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Direct form head plus the precomputed tail.
+/// @param inputValue input value.
+/// @return Output from the filter
+////////////////////////////////////////////////////////////
+inline float FftFilter::step(float inputValue){
+  const unsigned int size = _partitionSize;
+  _frame[size + _fill] = inputValue;
+  const float* newest = &_frame[size + _fill];
+  float head = 0.0f;
+  for (size_t k=0; k<_headTaps.size(); k++){
+    head += _headTaps[k]*newest[-static_cast<ptrdiff_t>(k)];
+  }
+  const float outputValue = head + _tailOutput[_fill];
+  recordSample(inputValue, outputValue);
+  if (++_fill == size){
+    advanceBlock();
+  }
+  return outputValue;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Overlap-save step for the tail partitions. Tail
+///        partition p (1 based) applied to the frame ending
+///        p blocks before the next one gives its share of the
+///        next block's outputs.
+////////////////////////////////////////////////////////////
+void FftFilter::advanceBlock(void){
+  const unsigned int size = _partitionSize;
+  if (_numTailPartitions > 0){
+    const unsigned int numBins = size + 1;
+    _newestSpectrum = (_newestSpectrum + 1) % _numTailPartitions;
+    _fft.forward(&_frame[0], &_inputSpectra[_newestSpectrum*numBins]);
+    _sum.assign(numBins, std::complex<float>());
+    unsigned int slot = _newestSpectrum;
+    for (unsigned int p=0; p<_numTailPartitions; p++){
+      const std::complex<float>* h = &_tailSpectra[p*numBins];
+      const std::complex<float>* x = &_inputSpectra[slot*numBins];
+      for (unsigned int k=0; k<numBins; k++){
+        _sum[k] = std::complex<float>(
+            _sum[k].real() + h[k].real()*x[k].real() - h[k].imag()*x[k].imag(),
+            _sum[k].imag() + h[k].real()*x[k].imag() + h[k].imag()*x[k].real());
+      }
+      slot = (slot == 0 ? _numTailPartitions : slot) - 1;
+    }
+    _fft.inverse(&_sum[0], &_inverse[0]);
+    for (unsigned int k=0; k<size; k++){
+      _tailOutput[k] = _inverse[size + k];
+    }
+  }
+  for (unsigned int k=0; k<size; k++){
+    _frame[k] = _frame[size + k];
+  }
+  _fill = 0;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filters one sample.
+/// @param inputValue input value.
+/// @return Output from the filter
+////////////////////////////////////////////////////////////
+float FftFilter::filter(float inputValue){
+  return step(inputValue);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filters whole partitions at once where the block
+///        lines up with them, and single samples otherwise.
+///        For a whole partition the head runs tap by tap over
+///        all its outputs, which vectorizes; each output still
+///        sums its products in the same order as step(), so
+///        the results are identical.
+/// @param input      -- Input samples, oldest first.
+/// @param output     -- Destination for the filter outputs.
+/// @param numSamples -- Number of samples in the block.
+////////////////////////////////////////////////////////////
+void FftFilter::filterBlock(const float* input, float* output,
+                            unsigned int numSamples){
+  const unsigned int size = _partitionSize;
+  unsigned int n = 0;
+  while (n < numSamples){
+    if (_fill != 0 || numSamples - n < size){
+      output[n] = step(input[n]);
+      n++;
+      continue;
+    }
+    for (unsigned int i=0; i<size; i++){
+      _frame[size + i] = input[n + i];
+    }
+    float* head = &_blockHead[0];
+    if (size % HEAD_LANES == 0){
+      for (unsigned int i=0; i<size; i+=HEAD_LANES){
+        float lanes[HEAD_LANES] = {};
+        for (size_t k=0; k<_headTaps.size(); k++){
+          const float tap = _headTaps[k];
+          const float* x = &_frame[size - k + i];
+          for (unsigned int l=0; l<HEAD_LANES; l++){
+            lanes[l] += tap*x[l];
+          }
+        }
+        for (unsigned int l=0; l<HEAD_LANES; l++){
+          head[i + l] = lanes[l];
+        }
+      }
+    } else {
+      for (unsigned int i=0; i<size; i++){
+        head[i] = 0.0f;
+      }
+      for (size_t k=0; k<_headTaps.size(); k++){
+        const float tap = _headTaps[k];
+        const float* x = &_frame[size - k];
+        for (unsigned int i=0; i<size; i++){
+          head[i] += tap*x[i];
+        }
+      }
+    }
+    for (unsigned int i=0; i<size; i++){
+      output[n + i] = head[i] + _tailOutput[i];
+      recordSample(_frame[size + i], output[n + i]);
+    }
+    advanceBlock();
+    n += size;
+  }
+}
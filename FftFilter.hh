@@ -0,0 +1,234 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class defines a long FIR filter evaluated by
+///          partitioned FFT convolution.
+///
+///////////////////////////////////////////////////////////////
+#ifndef FFT_FILTER_HH
+#define FFT_FILTER_HH
+
+#include "Fft.hh"
+#include "Filter.hh"
+
+#include <complex>
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @class FftFilter
+/// @ingroup DSP
+/// @brief FIR filter (a single output weight) for hundreds to
+///        thousands of taps. It is a Filter, with the same
+///        per sample timing and no added latency, so it can
+///        replace a direct form Filter built from the same
+///        weights; outputs agree to within FFT rounding.
+///
+/// The taps are cut into partitions of P samples. The first
+/// partition is evaluated in direct form, sample by sample.
+/// The rest only involve inputs at least P samples old, so
+/// their contribution to the next P outputs is computed once
+/// per P inputs by uniformly partitioned overlap-save
+/// convolution: each input block is transformed once (2P
+/// point FFT) into a frequency domain delay line, multiplied
+/// with the precomputed spectrum of every partition, and the
+/// products are summed and inverted once. Per sample this
+/// costs P multiply-adds plus O(numTaps/P + log P), against
+/// numTaps for direct form. filterBlock() evaluates the head
+/// a whole partition at a time when the block allows it, which
+/// is much faster than filter() per sample.
+///
+/// The base Filter holds the taps as its weights and keeps its
+/// delay lines up to date, so the weight accessors,
+/// FilterAnalysis and SaveState describe the filter as it
+/// runs. SetWeights takes new FIR weights, and RestoreState or
+/// SetSteadyState rebuild the partition state from the restored
+/// inputs.
+///
+/// @code
+///   FftFilter equalizer(taps);  // e.g. 1024 taps
+///   equalizer.filterBlock(input, output, numSamples);
+/// @endcode
+///////////////////////////////////////////////////////////////
+class FftFilter : public Filter {
+
+ public:
+  ////////////////////////////////////////////////////////////
+  /// @brief Default partition size. Larger partitions do
+  ///        less FFT work per sample but more direct form work.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int DEFAULT_PARTITION_SIZE = 64;
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor builds the filter from its taps
+  ///        with zeroed state.
+  /// @param taps          -- The FIR weights (b).
+  /// @param partitionSize -- Partition size, a power of two.
+  /// @throws std::invalid_argument if there are no taps, a
+  ///         tap is not finite, or the partition size is not
+  ///         a power of two.
+  ////////////////////////////////////////////////////////////
+  explicit FftFilter(const std::vector<float>& taps,
+                     unsigned int partitionSize = DEFAULT_PARTITION_SIZE);
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor takes the same weights as a
+  ///        Filter. The taps are divided by a[0].
+  /// @param numInWeights  -- Number of input weights (b).
+  /// @param inWeights     -- The input weights.
+  /// @param numOutWeights -- Number of output weights (a);
+  ///                         must be 1.
+  /// @param outWeights    -- The output weights.
+  /// @param partitionSize -- Partition size, a power of two.
+  /// @throws std::invalid_argument if numOutWeights is not 1,
+  ///         or the weights are rejected as by SetWeights.
+  ////////////////////////////////////////////////////////////
+  FftFilter(unsigned int numInWeights, const float* inWeights,
+            unsigned int numOutWeights, const float* outWeights,
+            unsigned int partitionSize = DEFAULT_PARTITION_SIZE);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the FftFilter.
+  ////////////////////////////////////////////////////////////
+  virtual ~FftFilter();
+  ////////////////////////////////////////////////////////////
+  /// @brief Main filter routine.
+  /// @param inputValue input value.
+  /// @return Output from the filter
+  ////////////////////////////////////////////////////////////
+  virtual float filter(float inputValue);
+  ////////////////////////////////////////////////////////////
+  /// @brief Block filter routine. Outputs are bit-identical
+  ///        to calling filter() once per sample.
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for the filter outputs.
+  ///                      May alias input.
+  /// @param numSamples -- Number of samples in the block.
+  ////////////////////////////////////////////////////////////
+  virtual void filterBlock(const float* input, float* output,
+                           unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief Replaces the taps. They are divided by a[0] and
+  ///        checked as by Filter::SetWeights, and the input
+  ///        history carries over as it does there.
+  /// @param numInWeights  -- Number of input weights (b).
+  /// @param inWeights     -- The input weights.
+  /// @param numOutWeights -- Number of output weights (a);
+  ///                         must be 1.
+  /// @param outWeights    -- The output weights.
+  /// @throws std::invalid_argument if numOutWeights is not 1,
+  ///         or as Filter::SetWeights.
+  ////////////////////////////////////////////////////////////
+  virtual void SetWeights(unsigned int numInWeights, const float* inWeights,
+                          unsigned int numOutWeights,
+                          const float* outWeights);
+  ////////////////////////////////////////////////////////////
+  /// @brief Zeroes the filter state.
+  ////////////////////////////////////////////////////////////
+  void reset(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the tap count.
+  /// @return Number of FIR weights.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetNumTaps(void) const { return _numTaps; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the partition size.
+  /// @return Samples per partition.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetPartitionSize(void) const {
+                                  return _partitionSize; }
+
+ protected:
+  ////////////////////////////////////////////////////////////
+  /// @brief Rebuilds the partition state from a restored
+  ///        input delay line.
+  ////////////////////////////////////////////////////////////
+  virtual void delayLinesChanged(void);
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Precomputes the direct form head and the
+  ///        partition spectra from the base class weights.
+  ////////////////////////////////////////////////////////////
+  void setTaps(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Zeroes the partition state, leaving the base
+  ///        class delay lines alone.
+  ////////////////////////////////////////////////////////////
+  void clearPartitions(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Runs the input delay line back through the
+  ///        partitions, oldest first, so they hold the state
+  ///        that history implies.
+  ////////////////////////////////////////////////////////////
+  void replayHistory(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Shifts an input and its output into the base class
+  ///        delay lines.
+  ////////////////////////////////////////////////////////////
+  inline void recordSample(float inputValue, float outputValue);
+  ////////////////////////////////////////////////////////////
+  /// @brief Filters one sample.
+  ////////////////////////////////////////////////////////////
+  inline float step(float inputValue);
+  ////////////////////////////////////////////////////////////
+  /// @brief Runs once per completed input block: transforms
+  ///        the block into the delay line and computes the
+  ///        tail of the next block's outputs.
+  ////////////////////////////////////////////////////////////
+  void advanceBlock(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of FIR weights.
+  ////////////////////////////////////////////////////////////
+  unsigned int _numTaps;
+  ////////////////////////////////////////////////////////////
+  /// @brief Samples per partition.
+  ////////////////////////////////////////////////////////////
+  unsigned int _partitionSize;
+  ////////////////////////////////////////////////////////////
+  /// @brief Partitions after the first.
+  ////////////////////////////////////////////////////////////
+  unsigned int _numTailPartitions;
+  ////////////////////////////////////////////////////////////
+  /// @brief 2*_partitionSize point transform.
+  ////////////////////////////////////////////////////////////
+  Fft _fft;
+  ////////////////////////////////////////////////////////////
+  /// @brief First partition of taps, evaluated in direct form.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> _headTaps;
+  ////////////////////////////////////////////////////////////
+  /// @brief Spectrum of each tail partition, scaled by the
+  ///        inverse transform's 1/(2*_partitionSize).
+  ////////////////////////////////////////////////////////////
+  std::vector<std::complex<float> > _tailSpectra;
+  ////////////////////////////////////////////////////////////
+  /// @brief Frequency domain delay line: spectra of the last
+  ///        _numTailPartitions input frames, as a ring.
+  ////////////////////////////////////////////////////////////
+  std::vector<std::complex<float> > _inputSpectra;
+  ////////////////////////////////////////////////////////////
+  /// @brief Ring slot of the newest input spectrum.
+  ////////////////////////////////////////////////////////////
+  unsigned int _newestSpectrum;
+  ////////////////////////////////////////////////////////////
+  /// @brief The previous input block followed by the current
+  ///        one, filled up to _fill.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> _frame;
+  ////////////////////////////////////////////////////////////
+  /// @brief Samples of the current block received so far.
+  ////////////////////////////////////////////////////////////
+  unsigned int _fill;
+  ////////////////////////////////////////////////////////////
+  /// @brief Tail partitions' contribution to each output of
+  ///        the current block.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> _tailOutput;
+  ////////////////////////////////////////////////////////////
+  /// @brief Work space for advanceBlock.
+  ////////////////////////////////////////////////////////////
+  std::vector<std::complex<float> > _sum;
+  std::vector<float> _inverse;
+  ////////////////////////////////////////////////////////////
+  /// @brief Direct form head outputs of one partition, for
+  ///        filterBlock.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> _blockHead;
+};
+
+#endif  // FFT_FILTER_HH
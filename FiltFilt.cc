@@ -0,0 +1,173 @@
+#include "FiltFilt.hh"
+#include "CaptureReader.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////
+/// @brief Frames filtered per block.
+////////////////////////////////////////////////////////////
+static const unsigned int BLOCK_FRAMES = 4096;
+
+////////////////////////////////////////////////////////////
+/// @brief Both passes, channel by channel within each block.
+///        The samples the end extensions reflect are copied
+///        out first, since output may overwrite them; the
+///        forward outputs over the back extension are kept to
+///        start the backward pass.
+////////////////////////////////////////////////////////////
+void filtfilt(const Filter& filter, const float* input, float* output,
+              size_t numFrames, unsigned int numChannels,
+              unsigned int padLength){
+  if (!filter.IsDifferenceEquation()){
+    throw std::invalid_argument("filtfilt needs a filter that is its "
+                                "difference equation");
+  }
+  if (numChannels == 0){
+    throw std::invalid_argument("filtfilt needs at least one channel");
+  }
+  if (padLength == FILTFILT_DEFAULT_PAD){
+    padLength = 3*std::max(filter.GetNumInWeights(),
+                           filter.GetNumOutWeights());
+  }
+  if (numFrames <= padLength){
+    throw std::invalid_argument("filtfilt needs more samples than the pad "
+                                "length");
+  }
+  const size_t channels = numChannels;
+  const size_t pad = padLength;
+  std::vector<float> front((pad + 1)*channels), back((pad + 1)*channels);
+  for (size_t i=0; i<=pad; i++){
+    for (size_t c=0; c<channels; c++){
+      front[i*channels + c] = input[i*channels + c];
+      back[i*channels + c] = input[(numFrames - 1 - i)*channels + c];
+    }
+  }
+  std::vector<Filter> filters(channels, filter);
+  std::vector<float> scratch(std::max<size_t>(BLOCK_FRAMES, pad));
+  std::vector<float> tail(pad*channels);
+
+  /// Forward: front extension, signal, back extension.
+  for (size_t c=0; c<channels; c++){
+    const float first = front[c];
+    filters[c].SetSteadyState(pad ? 2.0f*first - front[pad*channels + c] :
+                                   first);
+    for (size_t k=pad; k>0; k--){
+      scratch[pad - k] = 2.0f*first - front[k*channels + c];
+    }
+    filters[c].filterBlock(&scratch[0], &scratch[0],
+                           static_cast<unsigned int>(pad));
+  }
+  for (size_t begin=0; begin<numFrames; begin+=BLOCK_FRAMES){
+    const size_t count = std::min<size_t>(BLOCK_FRAMES, numFrames - begin);
+    for (size_t c=0; c<channels; c++){
+      for (size_t i=0; i<count; i++){
+        scratch[i] = input[(begin + i)*channels + c];
+      }
+      filters[c].filterBlock(&scratch[0], &scratch[0],
+                             static_cast<unsigned int>(count));
+      for (size_t i=0; i<count; i++){
+        output[(begin + i)*channels + c] = scratch[i];
+      }
+    }
+  }
+  for (size_t c=0; c<channels; c++){
+    const float last = back[c];
+    for (size_t k=1; k<=pad; k++){
+      scratch[k - 1] = 2.0f*last - back[k*channels + c];
+    }
+    filters[c].filterBlock(&scratch[0], &scratch[0],
+                           static_cast<unsigned int>(pad));
+    for (size_t k=0; k<pad; k++){
+      tail[k*channels + c] = scratch[k];
+    }
+  }
+
+  /// Backward: back extension, then the signal in place. The
+  /// front extension's outputs would be discarded, so it is
+  /// not run.
+  for (size_t c=0; c<channels; c++){
+    filters[c].SetSteadyState(pad ? tail[(pad - 1)*channels + c] :
+                                   output[(numFrames - 1)*channels + c]);
+    for (size_t k=0; k<pad; k++){
+      scratch[k] = tail[(pad - 1 - k)*channels + c];
+    }
+    filters[c].filterBlock(&scratch[0], &scratch[0],
+                           static_cast<unsigned int>(pad));
+  }
+  for (size_t end=numFrames; end>0; ){
+    const size_t count = std::min<size_t>(BLOCK_FRAMES, end);
+    for (size_t c=0; c<channels; c++){
+      for (size_t i=0; i<count; i++){
+        scratch[i] = output[(end - 1 - i)*channels + c];
+      }
+      filters[c].filterBlock(&scratch[0], &scratch[0],
+                             static_cast<unsigned int>(count));
+      for (size_t i=0; i<count; i++){
+        output[(end - 1 - i)*channels + c] = scratch[i];
+      }
+    }
+    end -= count;
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Writes the output header, grows the file to size,
+///        maps it, and filters from the input mapping straight
+///        into the output mapping.
+////////////////////////////////////////////////////////////
+void filtfiltCapture(const Filter& filter, const std::string& inputPath,
+                     const std::string& outputPath, unsigned int padLength){
+  if (inputPath == outputPath){
+    throw std::invalid_argument("filtfiltCapture cannot write over its "
+                                "input");
+  }
+  CaptureReader capture(inputPath);
+  const float* frames = capture.GetBinaryFrames();
+  if (frames == NULL){
+    throw std::invalid_argument("filtfiltCapture needs a packed binary "
+                                "capture");
+  }
+  const size_t numFrames = capture.GetNumBinaryFrames();
+  const unsigned int numColumns =
+      static_cast<unsigned int>(capture.GetColumnNames().size());
+
+  std::FILE* file = std::fopen(outputPath.c_str(), "w+b");
+  if (file == NULL){
+    throw std::runtime_error("filtfiltCapture cannot create " + outputPath +
+                             ": " + std::strerror(errno));
+  }
+  if (!CaptureReader::writeBinaryHeader(file, capture.GetColumnNames()) ||
+      std::fflush(file) != 0){
+    std::fclose(file);
+    throw std::runtime_error("filtfiltCapture cannot write " + outputPath);
+  }
+  const size_t offset = static_cast<size_t>(std::ftell(file));
+  const size_t size = offset + numFrames*numColumns*sizeof(float);
+  void* mapping = MAP_FAILED;
+  if (::ftruncate(fileno(file), static_cast<off_t>(size)) == 0){
+    mapping = ::mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     fileno(file), 0);
+  }
+  const int mapError = errno;
+  std::fclose(file);
+  if (mapping == MAP_FAILED){
+    throw std::runtime_error("filtfiltCapture cannot map " + outputPath +
+                             ": " + std::strerror(mapError));
+  }
+  try {
+    filtfilt(filter, frames,
+             reinterpret_cast<float*>(static_cast<char*>(mapping) + offset),
+             numFrames, numColumns, padLength);
+  } catch (...) {
+    ::munmap(mapping, size);
+    throw;
+  }
+  ::munmap(mapping, size);
+}
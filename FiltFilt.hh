@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This file runs filters forward and backward over
+///          whole recordings for zero phase filtering, the
+///          counterpart of scipy.signal.filtfilt.
+///
+///////////////////////////////////////////////////////////////
+#ifndef FILT_FILT_HH
+#define FILT_FILT_HH
+
+#include "Filter.hh"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+////////////////////////////////////////////////////////////
+/// @brief Pad length that asks for scipy's default, three
+///        times the larger weight count.
+////////////////////////////////////////////////////////////
+static const unsigned int FILTFILT_DEFAULT_PAD = ~0u;
+
+////////////////////////////////////////////////////////////
+/// @brief Zero phase filtering: the signal is filtered
+///        forward, then the result is filtered backward, so
+///        the phase shifts cancel and the magnitude response
+///        is squared. Matches scipy.signal.filtfilt with its
+///        defaults (padtype 'odd'): each end is extended by
+///        padLength samples reflected through the end sample,
+///        and each pass starts in the steady state for its
+///        first sample (what scipy gets from lfilter_zi), so
+///        neither end shows a start up transient.
+///
+/// The passes run in blocks through one scratch buffer;
+/// nothing the size of the signal is allocated or reversed,
+/// so the signal can be a memory mapping larger than RAM. The
+/// forward pass streams front to back and the backward pass
+/// back to front.
+///
+/// @param filter      -- Filter whose weights are applied. Its
+///                       IsDifferenceEquation() must be true.
+///                       Its state is not used or changed.
+/// @param input       -- numFrames frames of numChannels
+///                       interleaved samples.
+/// @param output      -- Destination, laid out like input.
+///                       May alias input.
+/// @param numFrames   -- Number of frames.
+/// @param numChannels -- Samples per frame. Every channel is
+///                       filtered on its own.
+/// @param padLength   -- Samples of extension at each end;
+///                       FILTFILT_DEFAULT_PAD for 3 times the
+///                       larger weight count.
+/// @throws std::invalid_argument if filter is not its
+///         difference equation, numChannels is zero,
+///         numFrames is not more than padLength, or the output
+///         weights sum to zero (a pole at z = 1 has no steady
+///         state).
+////////////////////////////////////////////////////////////
+void filtfilt(const Filter& filter, const float* input, float* output,
+              size_t numFrames, unsigned int numChannels = 1,
+              unsigned int padLength = FILTFILT_DEFAULT_PAD);
+
+////////////////////////////////////////////////////////////
+/// @brief Zero phase filters every column of a packed binary
+///        capture (see CaptureReader) into a new capture with
+///        the same columns. Both files are memory mapped, so
+///        captures of any size stream through in two passes.
+/// @param filter     -- As for filtfilt.
+/// @param inputPath  -- The packed binary capture.
+/// @param outputPath -- The capture to write; must not be the
+///                      input.
+/// @param padLength  -- As for filtfilt.
+/// @throws std::invalid_argument if the input is a CSV capture
+///         or filtfilt rejects it.
+/// @throws std::runtime_error if a file cannot be read,
+///         written or mapped.
+////////////////////////////////////////////////////////////
+void filtfiltCapture(const Filter& filter, const std::string& inputPath,
+                     const std::string& outputPath,
+                     unsigned int padLength = FILTFILT_DEFAULT_PAD);
+
+#endif  // FILT_FILT_HH
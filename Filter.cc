@@ -1,50 +1,229 @@
 #include "Filter.hh"
+#include "FilterArena.hh"
+#include "SampleTraits.hh"
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <typeinfo>
+
+////////////////////////////////////////////////////////////
+/// @brief Moves a circular buffer head back one slot, which
+///        is where the next newest value gets written.
+/// @param head -- Current head index.
+/// @param size -- Length of the delay line.
+/// @return The new head index.
+////////////////////////////////////////////////////////////
+static inline unsigned int retreatHead(unsigned int head,
+                                       unsigned int size){
+  return (head == 0 ? size : head) - (size == 0 ? 0 : 1);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Converts a weight count passed as a float, mapping
+///        negative and non-finite counts to an invalid count
+///        of zero.
+////////////////////////////////////////////////////////////
+static inline unsigned int weightCount(float count){
+  return (count >= 0.0f && count < static_cast<float>(UINT_MAX)) ?
+         static_cast<unsigned int>(count) : 0;
+}
 
 //////////////////////////////////////////////////////////
 /// @brief The c'tor constructs the class members.
 ////////////////////////////////////////////////////////////
 Filter::Filter(float numInWeights, float* inWeights,
 		       float numOutWeights, float* outWeights) :
-         _numInWeights(numInWeights),
-         _numOutWeights(numOutWeights)
+         _inputBuffer(NULL),
+         _inputHead(0),
+         _outputBuffer(NULL),
+         _outputHead(0),
+         _numInWeights(0),
+         _inputWeights(NULL),
+         _numOutWeights(0),
+         _outputWeights(NULL),
+         _storage(NULL),
+         _inputCapacity(0),
+         _outputCapacity(0),
+         _arena(NULL)
 {
-	/// First initialize all weights to 0.0
-	for (unsigned int i = 0; i<MAX_FILTER_SIZE; i++){
-		_inputWeights[i] = 0.0;
-		_outputWeights[i] = 0.0;
-	}
-	/// Apply the passed in weights.
-	for (unsigned int i = 0; i<numInWeights; i++){
-		_inputWeights[i] = inWeights[i];
-	}
-	for (unsigned int i = 0; i<numOutWeights; i++){
-		_outputWeights[i] = outWeights[i];
-	}
+	/// Apply the passed in weights. This also allocates the
+	/// storage, zeroed.
+	SetWeights(weightCount(numInWeights), inWeights,
+	           weightCount(numOutWeights), outWeights);
 }
 //////////////////////////////////////////////////////////
 /// @brief The c'tor constructs the class members.
 ////////////////////////////////////////////////////////////
+Filter::Filter(const std::vector<float>& inWeights,
+               const std::vector<float>& outWeights, FilterArena* arena) :
+         _inputBuffer(NULL),
+         _inputHead(0),
+         _outputBuffer(NULL),
+         _outputHead(0),
+         _numInWeights(0),
+         _inputWeights(NULL),
+         _numOutWeights(0),
+         _outputWeights(NULL),
+         _storage(NULL),
+         _inputCapacity(0),
+         _outputCapacity(0),
+         _arena(arena)
+{
+	SetWeights(static_cast<unsigned int>(inWeights.size()),
+	           inWeights.empty() ? NULL : &inWeights[0],
+	           static_cast<unsigned int>(outWeights.size()),
+	           outWeights.empty() ? NULL : &outWeights[0]);
+}
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members. Room for
+///        one weight of each kind keeps the filter routines
+///        safe to call on an unconfigured filter.
+////////////////////////////////////////////////////////////
 Filter::Filter() :
-         _inputBuffer(),
-         _outputBuffer(),
+         _inputBuffer(NULL),
+         _inputHead(0),
+         _outputBuffer(NULL),
+         _outputHead(0),
          _numInWeights(0),
-         _inputWeights(),
+         _inputWeights(NULL),
          _numOutWeights(0),
-         _outputWeights()
+         _outputWeights(NULL),
+         _storage(NULL),
+         _inputCapacity(0),
+         _outputCapacity(0),
+         _arena(NULL)
 {
-	/// initialize all weights to 0.0
-	for (unsigned int i = 0; i<MAX_FILTER_SIZE; i++){
-		_inputWeights[i] = 0.0;
-		_outputWeights[i] = 0.0;
-	}
+	adoptStorage(new float[StorageSize(1, 1)](), 1, 1);
+}
+//////////////////////////////////////////////////////////
+/// @brief The c'tor copies the other filter's block.
+////////////////////////////////////////////////////////////
+Filter::Filter(const Filter& other) :
+         _inputBuffer(NULL),
+         _inputHead(other._inputHead),
+         _outputBuffer(NULL),
+         _outputHead(other._outputHead),
+         _numInWeights(other._numInWeights),
+         _inputWeights(NULL),
+         _numOutWeights(other._numOutWeights),
+         _outputWeights(NULL),
+         _storage(NULL),
+         _inputCapacity(0),
+         _outputCapacity(0),
+         _arena(NULL)
+{
+	const size_t size = StorageSize(other._inputCapacity,
+	                                other._outputCapacity);
+	float* storage = new float[size];
+	std::copy(other._storage, other._storage + size, storage);
+	adoptStorage(storage, other._inputCapacity, other._outputCapacity);
+}
+//////////////////////////////////////////////////////////
+/// @brief The c'tor takes the other filter's block.
+////////////////////////////////////////////////////////////
+Filter::Filter(Filter&& other) noexcept :
+         _inputBuffer(other._inputBuffer),
+         _inputHead(other._inputHead),
+         _outputBuffer(other._outputBuffer),
+         _outputHead(other._outputHead),
+         _numInWeights(other._numInWeights),
+         _inputWeights(other._inputWeights),
+         _numOutWeights(other._numOutWeights),
+         _outputWeights(other._outputWeights),
+         _storage(other._storage),
+         _inputCapacity(other._inputCapacity),
+         _outputCapacity(other._outputCapacity),
+         _arena(other._arena)
+{
+	other._inputBuffer = NULL;
+	other._outputBuffer = NULL;
+	other._inputWeights = NULL;
+	other._outputWeights = NULL;
+	other._storage = NULL;
+	other._numInWeights = 0;
+	other._numOutWeights = 0;
+	other._inputCapacity = 0;
+	other._outputCapacity = 0;
+	other._arena = NULL;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Swaps in the members of the by-value argument.
+/// @param other -- A copy of, or the moved, right hand side.
+/// @return This filter.
+////////////////////////////////////////////////////////////
+Filter& Filter::operator=(Filter other){
+	std::swap(_inputBuffer, other._inputBuffer);
+	std::swap(_inputHead, other._inputHead);
+	std::swap(_outputBuffer, other._outputBuffer);
+	std::swap(_outputHead, other._outputHead);
+	std::swap(_numInWeights, other._numInWeights);
+	std::swap(_inputWeights, other._inputWeights);
+	std::swap(_numOutWeights, other._numOutWeights);
+	std::swap(_outputWeights, other._outputWeights);
+	std::swap(_storage, other._storage);
+	std::swap(_inputCapacity, other._inputCapacity);
+	std::swap(_outputCapacity, other._outputCapacity);
+	std::swap(_arena, other._arena);
+	return *this;
 }
 
 ////////////////////////////////////////////////////////////
 /// @brief Default  d'tor
 ////////////////////////////////////////////////////////////
 Filter::~Filter() {
+	if (_arena == NULL){
+		delete[] _storage;
+	}
+}
 
+////////////////////////////////////////////////////////////
+/// @brief Lays the weights and buffers out in the block.
+/// @param storage        -- The new block.
+/// @param inputCapacity  -- Input weights it holds.
+/// @param outputCapacity -- Output weights it holds.
+////////////////////////////////////////////////////////////
+void Filter::adoptStorage(float* storage, unsigned int inputCapacity,
+                          unsigned int outputCapacity){
+  if (_arena == NULL){
+    delete[] _storage;
+  }
+  _storage = storage;
+  _inputCapacity = inputCapacity;
+  _outputCapacity = outputCapacity;
+  _inputWeights = storage;
+  _outputWeights = _inputWeights + inputCapacity;
+  _inputBuffer = _outputWeights + outputCapacity;
+  _outputBuffer = _inputBuffer + 2*inputCapacity;
 }
+
+////////////////////////////////////////////////////////////
+/// @brief Resizes through Filter::SetWeights with the current
+///        weights padded or cut to the new counts. They are
+///        already normalized, so SetWeights leaves their
+///        values unchanged.
+/// @param numInWeights  -- Number of input weights (b).
+/// @param numOutWeights -- Number of output weights (a).
+////////////////////////////////////////////////////////////
+void Filter::resizeWeights(unsigned int numInWeights,
+                           unsigned int numOutWeights){
+  if (numInWeights == 0 || numOutWeights == 0){
+    throw std::invalid_argument("Filter weight counts must be at least 1");
+  }
+  std::vector<float> inputWeights(_inputWeights,
+                                  _inputWeights + _numInWeights);
+  std::vector<float> outputWeights(_outputWeights,
+                                   _outputWeights + _numOutWeights);
+  if (outputWeights.empty()){
+    outputWeights.push_back(1.0f);
+  }
+  inputWeights.resize(numInWeights, 0.0f);
+  outputWeights.resize(numOutWeights, 0.0f);
+  Filter::SetWeights(numInWeights, inputWeights.data(),
+                     numOutWeights, outputWeights.data());
+}
+
 ////////////////////////////////////////////////////////////
 /// @brief Helper function to initialize the input  and
 ///        output buffers.
@@ -68,25 +247,300 @@ void Filter::initBuffer(float* buff, unsigned int buff_size){
 /// @return Output from the filter
 ////////////////////////////////////////////////////////////
 float Filter::filter(float inputValue) {
+#ifdef FILTER_INSTRUMENTATION
+  const uint64_t start = _stats.beginSample();
+#endif
   float outputContribution = 0.0;
   float inputContribution = 0.0;
-  /// Buffer the input values and previous input values.
-  for(unsigned int i=_numInWeights; i>0; i--){
-	_inputBuffer[i] = _inputBuffer[i-1];
-  }
-  _inputBuffer[0] = inputValue;
-  /// Buffer the output values and previous output values.
-  for(unsigned int i=_numOutWeights; i>0; i--){
-	_outputBuffer[i] = _outputBuffer[i-1];
-  }
+  /// Buffer the input value. It is written to both halves of
+  /// the mirrored buffer so the window stays contiguous.
+  _inputHead = retreatHead(_inputHead, _numInWeights);
+  _inputBuffer[_inputHead] = inputValue;
+  _inputBuffer[_inputHead + _numInWeights] = inputValue;
+  /// Make room for the new output. The previous outputs are
+  /// the ones following the head.
+  _outputHead = retreatHead(_outputHead, _numOutWeights);
+  const float* inputs = &_inputBuffer[_inputHead];
+  const float* outputs = &_outputBuffer[_outputHead];
   for(unsigned int i=0; i<_numInWeights; i++){
-    inputContribution += _inputWeights[i]*_inputBuffer[i];
+    inputContribution += _inputWeights[i]*inputs[i];
   }
   for(unsigned int i=1; i<_numOutWeights; i++){
-    outputContribution += _outputWeights[i]*_outputBuffer[i];
+    outputContribution += _outputWeights[i]*outputs[i];
   }
   /// @note calculate the current filter output based on previous
-  ///       inputs and previous outputs.
-  _outputBuffer[0] = (1/_outputWeights[0])*(inputContribution - outputContribution);
-  return _outputBuffer[0];
+  ///       inputs and previous outputs. The weights are already
+  ///       divided by a[0].
+  float outputValue = inputContribution - outputContribution;
+  _outputBuffer[_outputHead] = outputValue;
+  _outputBuffer[_outputHead + _numOutWeights] = outputValue;
+#ifdef FILTER_INSTRUMENTATION
+  _stats.endSample(outputValue, start);
+#endif
+  return outputValue;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Generic Discrete block filter function. Performs
+///        the same buffering and weighting as filter() for
+///        each sample, with the weight counts held in locals
+///        for the whole block.
+/// @param input      -- Input samples, oldest first.
+/// @param output     -- Destination for the filter outputs.
+/// @param numSamples -- Number of samples in the block.
+////////////////////////////////////////////////////////////
+void Filter::filterBlock(const float* input, float* output,
+                         unsigned int numSamples) {
+#ifdef FILTER_INSTRUMENTATION
+  const uint64_t start = _stats.beginBlock();
+  unsigned int nonFinite = 0, saturated = 0;
+#endif
+  const unsigned int numIn = _numInWeights;
+  const unsigned int numOut = _numOutWeights;
+  unsigned int inputHead = _inputHead;
+  unsigned int outputHead = _outputHead;
+  for(unsigned int n=0; n<numSamples; n++){
+    float outputContribution = 0.0;
+    float inputContribution = 0.0;
+    const float inputValue = input[n];
+    inputHead = retreatHead(inputHead, numIn);
+    _inputBuffer[inputHead] = inputValue;
+    _inputBuffer[inputHead + numIn] = inputValue;
+    outputHead = retreatHead(outputHead, numOut);
+    const float* inputs = &_inputBuffer[inputHead];
+    const float* outputs = &_outputBuffer[outputHead];
+    for(unsigned int i=0; i<numIn; i++){
+      inputContribution += _inputWeights[i]*inputs[i];
+    }
+    for(unsigned int i=1; i<numOut; i++){
+      outputContribution += _outputWeights[i]*outputs[i];
+    }
+    const float outputValue = inputContribution - outputContribution;
+    _outputBuffer[outputHead] = outputValue;
+    _outputBuffer[outputHead + numOut] = outputValue;
+    output[n] = outputValue;
+#ifdef FILTER_INSTRUMENTATION
+    _stats.classify(outputValue, nonFinite, saturated);
+#endif
+  }
+  _inputHead = inputHead;
+  _outputHead = outputHead;
+#ifdef FILTER_INSTRUMENTATION
+  _stats.endBlock(numSamples, nonFinite, saturated, start);
+#endif
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Validates and normalizes new weights, then swaps
+///        them in, carrying the newest history over.
+/// @param numInWeights  -- Number of input weights (b).
+/// @param inWeights     -- The input weights.
+/// @param numOutWeights -- Number of output weights (a).
+/// @param outWeights    -- The output weights.
+////////////////////////////////////////////////////////////
+void Filter::SetWeights(unsigned int numInWeights, const float* inWeights,
+                        unsigned int numOutWeights, const float* outWeights){
+  if (numInWeights == 0 || numOutWeights == 0){
+    throw std::invalid_argument("Filter weight counts must be at least 1");
+  }
+  std::vector<float> inputWeights(numInWeights);
+  std::vector<float> outputWeights(numOutWeights);
+  normalizeWeights<SampleTraits<float> >(numInWeights, inWeights,
+                                         numOutWeights, outWeights,
+                                         inputWeights.data(),
+                                         outputWeights.data());
+  /// Grow into a new block if needed. The history is saved
+  /// before the old block can be freed.
+  std::vector<float> inputHistory(std::max(numInWeights, _numInWeights));
+  std::vector<float> outputHistory(std::max(numOutWeights, _numOutWeights));
+  float* storage = _storage;
+  const unsigned int inputCapacity = std::max(numInWeights, _inputCapacity);
+  const unsigned int outputCapacity = std::max(numOutWeights, _outputCapacity);
+  if (inputCapacity != _inputCapacity || outputCapacity != _outputCapacity){
+    const size_t size = StorageSize(inputCapacity, outputCapacity);
+    storage = (_arena != NULL) ? _arena->allocate(size) : new float[size]();
+  }
+
+  /// Nothing can fail past this point.
+  GetInputBufferSnapshot(&inputHistory[0]);
+  GetOutputBufferSnapshot(&outputHistory[0]);
+  const bool moved = (storage != _storage);
+  if (moved){
+    adoptStorage(storage, inputCapacity, outputCapacity);
+  }
+  if (moved || numInWeights != _numInWeights){
+    setDelayLine(_inputBuffer, _inputHead, numInWeights, &inputHistory[0]);
+  }
+  if (moved || numOutWeights != _numOutWeights){
+    setDelayLine(_outputBuffer, _outputHead, numOutWeights, &outputHistory[0]);
+  }
+  std::copy(inputWeights.begin(), inputWeights.end(), _inputWeights);
+  std::fill(_inputWeights + numInWeights, _inputWeights + _inputCapacity, 0.0f);
+  std::copy(outputWeights.begin(), outputWeights.end(), _outputWeights);
+  std::fill(_outputWeights + numOutWeights,
+            _outputWeights + _outputCapacity, 0.0f);
+  _numInWeights = numInWeights;
+  _numOutWeights = numOutWeights;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Copies the input window out of the circular
+///        buffer, newest sample first.
+/// @param dest -- Array of at least _numInWeights values.
+////////////////////////////////////////////////////////////
+void Filter::GetInputBufferSnapshot(float* dest) const {
+  for(unsigned int i=0; i<_numInWeights; i++){
+    dest[i] = _inputBuffer[_inputHead + i];
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Copies the output window out of the circular
+///        buffer, newest output first.
+/// @param dest -- Array of at least _numOutWeights values.
+////////////////////////////////////////////////////////////
+void Filter::GetOutputBufferSnapshot(float* dest) const {
+  for(unsigned int i=0; i<_numOutWeights; i++){
+    dest[i] = _outputBuffer[_outputHead + i];
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Rewrites both circular buffers from newest first
+///        histories.
+/// @param inputs  -- _numInWeights values.
+/// @param outputs -- _numOutWeights values.
+////////////////////////////////////////////////////////////
+void Filter::RestoreBufferSnapshot(const float* inputs,
+                                   const float* outputs){
+  setDelayLine(_inputBuffer, _inputHead, _numInWeights, inputs);
+  setDelayLine(_outputBuffer, _outputHead, _numOutWeights, outputs);
+  delayLinesChanged();
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Fills both delay lines with the response to a
+///        constant input. The weights are already divided by
+///        a[0]; the sums are taken in double.
+/// @param inputLevel -- The constant input.
+////////////////////////////////////////////////////////////
+void Filter::SetSteadyState(float inputLevel){
+  double sumB = 0.0, sumA = 0.0;
+  for(unsigned int i=0; i<_numInWeights; i++){
+    sumB += _inputWeights[i];
+  }
+  for(unsigned int i=0; i<_numOutWeights; i++){
+    sumA += _outputWeights[i];
+  }
+  if (sumA == 0.0){
+    throw std::invalid_argument("Filter has a pole at z = 1 and no steady "
+                                "state");
+  }
+  const float outputLevel = static_cast<float>(inputLevel*sumB/sumA);
+  std::fill(_inputBuffer, _inputBuffer + 2*_numInWeights, inputLevel);
+  std::fill(_outputBuffer, _outputBuffer + 2*_numOutWeights, outputLevel);
+  delayLinesChanged();
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Copies both delay lines out, newest first.
+/// @return The filter's state.
+////////////////////////////////////////////////////////////
+FilterState Filter::SaveState(void) const {
+  FilterState state;
+  state.inputs.resize(_numInWeights);
+  state.outputs.resize(_numOutWeights);
+  GetInputBufferSnapshot(state.inputs.data());
+  GetOutputBufferSnapshot(state.outputs.data());
+  return state;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Checks the lengths, then rewrites both delay lines.
+/// @param state -- The state to restore.
+////////////////////////////////////////////////////////////
+void Filter::RestoreState(const FilterState& state){
+  if (state.inputs.size() != _numInWeights ||
+      state.outputs.size() != _numOutWeights){
+    throw std::invalid_argument("FilterState does not match the filter's "
+                                "weight counts");
+  }
+  RestoreBufferSnapshot(state.inputs.data(), state.outputs.data());
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Resizes a delay line inside its own buffer: the
+///        newest values move to the front, new slots are
+///        zeroed, and the mirror half is rewritten.
+/// @param buff    -- The input or output buffer, with room for
+///                   2*max(oldSize, newSize) values.
+/// @param head    -- The head index of that buffer.
+/// @param oldSize -- Current length of the delay line.
+/// @param newSize -- New length of the delay line.
+////////////////////////////////////////////////////////////
+static void resizeDelayLine(float* buff, unsigned int& head,
+                            unsigned int oldSize, unsigned int newSize){
+  const unsigned int keep = std::min(oldSize, newSize);
+  std::copy(buff + head, buff + head + keep, buff);
+  std::fill(buff + keep, buff + newSize, 0.0f);
+  std::copy(buff, buff + newSize, buff + newSize);
+  head = 0;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Copies prepared weights into the current storage.
+/// @param numInWeights  -- Number of input weights (b).
+/// @param inWeights     -- The normalized input weights.
+/// @param numOutWeights -- Number of output weights (a).
+/// @param outWeights    -- The normalized output weights.
+////////////////////////////////////////////////////////////
+void Filter::installWeights(unsigned int numInWeights, const float* inWeights,
+                            unsigned int numOutWeights,
+                            const float* outWeights){
+  if (numInWeights != _numInWeights){
+    resizeDelayLine(_inputBuffer, _inputHead, _numInWeights, numInWeights);
+  }
+  if (numOutWeights != _numOutWeights){
+    resizeDelayLine(_outputBuffer, _outputHead, _numOutWeights, numOutWeights);
+  }
+  std::copy(inWeights, inWeights + numInWeights, _inputWeights);
+  std::fill(_inputWeights + numInWeights, _inputWeights + _inputCapacity, 0.0f);
+  std::copy(outWeights, outWeights + numOutWeights, _outputWeights);
+  std::fill(_outputWeights + numOutWeights,
+            _outputWeights + _outputCapacity, 0.0f);
+  _numInWeights = numInWeights;
+  _numOutWeights = numOutWeights;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Rewrites a delay line from a newest first history,
+///        resetting its head to the start of the buffer.
+/// @param buff        -- The input or output buffer.
+/// @param head        -- The head index of that buffer.
+/// @param size        -- Length of the delay line.
+/// @param newestFirst -- History values, newest first.
+////////////////////////////////////////////////////////////
+void Filter::setDelayLine(float* buff, unsigned int& head,
+                          unsigned int size, const float* newestFirst){
+  for(unsigned int i=0; i<size; i++){
+    buff[i] = newestFirst[i];
+    buff[i + size] = newestFirst[i];
+  }
+  head = 0;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Derived classes must opt in, since they may filter
+///        by other means than the weights.
+/// @return true for a plain Filter.
+////////////////////////////////////////////////////////////
+bool Filter::IsDifferenceEquation(void) const {
+  return typeid(*this) == typeid(Filter);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Nothing to rebuild: the plain filter keeps no state
+///        besides its delay lines.
+////////////////////////////////////////////////////////////
+void Filter::delayLinesChanged(void){
 }
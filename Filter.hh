@@ -18,11 +18,37 @@
 #ifndef FILTER_HH
 #define FILTER_HH
 
-/// @note This is the maximum allowable size for any filter
-///       built with this class. It is expected that twenty
-///       will be more than enough for our application.
+#include <cstddef>
+#include <vector>
+
+#ifdef FILTER_INSTRUMENTATION
+#include "FilterStats.hh"
+#endif
+
+/// @note This used to be the maximum allowable size for any
+///       filter built with this class. Filters are now sized
+///       to their weights; twenty remains the longest of the
+///       short filters the class is tuned and benchmarked for.
 #define MAX_FILTER_SIZE 20
 
+class FilterArena;
+
+///////////////////////////////////////////////////////////////
+/// @brief A Filter's delay lines, saved by Filter::SaveState
+///        and put back by Filter::RestoreState, for example
+///        across a restart of the process running the filter.
+///////////////////////////////////////////////////////////////
+struct FilterState {
+  ////////////////////////////////////////////////////////////
+  /// @brief Past inputs, newest first.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> inputs;
+  ////////////////////////////////////////////////////////////
+  /// @brief Past outputs, newest first.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> outputs;
+};
+
 ///////////////////////////////////////////////////////////////
 /// @class Filter
 /// @ingroup DSP
@@ -42,6 +68,16 @@
 /// filter.
 ///
 /// @image html avg_filter_verif.png "Moving Average Filter"
+///
+/// The weights and delay lines live in one block sized
+/// exactly to the weight counts (see StorageSize), taken from
+/// the heap or, to pack many filters together, from a
+/// FilterArena. There is no upper limit on the counts, so long
+/// FIR designs are supported.
+///
+/// Built with FILTER_INSTRUMENTATION defined, filter() and
+/// filterBlock() also count samples, output anomalies and
+/// latency in a FilterStats; see GetStats().
 ///////////////////////////////////////////////////////////////
 class Filter {
 
@@ -49,20 +85,67 @@ class Filter {
   //////////////////////////////////////////////////////////
   /// @brief This constructor will construct the filter
   ///        with all the necessary parameters to build a
-  ///        custom filter.
+  ///        custom filter. The weights are normalized by
+  ///        a[0] as described for SetWeights.
+  ///        The storage comes from the heap.
+  /// @throws std::invalid_argument if the weights are
+  ///         rejected by SetWeights.
   ////////////////////////////////////////////////////////////
   Filter(float numInWeights, float* inWeights,
 		  float numOutWeights, float* outWeights);
   //////////////////////////////////////////////////////////
+  /// @brief This constructor builds the filter from weight
+  ///        vectors, whose sizes are the weight counts, so
+  ///        the counts cannot disagree with the data.
+  /// @param inWeights  -- The input weights (b).
+  /// @param outWeights -- The output weights (a).
+  /// @param arena      -- Arena to take the storage from, or
+  ///                      NULL for the heap. The arena must
+  ///                      outlive the filter.
+  /// @throws std::invalid_argument if the weights are
+  ///         rejected by SetWeights.
+  /// @throws std::bad_alloc if the arena is full.
+  ////////////////////////////////////////////////////////////
+  Filter(const std::vector<float>& inWeights,
+         const std::vector<float>& outWeights, FilterArena* arena = NULL);
+  //////////////////////////////////////////////////////////
   /// @brief The default c'tor constructs the Filter base
   ///        class.
   ////////////////////////////////////////////////////////////
   Filter();
   //////////////////////////////////////////////////////////
+  /// @brief The copy c'tor copies the weights and state. The
+  ///        copy owns its storage on the heap, whether or not
+  ///        the original was built on an arena.
+  ////////////////////////////////////////////////////////////
+  Filter(const Filter& other);
+  //////////////////////////////////////////////////////////
+  /// @brief The move c'tor takes over the other filter's
+  ///        storage, leaving it with none.
+  ////////////////////////////////////////////////////////////
+  Filter(Filter&& other) noexcept;
+  ////////////////////////////////////////////////////////////
+  /// @brief Copies the weights and state as the copy c'tor
+  ///        does, or takes them over from a temporary.
+  ////////////////////////////////////////////////////////////
+  Filter& operator=(Filter other);
+  //////////////////////////////////////////////////////////
   /// @brief The default d'tor destructs the Filter base
-  ///        class.
+  ///        class. Virtual, since derived filters and chains
+  ///        are owned through Filter pointers.
+  ////////////////////////////////////////////////////////////
+  virtual ~Filter();
   ////////////////////////////////////////////////////////////
-  ~Filter();
+  /// @brief Number of floats of storage a filter with the
+  ///        given weight counts takes: the weights and the
+  ///        mirrored delay lines.
+  /// @param numInWeights  -- Number of input weights (b).
+  /// @param numOutWeights -- Number of output weights (a).
+  /// @return The storage size in floats.
+  ////////////////////////////////////////////////////////////
+  static inline size_t StorageSize(unsigned int numInWeights,
+                                   unsigned int numOutWeights){
+	       return 3*(static_cast<size_t>(numInWeights) + numOutWeights); }
   ////////////////////////////////////////////////////////////
   /// @brief Main filter routine. This is a virtual function
   ///        and it is expected that filters which derive
@@ -73,32 +156,169 @@ class Filter {
   ////////////////////////////////////////////////////////////
   virtual float filter(float inputValue);
   ////////////////////////////////////////////////////////////
+  /// @brief Block filter routine. Runs an entire span of
+  ///        input samples through the filter in one call.
+  ///        The outputs are bit-identical to calling
+  ///        filter() once per sample, but the dispatch and
+  ///        loop setup is paid once per block. Derived
+  ///        filters may override this with a specialized
+  ///        version of the loop.
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for the filter outputs.
+  ///                      May alias input.
+  /// @param numSamples -- Number of samples in the block.
+  ////////////////////////////////////////////////////////////
+  virtual void filterBlock(const float* input, float* output,
+                           unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
   /// @brief An accessor function to get the current input
-  ///        buffer of the filter.
+  ///        buffer of the filter. The buffer is ordered
+  ///        newest sample first and is only valid until the
+  ///        next call to filter() or filterBlock().
   /// @return The current input buffer of the filter.
   ////////////////////////////////////////////////////////////
   inline float* GetCurrentInputBuffer(void){
-	                              return _inputBuffer; }
+	                              return &_inputBuffer[_inputHead]; }
   ////////////////////////////////////////////////////////////
   /// @brief An accessor function to get the current output
-  ///        buffer of the filter.
+  ///        buffer of the filter. The buffer is ordered
+  ///        newest output first and is only valid until the
+  ///        next call to filter() or filterBlock().
   /// @return The current output buffer of the filter.
   ////////////////////////////////////////////////////////////
   inline float* GetCurrentOutputBuffer(void){
-	                              return _outputBuffer; }
+	                              return &_outputBuffer[_outputHead]; }
+  ////////////////////////////////////////////////////////////
+  /// @brief Copies the current input buffer, newest sample
+  ///        first, into a caller supplied array.
+  /// @param dest -- Array of at least the number of input
+  ///                weights.
+  ////////////////////////////////////////////////////////////
+  void GetInputBufferSnapshot(float* dest) const;
+  ////////////////////////////////////////////////////////////
+  /// @brief Copies the current output buffer, newest output
+  ///        first, into a caller supplied array.
+  /// @param dest -- Array of at least the number of output
+  ///                weights.
+  ////////////////////////////////////////////////////////////
+  void GetOutputBufferSnapshot(float* dest) const;
+  ////////////////////////////////////////////////////////////
+  /// @brief Overwrites both delay lines, the inverse of the
+  ///        two snapshot functions. The filter continues as if
+  ///        it had seen these inputs and produced these outputs.
+  /// @param inputs  -- GetNumInWeights() values, newest input
+  ///                   first.
+  /// @param outputs -- GetNumOutWeights() values, newest output
+  ///                   first.
+  ////////////////////////////////////////////////////////////
+  void RestoreBufferSnapshot(const float* inputs, const float* outputs);
+  ////////////////////////////////////////////////////////////
+  /// @brief Puts the filter in the steady state it would
+  ///        settle into after a long run of a constant input,
+  ///        so filtering starts without a warm up transient.
+  ///        This is the direct form counterpart of scipy's
+  ///        lfilter_zi scaled by the input level: every past
+  ///        input is the level and every past output is the
+  ///        level times the DC gain, sum(b)/sum(a).
+  /// @param inputLevel -- The constant input.
+  /// @throws std::invalid_argument if the output weights sum
+  ///         to zero: a pole at z = 1 has no steady state.
+  ////////////////////////////////////////////////////////////
+  void SetSteadyState(float inputLevel);
+  ////////////////////////////////////////////////////////////
+  /// @brief Saves the delay lines.
+  /// @return The filter's state.
+  ////////////////////////////////////////////////////////////
+  FilterState SaveState(void) const;
+  ////////////////////////////////////////////////////////////
+  /// @brief Puts back a state saved from a filter with the
+  ///        same weight counts.
+  /// @param state -- The state to restore.
+  /// @throws std::invalid_argument if the state's lengths do
+  ///         not match the weight counts.
+  ////////////////////////////////////////////////////////////
+  void RestoreState(const FilterState& state);
+  ////////////////////////////////////////////////////////////
+  /// @brief Replaces the filter weights. Both sets are
+  ///        divided by a[0] here, once, so the filter routines
+  ///        need no division and a[0] is stored as 1. The new
+  ///        weights are checked before anything is changed: a
+  ///        rejected update leaves the filter as it was. The
+  ///        delay lines keep their newest values, so a running
+  ///        filter continues from its current state; when a
+  ///        count grows the extra history is zero. A count
+  ///        larger than the filter has room for moves it to a
+  ///        new block, from the same arena if it has one.
+  ///        Derived filters whose weights are fixed by their
+  ///        own parameters override this to reject the update
+  ///        or to apply it their way.
+  /// @param numInWeights  -- Number of input weights (b),
+  ///                         at least 1.
+  /// @param inWeights     -- The input weights.
+  /// @param numOutWeights -- Number of output weights (a),
+  ///                         at least 1.
+  /// @param outWeights    -- The output weights.
+  /// @throws std::invalid_argument if a count is zero, a[0]
+  ///         is zero or not finite, or a normalized weight is
+  ///         not finite.
+  /// @throws std::bad_alloc if the filter's arena is full.
+  ////////////////////////////////////////////////////////////
+  virtual void SetWeights(unsigned int numInWeights, const float* inWeights,
+                          unsigned int numOutWeights,
+                          const float* outWeights);
   ////////////////////////////////////////////////////////////
   /// @brief An accessor function to get the filter's input
-  ///        weights.
+  ///        weights, normalized by a[0].
   /// @return The filters input weights
   ////////////////////////////////////////////////////////////
   inline float* GetInputWeights(void){
 	                              return _inputWeights; }
+  inline const float* GetInputWeights(void) const {
+	                              return _inputWeights; }
   ////////////////////////////////////////////////////////////
   /// @brief An accessor function to get the filter's output
-  ///        weights.
+  ///        weights, normalized so a[0] is 1.
   /// @return The filters output weights
   inline float* GetOutputWeights(void){
 	                              return _outputWeights; }
+  inline const float* GetOutputWeights(void) const {
+	                              return _outputWeights; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the number of input
+  ///        weights.
+  /// @return The number of input weights (b).
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetNumInWeights(void) const {
+	                              return _numInWeights; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the number of output
+  ///        weights.
+  /// @return The number of output weights (a).
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetNumOutWeights(void) const {
+	                              return _numOutWeights; }
+  ////////////////////////////////////////////////////////////
+  /// @brief Tells whether filter() and filterBlock() compute
+  ///        exactly the difference equation of the weights,
+  ///        with the delay lines as the only state. Only then
+  ///        can the filter be copied as a plain Filter, split
+  ///        into chunks or run backwards, as filterParallel,
+  ///        filtfilt and FilterChain::collapse do. A plain
+  ///        Filter is; a derived class is not unless it
+  ///        overrides this.
+  /// @return true if the filter is its difference equation.
+  ////////////////////////////////////////////////////////////
+  virtual bool IsDifferenceEquation(void) const;
+#ifdef FILTER_INSTRUMENTATION
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the run time
+  ///        statistics. Copies and assignments keep their own
+  ///        counts.
+  /// @return The filter's statistics.
+  ////////////////////////////////////////////////////////////
+  inline FilterStats& GetStats(void){ return _stats; }
+  inline const FilterStats& GetStats(void) const { return _stats; }
+#endif
 
  protected:
   ////////////////////////////////////////////////////////////
@@ -109,13 +329,102 @@ class Filter {
   ////////////////////////////////////////////////////////////
   void initBuffer(float* buff, unsigned int buff_size);
   ////////////////////////////////////////////////////////////
-  /// @brief Buffer holding the input signal values.
+  /// @brief Overwrites a delay line with the given history.
+  ///        Used by derived filters that keep their delay
+  ///        line in locals to write the state back.
+  /// @param buff        -- The input or output buffer.
+  /// @param head        -- The head index of that buffer.
+  /// @param size        -- Length of the delay line.
+  /// @param newestFirst -- History values, newest first.
+  ////////////////////////////////////////////////////////////
+  void setDelayLine(float* buff, unsigned int& head,
+                    unsigned int size, const float* newestFirst);
+  ////////////////////////////////////////////////////////////
+  /// @brief Called after RestoreBufferSnapshot, RestoreState
+  ///        or SetSteadyState has rewritten the delay lines, so
+  ///        a derived filter that keeps state derived from them
+  ///        can rebuild it. The default does nothing.
+  ////////////////////////////////////////////////////////////
+  virtual void delayLinesChanged(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Block filter routine for derived filters with
+  ///        fixed tap counts. The block runs through a
+  ///        StaticFilter loaded from this filter's weights and
+  ///        delay lines, whose loops are fully unrolled, and
+  ///        the delay lines are written back afterwards.
+  ///        Outputs are bit-identical to filter(). Falls back
+  ///        to Filter::filterBlock once SetWeights has changed
+  ///        the counts.
+  /// @tparam Kernel    -- The StaticFilter type to run.
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for the filter outputs.
+  /// @param numSamples -- Number of samples in the block.
+  ////////////////////////////////////////////////////////////
+  template <typename Kernel>
+  void staticFilterBlock(const float* input, float* output,
+                         unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief Replaces the weights without allocating, for
+  ///        filters that take new weights on a real time
+  ///        thread. The delay lines keep their newest values
+  ///        as in SetWeights. The caller guarantees what
+  ///        SetWeights would check: the weights are already
+  ///        normalized and finite, and the counts are at least
+  ///        1 and fit the current storage.
+  /// @param numInWeights  -- Number of input weights (b).
+  /// @param inWeights     -- The normalized input weights.
+  /// @param numOutWeights -- Number of output weights (a).
+  /// @param outWeights    -- The normalized output weights.
   ////////////////////////////////////////////////////////////
-  float _inputBuffer[MAX_FILTER_SIZE];
+  void installWeights(unsigned int numInWeights, const float* inWeights,
+                      unsigned int numOutWeights, const float* outWeights);
   ////////////////////////////////////////////////////////////
-  /// @brief Buffer holding the output signal values.
+  /// @brief Points the weight and buffer pointers into a new
+  ///        block, freeing the old block if it came from the
+  ///        heap.
+  /// @param storage        -- StorageSize(inputCapacity,
+  ///                          outputCapacity) floats.
+  /// @param inputCapacity  -- Input weights the block holds.
+  /// @param outputCapacity -- Output weights the block holds.
   ////////////////////////////////////////////////////////////
-  float _outputBuffer[MAX_FILTER_SIZE];
+  void adoptStorage(float* storage, unsigned int inputCapacity,
+                    unsigned int outputCapacity);
+  ////////////////////////////////////////////////////////////
+  /// @brief Sets the weight counts, growing the storage as
+  ///        SetWeights does, so a derived filter can then
+  ///        write its weights straight into _inputWeights and
+  ///        _outputWeights. Weights that remain keep their
+  ///        values and new ones are zero, except a[0], which
+  ///        is 1 if the filter had no output weights. The
+  ///        delay lines keep their newest values. Whatever the
+  ///        derived filter writes must be normalized: a[0] is
+  ///        1 and every weight is finite.
+  /// @param numInWeights  -- Number of input weights (b).
+  /// @param numOutWeights -- Number of output weights (a).
+  /// @throws std::invalid_argument if a count is zero.
+  ////////////////////////////////////////////////////////////
+  void resizeWeights(unsigned int numInWeights, unsigned int numOutWeights);
+  ////////////////////////////////////////////////////////////
+  /// @brief Buffer holding the input signal values. This is
+  ///        a circular buffer stored twice back to back, so
+  ///        the _numInWeights values starting at _inputHead
+  ///        are always contiguous, newest sample first.
+  ////////////////////////////////////////////////////////////
+  float* _inputBuffer;
+  ////////////////////////////////////////////////////////////
+  /// @brief Index of the newest sample in _inputBuffer.
+  ////////////////////////////////////////////////////////////
+  unsigned int _inputHead;
+  ////////////////////////////////////////////////////////////
+  /// @brief Buffer holding the output signal values. Same
+  ///        mirrored circular layout as _inputBuffer, with
+  ///        _numOutWeights values starting at _outputHead.
+  ////////////////////////////////////////////////////////////
+  float* _outputBuffer;
+  ////////////////////////////////////////////////////////////
+  /// @brief Index of the newest output in _outputBuffer.
+  ////////////////////////////////////////////////////////////
+  unsigned int _outputHead;
   ////////////////////////////////////////////////////////////
   /// @brief The number of input weights.
   ////////////////////////////////////////////////////////////
@@ -123,9 +432,9 @@ class Filter {
   ////////////////////////////////////////////////////////////
   /// @brief Weights to be applied to the input signal and
   ///        delayed values of the input signal in order to
-  ///        generate the output signal.
+  ///        generate the output signal, divided by a[0].
   ////////////////////////////////////////////////////////////
-  float _inputWeights[MAX_FILTER_SIZE];
+  float* _inputWeights;
   ////////////////////////////////////////////////////////////
   /// @brief The number of output weights.
   ////////////////////////////////////////////////////////////
@@ -133,11 +442,73 @@ class Filter {
   ////////////////////////////////////////////////////////////
   /// @brief Weights to be applied to the filter output signal
   ///        and delayed values of the output signal in order
-  ///        to generate the next filter output.
+  ///        to generate the next filter output, divided by
+  ///        a[0] so the first is always 1.
   ////////////////////////////////////////////////////////////
-  float _outputWeights[MAX_FILTER_SIZE];
-
+  float* _outputWeights;
+  ////////////////////////////////////////////////////////////
+  /// @brief The block holding the weights and buffers, laid
+  ///        out as b, a, input buffer, output buffer.
+  ////////////////////////////////////////////////////////////
+  float* _storage;
+  ////////////////////////////////////////////////////////////
+  /// @brief Weight counts the block has room for.
+  ////////////////////////////////////////////////////////////
+  unsigned int _inputCapacity;
+  unsigned int _outputCapacity;
+  ////////////////////////////////////////////////////////////
+  /// @brief Arena _storage came from, or NULL if it came
+  ///        from the heap and is owned by the filter.
+  ////////////////////////////////////////////////////////////
+  FilterArena* _arena;
+#ifdef FILTER_INSTRUMENTATION
+  ////////////////////////////////////////////////////////////
+  /// @brief Run time statistics of filter() and
+  ///        filterBlock().
+  ////////////////////////////////////////////////////////////
+  FilterStats _stats;
+#endif
 
 };
 
+////////////////////////////////////////////////////////////
+/// @brief Runs a block through a StaticFilter copy of the
+///        filter, then stores its delay lines back.
+////////////////////////////////////////////////////////////
+template <typename Kernel>
+void Filter::staticFilterBlock(const float* input, float* output,
+                               unsigned int numSamples){
+  if (_numInWeights != Kernel::NumInWeights ||
+      _numOutWeights != Kernel::NumOutWeights){
+    Filter::filterBlock(input, output, numSamples);
+    return;
+  }
+#ifdef FILTER_INSTRUMENTATION
+  const uint64_t start = _stats.beginBlock();
+#endif
+  /// The weights are already normalized, so a[0] is 1 and
+  /// the kernel's own normalization leaves them unchanged.
+  Kernel kernel(_inputWeights, _outputWeights);
+  const float* inputs = GetCurrentInputBuffer();
+  const float* outputs = GetCurrentOutputBuffer();
+  for(unsigned int i=0; i<Kernel::NumInWeights; i++){
+    kernel.GetCurrentInputBuffer()[i] = inputs[i];
+  }
+  for(unsigned int i=0; i<Kernel::NumOutWeights; i++){
+    kernel.GetCurrentOutputBuffer()[i] = outputs[i];
+  }
+  kernel.filterBlock(input, output, numSamples);
+  setDelayLine(_inputBuffer, _inputHead, Kernel::NumInWeights,
+               kernel.GetCurrentInputBuffer());
+  setDelayLine(_outputBuffer, _outputHead, Kernel::NumOutWeights,
+               kernel.GetCurrentOutputBuffer());
+#ifdef FILTER_INSTRUMENTATION
+  unsigned int nonFinite = 0, saturated = 0;
+  for(unsigned int n=0; n<numSamples; n++){
+    _stats.classify(output[n], nonFinite, saturated);
+  }
+  _stats.endBlock(numSamples, nonFinite, saturated, start);
+#endif
+}
+
 #endif  // FILTER_HH
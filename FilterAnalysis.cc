@@ -0,0 +1,239 @@
+#include "FilterAnalysis.hh"
+#include "Polynomial.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+
+////////////////////////////////////////////////////////////
+/// @brief freqz's grid of numPoints frequencies.
+////////////////////////////////////////////////////////////
+static std::vector<double> uniformGrid(unsigned int numPoints){
+  if (numPoints == 0){
+    throw std::invalid_argument("FilterAnalysis needs at least one "
+                                "frequency");
+  }
+  const double pi = 3.14159265358979323846;
+  std::vector<double> frequencies(numPoints);
+  for (unsigned int k=0; k<numPoints; k++){
+    frequencies[k] = pi*k/numPoints;
+  }
+  return frequencies;
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members.
+////////////////////////////////////////////////////////////
+FilterAnalysis::FilterAnalysis(unsigned int numPoints) :
+         _frequencies(uniformGrid(numPoints)),
+         _real(),
+         _imag()
+{
+  setGrid();
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members.
+////////////////////////////////////////////////////////////
+FilterAnalysis::FilterAnalysis(const std::vector<double>& frequencies) :
+         _frequencies(frequencies),
+         _real(),
+         _imag()
+{
+  if (frequencies.empty()){
+    throw std::invalid_argument("FilterAnalysis needs at least one "
+                                "frequency");
+  }
+  for (size_t k=0; k<frequencies.size(); k++){
+    if (!std::isfinite(frequencies[k])){
+      throw std::invalid_argument("FilterAnalysis frequencies must be "
+                                  "finite");
+    }
+  }
+  setGrid();
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+FilterAnalysis::~FilterAnalysis() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Tabulates exp(-i w). The padding points are never
+///        returned.
+////////////////////////////////////////////////////////////
+void FilterAnalysis::setGrid(void){
+  const size_t padded = (_frequencies.size() + LANES - 1)/LANES*LANES;
+  _real.assign(padded, 0.0);
+  _imag.assign(padded, 0.0);
+  for (size_t k=0; k<_frequencies.size(); k++){
+    _real[k] = std::cos(_frequencies[k]);
+    _imag[k] = -std::sin(_frequencies[k]);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Horner's rule from the last weight down, with the
+///        LANES points in locals so the complex multiply-add
+///        runs across them in vector registers.
+/// @param weights    -- The polynomial's weights, c[0] first.
+/// @param numWeights -- Number of weights.
+/// @param ramp       -- Weight c[k] by k, for the derivative.
+/// @param first      -- First grid point.
+/// @param real       -- Receives LANES real parts.
+/// @param imag       -- Receives LANES imaginary parts.
+////////////////////////////////////////////////////////////
+void FilterAnalysis::horner(const float* weights, unsigned int numWeights,
+                            bool ramp, size_t first,
+                            double* real, double* imag) const {
+  double zr[LANES], zi[LANES], pr[LANES], pi[LANES];
+  for (unsigned int l=0; l<LANES; l++){
+    zr[l] = _real[first + l];
+    zi[l] = _imag[first + l];
+    pr[l] = 0.0;
+    pi[l] = 0.0;
+  }
+  for (unsigned int k=numWeights; k-- > 0;){
+    const double c = ramp ? static_cast<double>(k)*weights[k] : weights[k];
+    for (unsigned int l=0; l<LANES; l++){
+      const double r = pr[l]*zr[l] - pi[l]*zi[l] + c;
+      pi[l] = pr[l]*zi[l] + pi[l]*zr[l];
+      pr[l] = r;
+    }
+  }
+  for (unsigned int l=0; l<LANES; l++){
+    real[l] = pr[l];
+    imag[l] = pi[l];
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief B/A at every grid point.
+/// @param filter   -- The filter whose weights are used.
+/// @param response -- Receives the response.
+////////////////////////////////////////////////////////////
+void FilterAnalysis::frequencyResponse(const Filter& filter,
+                                       std::complex<double>* response) const {
+  const size_t numPoints = _frequencies.size();
+  double br[LANES], bi[LANES], ar[LANES], ai[LANES];
+  for (size_t first=0; first<numPoints; first+=LANES){
+    horner(filter.GetInputWeights(), filter.GetNumInWeights(), false,
+           first, br, bi);
+    horner(filter.GetOutputWeights(), filter.GetNumOutWeights(), false,
+           first, ar, ai);
+    const size_t count = std::min<size_t>(LANES, numPoints - first);
+    for (size_t l=0; l<count; l++){
+      /// Written out; the library division guards against
+      /// overflow and infinities at several times the cost.
+      const double scale = 1.0/(ar[l]*ar[l] + ai[l]*ai[l]);
+      response[first + l] = std::complex<double>(
+          (br[l]*ar[l] + bi[l]*ai[l])*scale,
+          (bi[l]*ar[l] - br[l]*ai[l])*scale);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The delay of each polynomial P is Re(R/P), with R
+///        its ramp weighted sum; the filter's is the input
+///        polynomial's minus the output polynomial's.
+/// @param filter -- The filter whose weights are used.
+/// @param delay  -- Receives the delays.
+////////////////////////////////////////////////////////////
+void FilterAnalysis::groupDelay(const Filter& filter, double* delay) const {
+  const size_t numPoints = _frequencies.size();
+  /// scipy's threshold for a vanishing polynomial.
+  const double singular = 10*DBL_EPSILON;
+  double pr[LANES], pi[LANES], rr[LANES], ri[LANES];
+  for (size_t first=0; first<numPoints; first+=LANES){
+    const size_t count = std::min<size_t>(LANES, numPoints - first);
+    double total[LANES] = {};
+    bool undefined[LANES] = {};
+    for (int side=0; side<2; side++){
+      const float* weights = side == 0 ? filter.GetInputWeights() :
+                                         filter.GetOutputWeights();
+      const unsigned int numWeights = side == 0 ? filter.GetNumInWeights() :
+                                                  filter.GetNumOutWeights();
+      const double sign = side == 0 ? 1.0 : -1.0;
+      horner(weights, numWeights, false, first, pr, pi);
+      horner(weights, numWeights, true, first, rr, ri);
+      for (size_t l=0; l<count; l++){
+        const double magnitude = pr[l]*pr[l] + pi[l]*pi[l];
+        if (magnitude < singular*singular){
+          undefined[l] = true;
+        } else {
+          total[l] += sign*(rr[l]*pr[l] + ri[l]*pi[l])/magnitude;
+        }
+      }
+    }
+    for (size_t l=0; l<count; l++){
+      delay[first + l] = undefined[l] ? 0.0 : total[l];
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Roots of b and a, and b's first nonzero weight as
+///        the gain; a[0] is 1 after Filter's normalization.
+/// @param filter -- The filter whose weights are used.
+/// @return Its zeros, poles and gain.
+////////////////////////////////////////////////////////////
+ZeroPoleGain FilterAnalysis::zeroPoleGain(const Filter& filter){
+  const std::vector<double> b(filter.GetInputWeights(),
+                              filter.GetInputWeights() +
+                              filter.GetNumInWeights());
+  const std::vector<double> a(filter.GetOutputWeights(),
+                              filter.GetOutputWeights() +
+                              filter.GetNumOutWeights());
+  ZeroPoleGain zpk;
+  zpk.gain = 0.0;
+  for (size_t i=0; i<b.size() && zpk.gain == 0.0; i++){
+    zpk.gain = b[i];
+  }
+  if (zpk.gain != 0.0){
+    polynomialRoots(b, zpk.zeros);
+  }
+  polynomialRoots(a, zpk.poles);
+  return zpk;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief 1 - the largest pole magnitude.
+/// @param filter -- The filter whose weights are used.
+/// @return The stability margin.
+////////////////////////////////////////////////////////////
+double FilterAnalysis::stabilityMargin(const Filter& filter){
+  const std::vector<double> a(filter.GetOutputWeights(),
+                              filter.GetOutputWeights() +
+                              filter.GetNumOutWeights());
+  std::vector<std::complex<double> > poles;
+  polynomialRoots(a, poles);
+  double radius = 0.0;
+  for (size_t p=0; p<poles.size(); p++){
+    radius = std::max(radius, std::abs(poles[p]));
+  }
+  return 1.0 - radius;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filters an impulse with a fresh copy of the
+///        weights.
+/// @param filter   -- The filter whose weights are used.
+/// @param response -- Receives the outputs.
+/// @param length   -- Number of outputs.
+////////////////////////////////////////////////////////////
+void FilterAnalysis::impulseResponse(const Filter& filter, float* response,
+                                     unsigned int length){
+  Filter impulse(std::vector<float>(filter.GetInputWeights(),
+                                    filter.GetInputWeights() +
+                                    filter.GetNumInWeights()),
+                 std::vector<float>(filter.GetOutputWeights(),
+                                    filter.GetOutputWeights() +
+                                    filter.GetNumOutWeights()));
+  for (unsigned int n=0; n<length; n++){
+    response[n] = impulse.filter(n == 0 ? 1.0f : 0.0f);
+  }
+}
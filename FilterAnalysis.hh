@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class computes the frequency response, group
+///          delay, zeros and poles of a filter.
+///
+///////////////////////////////////////////////////////////////
+#ifndef FILTER_ANALYSIS_HH
+#define FILTER_ANALYSIS_HH
+
+#include "Filter.hh"
+
+#include <complex>
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @brief A transfer function factored as gain times the
+///        zeros over the poles, as scipy's tf2zpk returns it.
+///////////////////////////////////////////////////////////////
+struct ZeroPoleGain {
+  ////////////////////////////////////////////////////////////
+  /// @brief Roots of the input weight polynomial.
+  ////////////////////////////////////////////////////////////
+  std::vector<std::complex<double> > zeros;
+  ////////////////////////////////////////////////////////////
+  /// @brief Roots of the output weight polynomial.
+  ////////////////////////////////////////////////////////////
+  std::vector<std::complex<double> > poles;
+  ////////////////////////////////////////////////////////////
+  /// @brief First nonzero input weight over a[0].
+  ////////////////////////////////////////////////////////////
+  double gain;
+};
+
+///////////////////////////////////////////////////////////////
+/// @class FilterAnalysis
+/// @ingroup DSP
+/// @brief The C++ counterpart of the analysis in ZPlane.py and
+///        ChupacabraAnalysis.plotFilterDetails, for checking
+///        filters where Python is not available: frequency
+///        response (scipy's freqz) and group delay
+///        (group_delay) on a fixed grid of frequencies, and
+///        zeros, poles (tf2zpk), stability margin and impulse
+///        response.
+///
+/// The grid and its complex exponentials are computed once
+/// by the c'tor, so one analysis can check any number of
+/// filters, from any number of threads. The responses are
+/// evaluated in double precision with Horner's rule in
+/// \f$ e^{-i\omega} \f$, over a fixed number of grid points at
+/// once so the compiler keeps them in vector registers;
+/// the cost per point is a few multiply-adds per weight.
+/// Zeros and poles are companion matrix eigenvalues, from
+/// polynomialRoots. As in scipy, the zeros and poles are the
+/// roots of b and a as given, without the extra zeros or
+/// poles at the origin a difference in their lengths implies.
+///
+/// @code
+///   FilterAnalysis analysis;  // freqz's 512 point grid
+///   std::vector<std::complex<double> > h(analysis.GetNumPoints());
+///   for (Filter& tuned : filters){
+///     if (FilterAnalysis::stabilityMargin(tuned) < 0.01) { ... }
+///     analysis.frequencyResponse(tuned, &h[0]);
+///   }
+/// @endcode
+///////////////////////////////////////////////////////////////
+class FilterAnalysis {
+
+ public:
+  ////////////////////////////////////////////////////////////
+  /// @brief Grid size of the default c'tor, as freqz.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int DEFAULT_NUM_POINTS = 512;
+  ////////////////////////////////////////////////////////////
+  /// @brief Grid points evaluated together.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int LANES = 8;
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor uses freqz's grid: numPoints
+  ///        frequencies from 0 up to, not including, Nyquist,
+  ///        pi*k/numPoints rad/sample.
+  /// @param numPoints -- Number of frequencies.
+  /// @throws std::invalid_argument if numPoints is zero.
+  ////////////////////////////////////////////////////////////
+  explicit FilterAnalysis(unsigned int numPoints = DEFAULT_NUM_POINTS);
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor uses the given frequencies.
+  /// @param frequencies -- Frequencies in rad/sample.
+  /// @throws std::invalid_argument if there are none or one
+  ///         is not finite.
+  ////////////////////////////////////////////////////////////
+  explicit FilterAnalysis(const std::vector<double>& frequencies);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the FilterAnalysis.
+  ////////////////////////////////////////////////////////////
+  ~FilterAnalysis();
+  ////////////////////////////////////////////////////////////
+  /// @brief Evaluates the transfer function on the grid.
+  /// @param filter   -- The filter whose weights are used.
+  /// @param response -- Receives GetNumPoints() values of
+  ///                    B(e^iw)/A(e^iw).
+  ////////////////////////////////////////////////////////////
+  void frequencyResponse(const Filter& filter,
+                         std::complex<double>* response) const;
+  ////////////////////////////////////////////////////////////
+  /// @brief Evaluates the group delay, -d(phase)/dw, on the
+  ///        grid. Where the input or output weight polynomial
+  ///        vanishes the delay is undefined and reported as
+  ///        0, as scipy does.
+  /// @param filter -- The filter whose weights are used.
+  /// @param delay  -- Receives GetNumPoints() delays in
+  ///                  samples.
+  ////////////////////////////////////////////////////////////
+  void groupDelay(const Filter& filter, double* delay) const;
+  ////////////////////////////////////////////////////////////
+  /// @brief Factors the filter's transfer function.
+  /// @param filter -- The filter whose weights are used.
+  /// @return Its zeros, poles and gain.
+  /// @throws std::runtime_error if the root finder does not
+  ///         converge.
+  ////////////////////////////////////////////////////////////
+  static ZeroPoleGain zeroPoleGain(const Filter& filter);
+  ////////////////////////////////////////////////////////////
+  /// @brief Distance of the outermost pole inside the unit
+  ///        circle: 1 - max |pole|. The filter is stable if
+  ///        it is positive; an FIR filter's margin is 1.
+  /// @param filter -- The filter whose weights are used.
+  /// @return The stability margin.
+  /// @throws std::runtime_error if the root finder does not
+  ///         converge.
+  ////////////////////////////////////////////////////////////
+  static double stabilityMargin(const Filter& filter);
+  ////////////////////////////////////////////////////////////
+  /// @brief Runs a unit impulse through a filter with the
+  ///        same weights and zeroed state; the filter itself
+  ///        is not touched.
+  /// @param filter   -- The filter whose weights are used.
+  /// @param response -- Receives the first length outputs.
+  /// @param length   -- Number of outputs.
+  ////////////////////////////////////////////////////////////
+  static void impulseResponse(const Filter& filter, float* response,
+                              unsigned int length);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the grid size.
+  /// @return Number of frequencies.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetNumPoints(void) const {
+                                  return static_cast<unsigned int>(
+                                      _frequencies.size()); }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the grid.
+  /// @return The frequencies in rad/sample.
+  ////////////////////////////////////////////////////////////
+  inline const std::vector<double>& GetFrequencies(void) const {
+                                  return _frequencies; }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Computes the exponentials of the grid, padded to
+  ///        a multiple of LANES.
+  ////////////////////////////////////////////////////////////
+  void setGrid(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Evaluates sum c[k] z^k, or sum k c[k] z^k if ramp
+  ///        is set, at LANES grid points starting at first.
+  ////////////////////////////////////////////////////////////
+  void horner(const float* weights, unsigned int numWeights, bool ramp,
+              size_t first, double* real, double* imag) const;
+  ////////////////////////////////////////////////////////////
+  /// @brief The frequencies in rad/sample.
+  ////////////////////////////////////////////////////////////
+  std::vector<double> _frequencies;
+  ////////////////////////////////////////////////////////////
+  /// @brief Real and imaginary parts of exp(-i w) for each
+  ///        frequency, padded with zeros to a multiple of
+  ///        LANES.
+  ////////////////////////////////////////////////////////////
+  std::vector<double> _real;
+  std::vector<double> _imag;
+};
+
+#endif  // FILTER_ANALYSIS_HH
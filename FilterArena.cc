@@ -0,0 +1,55 @@
+#include "FilterArena.hh"
+
+#include <new>
+#include <stdexcept>
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor allocates the arena's memory.
+////////////////////////////////////////////////////////////
+FilterArena::FilterArena(size_t capacity) :
+         _memory(new float[capacity]),
+         _capacity(capacity),
+         _used(0),
+         _ownsMemory(true)
+{
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor adopts caller supplied memory.
+////////////////////////////////////////////////////////////
+FilterArena::FilterArena(float* memory, size_t capacity) :
+         _memory(memory),
+         _capacity(capacity),
+         _used(0),
+         _ownsMemory(false)
+{
+  if (memory == NULL && capacity != 0){
+    throw std::invalid_argument("FilterArena memory must not be NULL");
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+FilterArena::~FilterArena() {
+  if (_ownsMemory){
+    delete[] _memory;
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Bumps the used size and zeroes the floats taken.
+/// @param count -- Number of floats.
+/// @return The first of the floats.
+////////////////////////////////////////////////////////////
+float* FilterArena::allocate(size_t count){
+  if (count > _capacity - _used){
+    throw std::bad_alloc();
+  }
+  float* block = _memory + _used;
+  for (size_t i=0; i<count; i++){
+    block[i] = 0.0f;
+  }
+  _used += count;
+  return block;
+}
@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class hands out the weight and delay line
+///          storage of many filters from one contiguous block.
+///
+///////////////////////////////////////////////////////////////
+#ifndef FILTER_ARENA_HH
+#define FILTER_ARENA_HH
+
+#include <cstddef>
+
+///////////////////////////////////////////////////////////////
+/// @class FilterArena
+/// @ingroup DSP
+/// @brief Bump allocator for Filter storage. Each filter built
+///        on the arena takes exactly Filter::StorageSize floats
+///        from the end of the used region, so the weights and
+///        delay lines of filters built one after another are
+///        packed back to back in memory.
+///
+/// Nothing is returned to the arena until it is destroyed;
+/// the arena must outlive every filter built on it. A filter
+/// whose weight counts grow past what it was built with takes
+/// a new block from the same arena and abandons the old one.
+///
+/// @code
+///   FilterArena arena(numFilters*Filter::StorageSize(3, 1));
+///   std::vector<Filter> filters;
+///   filters.reserve(numFilters);
+///   for (unsigned int i=0; i<numFilters; i++){
+///     filters.push_back(Filter(inWeights, outWeights, &arena));
+///   }
+/// @endcode
+///////////////////////////////////////////////////////////////
+class FilterArena {
+
+ public:
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor allocates and owns the arena's
+  ///        memory.
+  /// @param capacity -- Number of floats the arena holds.
+  ////////////////////////////////////////////////////////////
+  explicit FilterArena(size_t capacity);
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor uses caller supplied memory,
+  ///        which must outlive the arena and every filter
+  ///        built on it.
+  /// @param memory   -- The memory.
+  /// @param capacity -- Number of floats at memory.
+  /// @throws std::invalid_argument if memory is NULL and
+  ///         capacity is not zero.
+  ////////////////////////////////////////////////////////////
+  FilterArena(float* memory, size_t capacity);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the FilterArena,
+  ///        freeing the memory if the arena allocated it.
+  ////////////////////////////////////////////////////////////
+  ~FilterArena();
+  FilterArena(const FilterArena&) = delete;
+  FilterArena& operator=(const FilterArena&) = delete;
+  ////////////////////////////////////////////////////////////
+  /// @brief Takes zeroed floats from the arena.
+  /// @param count -- Number of floats.
+  /// @return The first of the floats.
+  /// @throws std::bad_alloc if the arena has too little room
+  ///         left.
+  ////////////////////////////////////////////////////////////
+  float* allocate(size_t count);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the capacity.
+  /// @return Number of floats the arena holds.
+  ////////////////////////////////////////////////////////////
+  inline size_t GetCapacity(void) const { return _capacity; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the used size.
+  /// @return Number of floats handed out so far.
+  ////////////////////////////////////////////////////////////
+  inline size_t GetUsed(void) const { return _used; }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief The arena's memory.
+  ////////////////////////////////////////////////////////////
+  float* _memory;
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of floats at _memory.
+  ////////////////////////////////////////////////////////////
+  size_t _capacity;
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of floats handed out.
+  ////////////////////////////////////////////////////////////
+  size_t _used;
+  ////////////////////////////////////////////////////////////
+  /// @brief True if the arena allocated _memory.
+  ////////////////////////////////////////////////////////////
+  bool _ownsMemory;
+};
+
+#endif  // FILTER_ARENA_HH
@@ -0,0 +1,261 @@
+#include "FilterBank.hh"
+#include "SampleTraits.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FILTER_BANK_X86 1
+#include <immintrin.h>
+#endif
+
+////////////////////////////////////////////////////////////
+/// @brief Number of floats in the widest (AVX2) vector. Rows
+///        are padded to a multiple of this.
+////////////////////////////////////////////////////////////
+static const unsigned int ROW_ALIGNMENT = 8;
+
+////////////////////////////////////////////////////////////
+/// @brief Moves a circular buffer head back one slot, which
+///        is where the next newest row gets written.
+/// @param head -- Current head index.
+/// @param size -- Length of the delay line.
+/// @return The new head index.
+////////////////////////////////////////////////////////////
+static inline unsigned int retreatHead(unsigned int head,
+                                       unsigned int size){
+  return (head == 0 ? size : head) - 1;
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor copies the weights, sizes the delay
+///        line rows and picks the kernel.
+////////////////////////////////////////////////////////////
+FilterBank::FilterBank(unsigned int numChannels,
+                       unsigned int numInWeights, const float* inWeights,
+                       unsigned int numOutWeights, const float* outWeights) :
+         _numChannels(numChannels),
+         _stride((numChannels + ROW_ALIGNMENT - 1)/ROW_ALIGNMENT*ROW_ALIGNMENT),
+         _numInWeights(numInWeights),
+         _numOutWeights(numOutWeights),
+         _inputRows(2*numInWeights*_stride, 0.0f),
+         _inputHead(0),
+         _outputRows(2*numOutWeights*_stride, 0.0f),
+         _outputHead(0),
+         _kernel(SCALAR_KERNEL),
+         _rowKernel(&FilterBank::scalarRows)
+{
+  if (numChannels == 0 || numInWeights == 0 || numOutWeights == 0){
+    throw std::invalid_argument(
+        "FilterBank needs at least one channel, input and output weight");
+  }
+  /// Fold a[0] into the weights so the kernels never divide.
+  std::vector<float> inputWeights(numInWeights);
+  std::vector<float> outputWeights(numOutWeights);
+  normalizeWeights<SampleTraits<float> >(numInWeights, inWeights,
+                                         numOutWeights, outWeights,
+                                         inputWeights.data(),
+                                         outputWeights.data());
+  _inputWeights.swap(inputWeights);
+  _outputWeights.swap(outputWeights);
+  if (!SetKernel(AVX2_KERNEL)){
+    SetKernel(SSE_KERNEL);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+FilterBank::~FilterBank() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Zeroes every delay line row.
+////////////////////////////////////////////////////////////
+void FilterBank::reset(void){
+  std::fill(_inputRows.begin(), _inputRows.end(), 0.0f);
+  std::fill(_outputRows.begin(), _outputRows.end(), 0.0f);
+  _inputHead = 0;
+  _outputHead = 0;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Checks the CPU for the instructions a kernel needs.
+/// @param kernel -- The kernel to check.
+/// @return true if the kernel is supported.
+////////////////////////////////////////////////////////////
+bool FilterBank::IsKernelSupported(Kernel kernel){
+  switch (kernel){
+    case SCALAR_KERNEL:
+      return true;
+#ifdef FILTER_BANK_X86
+    case SSE_KERNEL:
+      return __builtin_cpu_supports("sse");
+    case AVX2_KERNEL:
+      return __builtin_cpu_supports("avx2");
+#endif
+    default:
+      return false;
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Switches kernels if the CPU supports the new one.
+/// @param kernel -- The kernel to use.
+/// @return false if the kernel is not supported.
+////////////////////////////////////////////////////////////
+bool FilterBank::SetKernel(Kernel kernel){
+  if (!IsKernelSupported(kernel)){
+    return false;
+  }
+  _kernel = kernel;
+  switch (kernel){
+    case SSE_KERNEL:  _rowKernel = &FilterBank::sseRows;    break;
+    case AVX2_KERNEL: _rowKernel = &FilterBank::avx2Rows;   break;
+    default:          _rowKernel = &FilterBank::scalarRows; break;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filters one interleaved frame.
+/// @param input  -- numChannels input samples.
+/// @param output -- numChannels filter outputs.
+////////////////////////////////////////////////////////////
+void FilterBank::filterFrame(const float* input, float* output){
+  filterFrames(input, output, 1);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filters a block of interleaved frames. Each frame
+///        is copied into both mirrored input rows, the kernel
+///        computes the new output row, and that row is
+///        mirrored and copied out to the caller.
+/// @param input     -- numFrames*numChannels input samples.
+/// @param output    -- numFrames*numChannels outputs.
+/// @param numFrames -- Number of frames in the block.
+////////////////////////////////////////////////////////////
+void FilterBank::filterFrames(const float* input, float* output,
+                              unsigned int numFrames){
+  const size_t frameBytes = _numChannels*sizeof(float);
+  float* inputRows = &_inputRows[0];
+  float* outputRows = &_outputRows[0];
+  for (unsigned int n=0; n<numFrames; n++){
+    _inputHead = retreatHead(_inputHead, _numInWeights);
+    float* inputRow = inputRows + _inputHead*_stride;
+    std::memcpy(inputRow, input, frameBytes);
+    std::memcpy(inputRow + _numInWeights*_stride, input, frameBytes);
+    _outputHead = retreatHead(_outputHead, _numOutWeights);
+    float* outputRow = outputRows + _outputHead*_stride;
+    _rowKernel(*this, inputRow, outputRow);
+    std::memcpy(outputRow + _numOutWeights*_stride, outputRow,
+                _stride*sizeof(float));
+    std::memcpy(output, outputRow, frameBytes);
+    input += _numChannels;
+    output += _numChannels;
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Portable kernel, one channel at a time.
+/// @param bank       -- The filter bank.
+/// @param inputRows  -- Newest input row; older rows follow.
+/// @param outputRows -- Row receiving the new outputs; the
+///                      previous outputs follow.
+////////////////////////////////////////////////////////////
+void FilterBank::scalarRows(const FilterBank& bank,
+                            const float* inputRows, float* outputRows){
+  const unsigned int stride = bank._stride;
+  const float* b = &bank._inputWeights[0];
+  const float* a = &bank._outputWeights[0];
+  for (unsigned int c=0; c<bank._numChannels; c++){
+    float outputContribution = 0.0;
+    float inputContribution = 0.0;
+    for (unsigned int i=0; i<bank._numInWeights; i++){
+      inputContribution += b[i]*inputRows[i*stride + c];
+    }
+    for (unsigned int i=1; i<bank._numOutWeights; i++){
+      outputContribution += a[i]*outputRows[i*stride + c];
+    }
+    outputRows[c] = inputContribution - outputContribution;
+  }
+}
+
+#ifdef FILTER_BANK_X86
+////////////////////////////////////////////////////////////
+/// @brief SSE kernel, four channels per vector.
+/// @param bank       -- The filter bank.
+/// @param inputRows  -- Newest input row; older rows follow.
+/// @param outputRows -- Row receiving the new outputs; the
+///                      previous outputs follow.
+////////////////////////////////////////////////////////////
+__attribute__((target("sse")))
+void FilterBank::sseRows(const FilterBank& bank,
+                         const float* inputRows, float* outputRows){
+  const unsigned int stride = bank._stride;
+  const float* b = &bank._inputWeights[0];
+  const float* a = &bank._outputWeights[0];
+  for (unsigned int c=0; c<stride; c+=4){
+    __m128 outputContribution = _mm_setzero_ps();
+    __m128 inputContribution = _mm_setzero_ps();
+    for (unsigned int i=0; i<bank._numInWeights; i++){
+      inputContribution = _mm_add_ps(inputContribution,
+          _mm_mul_ps(_mm_set1_ps(b[i]),
+                     _mm_loadu_ps(inputRows + i*stride + c)));
+    }
+    for (unsigned int i=1; i<bank._numOutWeights; i++){
+      outputContribution = _mm_add_ps(outputContribution,
+          _mm_mul_ps(_mm_set1_ps(a[i]),
+                     _mm_loadu_ps(outputRows + i*stride + c)));
+    }
+    _mm_storeu_ps(outputRows + c,
+                  _mm_sub_ps(inputContribution, outputContribution));
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief AVX2 kernel, eight channels per vector.
+/// @param bank       -- The filter bank.
+/// @param inputRows  -- Newest input row; older rows follow.
+/// @param outputRows -- Row receiving the new outputs; the
+///                      previous outputs follow.
+////////////////////////////////////////////////////////////
+__attribute__((target("avx2")))
+void FilterBank::avx2Rows(const FilterBank& bank,
+                          const float* inputRows, float* outputRows){
+  const unsigned int stride = bank._stride;
+  const float* b = &bank._inputWeights[0];
+  const float* a = &bank._outputWeights[0];
+  for (unsigned int c=0; c<stride; c+=8){
+    __m256 outputContribution = _mm256_setzero_ps();
+    __m256 inputContribution = _mm256_setzero_ps();
+    for (unsigned int i=0; i<bank._numInWeights; i++){
+      inputContribution = _mm256_add_ps(inputContribution,
+          _mm256_mul_ps(_mm256_set1_ps(b[i]),
+                        _mm256_loadu_ps(inputRows + i*stride + c)));
+    }
+    for (unsigned int i=1; i<bank._numOutWeights; i++){
+      outputContribution = _mm256_add_ps(outputContribution,
+          _mm256_mul_ps(_mm256_set1_ps(a[i]),
+                        _mm256_loadu_ps(outputRows + i*stride + c)));
+    }
+    _mm256_storeu_ps(outputRows + c,
+                     _mm256_sub_ps(inputContribution, outputContribution));
+  }
+}
+#else
+////////////////////////////////////////////////////////////
+/// @brief Vector kernels are never selected off x86; these
+///        only satisfy the dispatch table.
+////////////////////////////////////////////////////////////
+void FilterBank::sseRows(const FilterBank& bank,
+                         const float* inputRows, float* outputRows){
+  scalarRows(bank, inputRows, outputRows);
+}
+void FilterBank::avx2Rows(const FilterBank& bank,
+                          const float* inputRows, float* outputRows){
+  scalarRows(bank, inputRows, outputRows);
+}
+#endif
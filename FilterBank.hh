@@ -0,0 +1,173 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class defines a bank of identical digital
+///          filters running side by side over many channels.
+///          It uses the same difference equation as the
+///          generic Filter base class.
+///
+///////////////////////////////////////////////////////////////
+#ifndef FILTER_BANK_HH
+#define FILTER_BANK_HH
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @class FilterBank
+/// @ingroup DSP
+/// @brief Runs one set of filter weights over N channels at
+///        once. The delay lines are stored struct-of-arrays:
+///        each delay slot is a row holding that slot for every
+///        channel, so one row is a contiguous vector that the
+///        SSE and AVX2 kernels process 4 or 8 channels at a
+///        time. The rows form the same mirrored circular
+///        buffer that Filter uses for its delay lines.
+///
+/// Input and output frames are interleaved: frame f holds
+/// channel c at index f*numChannels + c. Each channel's output
+/// matches an independent Filter with the same weights.
+///////////////////////////////////////////////////////////////
+class FilterBank {
+
+ public:
+  ////////////////////////////////////////////////////////////
+  /// @brief The vector kernels a filter bank can run with.
+  ////////////////////////////////////////////////////////////
+  enum Kernel {
+    SCALAR_KERNEL,
+    SSE_KERNEL,
+    AVX2_KERNEL
+  };
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor builds the filter bank with
+  ///        zeroed delay lines, and selects the widest
+  ///        kernel the CPU supports.
+  /// @param numChannels   -- Number of channels in a frame.
+  /// @param numInWeights  -- Number of input weights (b).
+  /// @param inWeights     -- The input weights.
+  /// @param numOutWeights -- Number of output weights (a).
+  /// @param outWeights    -- The output weights.
+  /// @throws std::invalid_argument if there are no channels,
+  ///         no input or output weights, a[0] is zero or not
+  ///         finite, or a weight is not finite after
+  ///         normalizing by a[0].
+  ////////////////////////////////////////////////////////////
+  FilterBank(unsigned int numChannels,
+             unsigned int numInWeights, const float* inWeights,
+             unsigned int numOutWeights, const float* outWeights);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the FilterBank
+  ////////////////////////////////////////////////////////////
+  ~FilterBank();
+  ////////////////////////////////////////////////////////////
+  /// @brief Filters one interleaved frame, one sample for
+  ///        every channel.
+  /// @param input  -- numChannels input samples.
+  /// @param output -- numChannels filter outputs.
+  ////////////////////////////////////////////////////////////
+  void filterFrame(const float* input, float* output);
+  ////////////////////////////////////////////////////////////
+  /// @brief Filters a block of interleaved frames.
+  /// @param input     -- numFrames*numChannels input samples.
+  /// @param output    -- numFrames*numChannels outputs.
+  /// @param numFrames -- Number of frames in the block.
+  ////////////////////////////////////////////////////////////
+  void filterFrames(const float* input, float* output,
+                    unsigned int numFrames);
+  ////////////////////////////////////////////////////////////
+  /// @brief Zeroes the delay lines of every channel.
+  ////////////////////////////////////////////////////////////
+  void reset(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Selects the kernel used by the filter routines.
+  /// @param kernel -- The kernel to use.
+  /// @return false if the CPU does not support the kernel,
+  ///         in which case the current kernel is kept.
+  ////////////////////////////////////////////////////////////
+  bool SetKernel(Kernel kernel);
+  ////////////////////////////////////////////////////////////
+  /// @brief Reports whether the CPU can run a given kernel.
+  /// @param kernel -- The kernel to check.
+  /// @return true if the kernel is supported.
+  ////////////////////////////////////////////////////////////
+  static bool IsKernelSupported(Kernel kernel);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the kernel in use.
+  /// @return The active kernel.
+  ////////////////////////////////////////////////////////////
+  inline Kernel GetKernel(void) const { return _kernel; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the channel count.
+  /// @return The number of channels in a frame.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetNumChannels(void) const {
+                                  return _numChannels; }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Signature of a kernel computing one output row
+  ///        from the delay line rows.
+  ////////////////////////////////////////////////////////////
+  typedef void (*RowKernel)(const FilterBank& bank,
+                            const float* inputRows,
+                            float* outputRows);
+  ////////////////////////////////////////////////////////////
+  /// @brief The per kernel row routines.
+  ////////////////////////////////////////////////////////////
+  static void scalarRows(const FilterBank& bank,
+                         const float* inputRows, float* outputRows);
+  static void sseRows(const FilterBank& bank,
+                      const float* inputRows, float* outputRows);
+  static void avx2Rows(const FilterBank& bank,
+                       const float* inputRows, float* outputRows);
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of channels in a frame.
+  ////////////////////////////////////////////////////////////
+  unsigned int _numChannels;
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of one delay line row. The channel count
+  ///        rounded up to a whole number of AVX2 vectors.
+  ////////////////////////////////////////////////////////////
+  unsigned int _stride;
+  ////////////////////////////////////////////////////////////
+  /// @brief The number of input weights.
+  ////////////////////////////////////////////////////////////
+  unsigned int _numInWeights;
+  ////////////////////////////////////////////////////////////
+  /// @brief The number of output weights.
+  ////////////////////////////////////////////////////////////
+  unsigned int _numOutWeights;
+  ////////////////////////////////////////////////////////////
+  /// @brief Weights applied to the input signal (b), divided
+  ///        by a[0].
+  ////////////////////////////////////////////////////////////
+  std::vector<float> _inputWeights;
+  ////////////////////////////////////////////////////////////
+  /// @brief Weights applied to the output signal (a), divided
+  ///        by a[0].
+  ////////////////////////////////////////////////////////////
+  std::vector<float> _outputWeights;
+  ////////////////////////////////////////////////////////////
+  /// @brief Input delay line, 2*_numInWeights rows of
+  ///        _stride channels.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> _inputRows;
+  ////////////////////////////////////////////////////////////
+  /// @brief Row index of the newest input frame.
+  ////////////////////////////////////////////////////////////
+  unsigned int _inputHead;
+  ////////////////////////////////////////////////////////////
+  /// @brief Output delay line, 2*_numOutWeights rows of
+  ///        _stride channels.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> _outputRows;
+  ////////////////////////////////////////////////////////////
+  /// @brief Row index of the newest output frame.
+  ////////////////////////////////////////////////////////////
+  unsigned int _outputHead;
+  ////////////////////////////////////////////////////////////
+  /// @brief The kernel in use and its row routine.
+  ////////////////////////////////////////////////////////////
+  Kernel _kernel;
+  RowKernel _rowKernel;
+};
+
+#endif  // FILTER_BANK_HH
@@ -0,0 +1,141 @@
+#include "FilterChain.hh"
+#include "Polynomial.hh"
+
+#include <cstring>
+
+////////////////////////////////////////////////////////////
+/// @brief Reads a Filter's weights, if the filter says they
+///        are its difference equation (see
+///        Filter::IsDifferenceEquation).
+////////////////////////////////////////////////////////////
+bool linearStageWeights(Filter* stage, std::vector<double>& b,
+                        std::vector<double>& a){
+  if (!stage->IsDifferenceEquation()){
+    return false;
+  }
+  b.assign(stage->GetInputWeights(),
+           stage->GetInputWeights() + stage->GetNumInWeights());
+  a.assign(stage->GetOutputWeights(),
+           stage->GetOutputWeights() + stage->GetNumOutWeights());
+  return true;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Multiplies out a cascade's sections.
+////////////////////////////////////////////////////////////
+bool linearStageWeights(BiquadCascade* stage, std::vector<double>& b,
+                        std::vector<double>& a){
+  b.assign(1, 1.0);
+  a.assign(1, 1.0);
+  for (unsigned int s=0; s<stage->GetNumSections(); s++){
+    const BiquadSection& w = stage->GetSections()[s];
+    const double sectionB[3] = {w.b0, w.b1, w.b2};
+    const double sectionA[3] = {1.0, w.a1, w.a2};
+    b = polynomialMultiply(b, std::vector<double>(sectionB, sectionB + 3));
+    a = polynomialMultiply(a, std::vector<double>(sectionA, sectionA + 3));
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Multiplies the stage transfer functions together,
+///        leaving the product in the first entry.
+////////////////////////////////////////////////////////////
+void multiplyStageWeights(std::vector<std::vector<double> >& b,
+                          std::vector<std::vector<double> >& a){
+  std::vector<double> productB(1, 1.0);
+  std::vector<double> productA(1, 1.0);
+  for (size_t s=0; s<b.size(); s++){
+    productB = polynomialMultiply(productB, b[s]);
+    productA = polynomialMultiply(productA, a[s]);
+  }
+  b.assign(1, productB);
+  a.assign(1, productA);
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs an empty chain.
+////////////////////////////////////////////////////////////
+FilterChain::FilterChain() :
+         Filter(),
+         _stages()
+{
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+FilterChain::~FilterChain() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Runs one sample through every stage.
+/// @param inputValue input value.
+/// @return Output of the last stage.
+////////////////////////////////////////////////////////////
+float FilterChain::filter(float inputValue){
+  float value = inputValue;
+  for (size_t s=0; s<_stages.size(); s++){
+    value = _stages[s].sample(_stages[s].stage, value);
+  }
+  return value;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Runs the block through the chain one tile at a
+///        time. The first stage reads the caller's input and
+///        the last writes the caller's output; every stage in
+///        between works in place on the local tile.
+/// @param input      -- Input samples, oldest first.
+/// @param output     -- Destination for the chain outputs.
+/// @param numSamples -- Number of samples in the block.
+////////////////////////////////////////////////////////////
+void FilterChain::filterBlock(const float* input, float* output,
+                              unsigned int numSamples){
+  if (_stages.empty()){
+    if (input != output){
+      std::memmove(output, input, numSamples*sizeof(float));
+    }
+    return;
+  }
+  float tile[TILE_SIZE];
+  const size_t last = _stages.size() - 1;
+  for (unsigned int n=0; n<numSamples; n+=TILE_SIZE){
+    const unsigned int count = (numSamples - n < TILE_SIZE) ?
+                               numSamples - n : TILE_SIZE;
+    const float* source = input + n;
+    for (size_t s=0; s<=last; s++){
+      float* dest = (s == last) ? output + n : tile;
+      _stages[s].block(_stages[s].stage, source, dest, count);
+      source = dest;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Multiplies the stages' transfer functions into a
+///        single Filter.
+/// @return The equivalent filter.
+////////////////////////////////////////////////////////////
+Filter FilterChain::collapse(void) const {
+  std::vector<std::vector<double> > b(_stages.size()), a(_stages.size());
+  for (size_t s=0; s<_stages.size(); s++){
+    if (!_stages[s].weights(_stages[s].stage, b[s], a[s])){
+      throw std::logic_error("FilterChain stage has no known transfer "
+                             "function to collapse");
+    }
+  }
+  multiplyStageWeights(b, a);
+  return Filter(std::vector<float>(b[0].begin(), b[0].end()),
+                std::vector<float>(a[0].begin(), a[0].end()));
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Refuses weights; they belong to the stages.
+////////////////////////////////////////////////////////////
+void FilterChain::SetWeights(unsigned int, const float*, unsigned int,
+                             const float*){
+  throw std::invalid_argument("FilterChain has no weights of its own; set "
+                              "them on its stages");
+}
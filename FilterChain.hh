@@ -0,0 +1,387 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup These classes run several filters in series, one
+///          after another, as a single filter.
+///
+///////////////////////////////////////////////////////////////
+#ifndef FILTER_CHAIN_HH
+#define FILTER_CHAIN_HH
+
+#include "BiquadCascade.hh"
+#include "Filter.hh"
+#include "StaticFilter.hh"
+
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+////////////////////////////////////////////////////////////
+/// @brief Reads the transfer function of a linear stage, as
+///        numerator (b) and denominator (a) coefficients with
+///        a[0] equal to one. Used to collapse chains. These
+///        overloads cover Filter objects whose
+///        IsDifferenceEquation() is true, BiquadCascade and
+///        floating point StaticFilters, including classes
+///        derived from the last two; anything else, including
+///        other classes derived from Filter, which may replace
+///        its filter routine, has no known transfer function.
+/// @param stage -- The stage.
+/// @param b     -- Receives the numerator.
+/// @param a     -- Receives the denominator.
+/// @return false if the stage's transfer function is not known.
+////////////////////////////////////////////////////////////
+bool linearStageWeights(Filter* stage, std::vector<double>& b,
+                        std::vector<double>& a);
+bool linearStageWeights(BiquadCascade* stage, std::vector<double>& b,
+                        std::vector<double>& a);
+template <unsigned int NB, unsigned int NA, typename T>
+typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+linearStageWeights(StaticFilter<NB, NA, T>* stage, std::vector<double>& b,
+                   std::vector<double>& a){
+  b.assign(stage->GetInputWeights(), stage->GetInputWeights() + NB);
+  a.assign(stage->GetOutputWeights(), stage->GetOutputWeights() + NA);
+  return true;
+}
+inline bool linearStageWeights(const void*, std::vector<double>&,
+                               std::vector<double>&){
+  return false;
+}
+
+///////////////////////////////////////////////////////////////
+/// @class FilterChain
+/// @ingroup DSP
+/// @brief Runs a sequence of filters in series as one Filter,
+///        so a chain can go wherever a Filter can (FilterWorker,
+///        FilterScheduler, another chain). Stages may be any
+///        type with the filter() and filterBlock() routines of
+///        Filter: Filter and its derived classes, StaticFilter,
+///        BiquadCascade. The chain does not own its stages,
+///        which must outlive it.
+///
+/// filterBlock() is fused: the block is cut into tiles of
+/// TILE_SIZE samples and each tile runs through every stage
+/// before the next tile starts, so the intermediate signals
+/// live in one small local buffer that stays in L1 instead of
+/// making a round trip through memory per stage. Each
+/// boundary costs one indirect call per tile rather than one
+/// virtual call per sample.
+///
+/// Only the filtering routines of Filter apply to a chain. It
+/// has no weights or delay lines of its own, so the weight,
+/// buffer and state members of Filter are private here and
+/// SetWeights throws; through a Filter reference they see an
+/// empty filter. Set weights and save state on the stages.
+///
+/// When every stage is linear with known weights the chain
+/// can instead be collapsed into a single equivalent Filter:
+///
+/// @code
+///   FilterChain chain;
+///   chain.addStage(lowPass);
+///   chain.addStage(movingAverage);
+///   chain.filterBlock(input, output, numSamples);
+///   Filter single = chain.collapse();
+/// @endcode
+///////////////////////////////////////////////////////////////
+class FilterChain : public Filter {
+
+ public:
+  ////////////////////////////////////////////////////////////
+  /// @brief Samples per tile in filterBlock().
+  ////////////////////////////////////////////////////////////
+  static const unsigned int TILE_SIZE = 64;
+  //////////////////////////////////////////////////////////
+  /// @brief The default c'tor constructs an empty chain,
+  ///        which passes its input through unchanged.
+  ////////////////////////////////////////////////////////////
+  FilterChain();
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the FilterChain.
+  ///        The stages are not destroyed.
+  ////////////////////////////////////////////////////////////
+  virtual ~FilterChain();
+  FilterChain(const FilterChain&) = delete;
+  FilterChain& operator=(const FilterChain&) = delete;
+  ////////////////////////////////////////////////////////////
+  /// @brief Appends a stage to the end of the chain.
+  /// @param stage -- The stage. Not owned; it must outlive
+  ///                 the chain, and must not be the chain.
+  ////////////////////////////////////////////////////////////
+  template <typename Stage>
+  void addStage(Stage& stage){
+    Entry entry;
+    entry.stage = &stage;
+    entry.sample = &sampleThunk<Stage>;
+    entry.block = &blockThunk<Stage>;
+    entry.weights = &weightsThunk<Stage>;
+    _stages.push_back(entry);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Runs one sample through every stage.
+  /// @param inputValue input value.
+  /// @return Output of the last stage.
+  ////////////////////////////////////////////////////////////
+  virtual float filter(float inputValue);
+  ////////////////////////////////////////////////////////////
+  /// @brief Block filter routine, fused tile by tile as
+  ///        described above. Outputs are bit-identical to
+  ///        calling filter() once per sample.
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for the chain outputs.
+  ///                      May alias input.
+  /// @param numSamples -- Number of samples in the block.
+  ////////////////////////////////////////////////////////////
+  virtual void filterBlock(const float* input, float* output,
+                           unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief Builds one Filter with the transfer function of
+  ///        the whole chain, the product of the stages'
+  ///        transfer functions. The new filter starts with
+  ///        zeroed state. Its output differs from the chain's
+  ///        by rounding only, but a high order direct form
+  ///        filter is less well conditioned than the cascade
+  ///        it replaces; prefer collapsing short, low order
+  ///        chains.
+  /// @return The equivalent filter.
+  /// @throws std::logic_error if a stage's transfer function
+  ///         is not known (see linearStageWeights).
+  ////////////////////////////////////////////////////////////
+  Filter collapse(void) const;
+  ////////////////////////////////////////////////////////////
+  /// @brief A chain has no weights of its own.
+  /// @throws std::invalid_argument always.
+  ////////////////////////////////////////////////////////////
+  virtual void SetWeights(unsigned int numInWeights, const float* inWeights,
+                          unsigned int numOutWeights,
+                          const float* outWeights);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the stage count.
+  /// @return The number of stages.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetNumStages(void) const {
+                 return static_cast<unsigned int>(_stages.size()); }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Members of Filter that describe its own weights
+  ///        and delay lines, which a chain does not have.
+  ////////////////////////////////////////////////////////////
+  using Filter::GetCurrentInputBuffer;
+  using Filter::GetCurrentOutputBuffer;
+  using Filter::GetInputBufferSnapshot;
+  using Filter::GetOutputBufferSnapshot;
+  using Filter::RestoreBufferSnapshot;
+  using Filter::SetSteadyState;
+  using Filter::SaveState;
+  using Filter::RestoreState;
+  using Filter::GetInputWeights;
+  using Filter::GetOutputWeights;
+  using Filter::GetNumInWeights;
+  using Filter::GetNumOutWeights;
+  ////////////////////////////////////////////////////////////
+  /// @brief One stage with its type erased: the object and
+  ///        routines that call into it with its real type.
+  ////////////////////////////////////////////////////////////
+  struct Entry {
+    void* stage;
+    float (*sample)(void* stage, float inputValue);
+    void (*block)(void* stage, const float* input, float* output,
+                  unsigned int numSamples);
+    bool (*weights)(void* stage, std::vector<double>& b,
+                    std::vector<double>& a);
+  };
+  template <typename Stage>
+  static float sampleThunk(void* stage, float inputValue){
+    return static_cast<Stage*>(stage)->filter(inputValue);
+  }
+  template <typename Stage>
+  static void blockThunk(void* stage, const float* input, float* output,
+                         unsigned int numSamples){
+    static_cast<Stage*>(stage)->filterBlock(input, output, numSamples);
+  }
+  template <typename Stage>
+  static bool weightsThunk(void* stage, std::vector<double>& b,
+                           std::vector<double>& a){
+    return linearStageWeights(static_cast<Stage*>(stage), b, a);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief The stages, in the order they are applied.
+  ////////////////////////////////////////////////////////////
+  std::vector<Entry> _stages;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Multiplies the transfer functions of a list of
+///        stages. Shared by FilterChain and StaticFilterChain.
+/// @param b -- Stage numerators, replaced by the one
+///             numerator of the product.
+/// @param a -- Stage denominators, replaced by the one
+///             denominator of the product.
+////////////////////////////////////////////////////////////
+void multiplyStageWeights(std::vector<std::vector<double> >& b,
+                          std::vector<std::vector<double> >& a);
+
+////////////////////////////////////////////////////////////
+/// @brief Sum of a list of weight counts; the product of
+///        filters with these counts has the sum less one per
+///        extra filter.
+////////////////////////////////////////////////////////////
+template <unsigned int... Counts>
+constexpr unsigned int chainWeightCount(void){
+  const unsigned int counts[] = {Counts...};
+  unsigned int total = 0;
+  for (unsigned int i=0; i<sizeof...(Counts); i++){
+    total += counts[i];
+  }
+  return total;
+}
+
+///////////////////////////////////////////////////////////////
+/// @class StaticFilterChain
+/// @ingroup DSP
+/// @brief Compile time counterpart of FilterChain. The stages
+///        are held by value and their types are known, so
+///        every call between stages is direct and can be
+///        inlined; with StaticFilter stages filter() compiles
+///        to one straight line of code for the whole chain.
+///        filterBlock() is tiled like FilterChain's, letting
+///        each stage keep its state in registers for a tile.
+///
+/// @code
+///   StaticFilterChain<StaticButterworthLowPass3rdOrder,
+///                     StaticMovingAvg3rdOrder> smoother;
+///   smoother.filterBlock(input, output, numSamples);
+///   StaticFilter<5, 3> single = smoother.collapse();
+/// @endcode
+///////////////////////////////////////////////////////////////
+template <typename... Stages>
+class StaticFilterChain {
+  static_assert(sizeof...(Stages) > 0,
+                "StaticFilterChain needs at least one stage");
+
+ public:
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of stages.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int NumStages = sizeof...(Stages);
+  ////////////////////////////////////////////////////////////
+  /// @brief Samples per tile in filterBlock().
+  ////////////////////////////////////////////////////////////
+  static const unsigned int TILE_SIZE = 64;
+  //////////////////////////////////////////////////////////
+  /// @brief The default c'tor default constructs each stage.
+  ////////////////////////////////////////////////////////////
+  StaticFilterChain() : _stages() {}
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor copies in each stage.
+  /// @param stages -- The stages, in the order applied.
+  ////////////////////////////////////////////////////////////
+  explicit StaticFilterChain(const Stages&... stages) :
+           _stages(stages...) {}
+  ////////////////////////////////////////////////////////////
+  /// @brief Runs one sample through every stage.
+  /// @param inputValue input value.
+  /// @return Output of the last stage.
+  ////////////////////////////////////////////////////////////
+  inline float filter(float inputValue){
+    return filterFrom(inputValue, Index<0>());
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Block filter routine. Outputs are bit-identical
+  ///        to calling filter() once per sample.
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for the chain outputs.
+  ///                      May alias input.
+  /// @param numSamples -- Number of samples in the block.
+  ////////////////////////////////////////////////////////////
+  void filterBlock(const float* input, float* output,
+                   unsigned int numSamples){
+    float tile[TILE_SIZE];
+    for (unsigned int n=0; n<numSamples; n+=TILE_SIZE){
+      const unsigned int count = (numSamples - n < TILE_SIZE) ?
+                                 numSamples - n : TILE_SIZE;
+      blockFrom(input + n, tile, output + n, count, Index<0>());
+    }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Resets every stage.
+  ////////////////////////////////////////////////////////////
+  void reset(void){
+    resetFrom(Index<0>());
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Builds one StaticFilter with the transfer function
+  ///        of the whole chain, with zeroed state. See
+  ///        FilterChain::collapse.
+  /// @return The equivalent filter.
+  /// @throws std::logic_error if a stage's transfer function
+  ///         is not known (see linearStageWeights).
+  ////////////////////////////////////////////////////////////
+  StaticFilter<chainWeightCount<Stages::NumInWeights...>() - (NumStages - 1),
+               chainWeightCount<Stages::NumOutWeights...>() - (NumStages - 1)>
+  collapse(void){
+    std::vector<std::vector<double> > b(NumStages), a(NumStages);
+    weightsFrom(b, a, Index<0>());
+    multiplyStageWeights(b, a);
+    float inWeights[chainWeightCount<Stages::NumInWeights...>()];
+    float outWeights[chainWeightCount<Stages::NumOutWeights...>()];
+    for (size_t i=0; i<b[0].size(); i++){
+      inWeights[i] = static_cast<float>(b[0][i]);
+    }
+    for (size_t i=0; i<a[0].size(); i++){
+      outWeights[i] = static_cast<float>(a[0][i]);
+    }
+    return StaticFilter<
+        chainWeightCount<Stages::NumInWeights...>() - (NumStages - 1),
+        chainWeightCount<Stages::NumOutWeights...>() - (NumStages - 1)>(
+            inWeights, outWeights);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get one stage.
+  /// @return Stage I.
+  ////////////////////////////////////////////////////////////
+  template <unsigned int I>
+  inline typename std::tuple_element<I, std::tuple<Stages...> >::type&
+  GetStage(void){ return std::get<I>(_stages); }
+
+ private:
+  template <unsigned int I>
+  using Index = std::integral_constant<unsigned int, I>;
+  typedef Index<sizeof...(Stages)> End;
+  template <unsigned int I>
+  inline float filterFrom(float value, Index<I>){
+    return filterFrom(std::get<I>(_stages).filter(value), Index<I + 1>());
+  }
+  inline float filterFrom(float value, End){ return value; }
+  template <unsigned int I>
+  inline void blockFrom(const float* source, float* tile, float* output,
+                        unsigned int count, Index<I>){
+    float* dest = (I + 1 == NumStages) ? output : tile;
+    std::get<I>(_stages).filterBlock(source, dest, count);
+    blockFrom(dest, tile, output, count, Index<I + 1>());
+  }
+  inline void blockFrom(const float*, float*, float*, unsigned int, End){}
+  template <unsigned int I>
+  inline void resetFrom(Index<I>){
+    std::get<I>(_stages).reset();
+    resetFrom(Index<I + 1>());
+  }
+  inline void resetFrom(End){}
+  template <unsigned int I>
+  void weightsFrom(std::vector<std::vector<double> >& b,
+                   std::vector<std::vector<double> >& a, Index<I>){
+    if (!linearStageWeights(&std::get<I>(_stages), b[I], a[I])){
+      throw std::logic_error("StaticFilterChain stage has no known "
+                             "transfer function to collapse");
+    }
+    weightsFrom(b, a, Index<I + 1>());
+  }
+  void weightsFrom(std::vector<std::vector<double> >&,
+                   std::vector<std::vector<double> >&, End){}
+  ////////////////////////////////////////////////////////////
+  /// @brief The stages, in the order they are applied.
+  ////////////////////////////////////////////////////////////
+  std::tuple<Stages...> _stages;
+};
+
+#endif  // FILTER_CHAIN_HH
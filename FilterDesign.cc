@@ -0,0 +1,170 @@
+#include "FilterDesign.hh"
+#include "Polynomial.hh"
+
+#include <cmath>
+
+typedef std::complex<double> Complex;
+
+////////////////////////////////////////////////////////////
+/// @brief Product of (scale - root) over a set of roots,
+///        used for the gain corrections of each transform.
+////////////////////////////////////////////////////////////
+static Complex productOfDifferences(double scale,
+                                    const std::vector<Complex>& roots){
+  Complex product(1.0, 0.0);
+  for (size_t i=0; i<roots.size(); i++){
+    product *= scale - roots[i];
+  }
+  return product;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Analog Butterworth prototype with unit cutoff:
+///        poles evenly spaced on the left half unit circle.
+////////////////////////////////////////////////////////////
+static void butterworthPrototype(unsigned int order,
+                                 std::vector<Complex>& poles,
+                                 double& gain){
+  for (unsigned int i=0; i<order; i++){
+    const double m = -static_cast<double>(order) + 1.0 + 2.0*i;
+    poles.push_back(-std::exp(Complex(0.0, M_PI*m/(2.0*order))));
+  }
+  gain = 1.0;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Analog Chebyshev type I prototype with unit pass
+///        band edge: poles on an ellipse set by the ripple.
+////////////////////////////////////////////////////////////
+static void chebyshev1Prototype(unsigned int order, double rippleDb,
+                                std::vector<Complex>& poles,
+                                double& gain){
+  const double eps = std::sqrt(std::pow(10.0, 0.1*rippleDb) - 1.0);
+  const double mu = std::asinh(1.0/eps)/order;
+  Complex product(1.0, 0.0);
+  for (unsigned int i=0; i<order; i++){
+    const double m = -static_cast<double>(order) + 1.0 + 2.0*i;
+    const double theta = M_PI*m/(2.0*order);
+    const Complex pole = -std::sinh(Complex(mu, theta));
+    poles.push_back(pole);
+    product *= -pole;
+  }
+  gain = product.real();
+  if (order % 2 == 0){
+    gain /= std::sqrt(1.0 + eps*eps);
+  }
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor runs the design.
+////////////////////////////////////////////////////////////
+FilterDesign::FilterDesign(const FilterSpec& spec) :
+         _zeros(),
+         _poles(),
+         _gain(1.0)
+{
+  const double nyquist = 0.5*spec.sampleRate;
+  if (spec.order == 0){
+    throw std::invalid_argument("FilterDesign order must be positive");
+  }
+  if (!(spec.cutoff > 0.0) || !(spec.cutoff < nyquist)){
+    throw std::invalid_argument("FilterDesign cutoff must be between 0 and "
+                                "the Nyquist rate");
+  }
+  if (spec.band == BAND_PASS &&
+      (!(spec.upperCutoff > spec.cutoff) || !(spec.upperCutoff < nyquist))){
+    throw std::invalid_argument("FilterDesign upper cutoff must be between "
+                                "the cutoff and the Nyquist rate");
+  }
+  if (spec.prototype == CHEBYSHEV_1 && !(spec.rippleDb > 0.0)){
+    throw std::invalid_argument("FilterDesign ripple must be positive");
+  }
+
+  /// Analog prototype with unit cutoff. Neither has finite zeros.
+  std::vector<Complex> zeros, poles;
+  double gain = 1.0;
+  if (spec.prototype == CHEBYSHEV_1){
+    chebyshev1Prototype(spec.order, spec.rippleDb, poles, gain);
+  } else {
+    butterworthPrototype(spec.order, poles, gain);
+  }
+
+  /// Prewarp the band edges so the bilinear transform puts
+  /// them at the requested digital frequencies.
+  const double fs2 = 2.0*spec.sampleRate;
+  const double warped = fs2*std::tan(M_PI*spec.cutoff/spec.sampleRate);
+
+  /// Frequency transform the prototype.
+  const unsigned int degree = static_cast<unsigned int>(poles.size() - zeros.size());
+  if (spec.band == LOW_PASS){
+    for (size_t i=0; i<poles.size(); i++){ poles[i] *= warped; }
+    gain *= std::pow(warped, static_cast<double>(degree));
+  } else if (spec.band == HIGH_PASS){
+    gain *= (productOfDifferences(0.0, zeros)/
+             productOfDifferences(0.0, poles)).real();
+    for (size_t i=0; i<poles.size(); i++){ poles[i] = warped/poles[i]; }
+    zeros.assign(degree, Complex(0.0, 0.0));
+  } else {
+    const double upper = fs2*std::tan(M_PI*spec.upperCutoff/spec.sampleRate);
+    const double center = std::sqrt(warped*upper);
+    const double bandwidth = upper - warped;
+    std::vector<Complex> bandPoles;
+    for (size_t i=0; i<poles.size(); i++){
+      const Complex scaled = poles[i]*(0.5*bandwidth);
+      const Complex offset = std::sqrt(scaled*scaled - center*center);
+      bandPoles.push_back(scaled + offset);
+      bandPoles.push_back(scaled - offset);
+    }
+    poles.swap(bandPoles);
+    zeros.assign(degree, Complex(0.0, 0.0));
+    gain *= std::pow(bandwidth, static_cast<double>(degree));
+  }
+
+  /// Bilinear transform. Zeros at infinity land on z = -1.
+  gain *= (productOfDifferences(fs2, zeros)/
+           productOfDifferences(fs2, poles)).real();
+  for (size_t i=0; i<zeros.size(); i++){
+    _zeros.push_back((fs2 + zeros[i])/(fs2 - zeros[i]));
+  }
+  for (size_t i=0; i<poles.size(); i++){
+    _poles.push_back((fs2 + poles[i])/(fs2 - poles[i]));
+  }
+  while (_zeros.size() < _poles.size()){
+    _zeros.push_back(Complex(-1.0, 0.0));
+  }
+  _gain = gain;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+FilterDesign::~FilterDesign() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Groups the design into second order sections.
+/// @return Sections for a BiquadCascade.
+////////////////////////////////////////////////////////////
+std::vector<BiquadSection> FilterDesign::GetSections(void) const {
+  return BiquadCascade::FromZerosPoles(_zeros, _poles, _gain);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Expands the zeros and poles into polynomials.
+/// @param inWeights  -- Receives the input weights (b).
+/// @param outWeights -- Receives the output weights (a).
+////////////////////////////////////////////////////////////
+void FilterDesign::GetWeights(std::vector<float>& inWeights,
+                              std::vector<float>& outWeights) const {
+  const std::vector<double> b = polynomialFromRoots(_zeros);
+  const std::vector<double> a = polynomialFromRoots(_poles);
+  inWeights.resize(b.size());
+  outWeights.resize(a.size());
+  for (size_t i=0; i<b.size(); i++){
+    inWeights[i] = static_cast<float>(_gain*b[i]);
+  }
+  for (size_t i=0; i<a.size(); i++){
+    outWeights[i] = static_cast<float>(a[i]);
+  }
+}
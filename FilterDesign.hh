@@ -0,0 +1,252 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class designs Butterworth and Chebyshev type
+///          I digital filters, replacing the scipy.signal.butter
+///          step in ChupacabraAnalysis.py.
+///
+///////////////////////////////////////////////////////////////
+#ifndef FILTER_DESIGN_HH
+#define FILTER_DESIGN_HH
+
+#include "BiquadCascade.hh"
+
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @brief Analog prototype a FilterDesign starts from.
+///////////////////////////////////////////////////////////////
+enum FilterPrototype {
+  BUTTERWORTH,
+  CHEBYSHEV_1
+};
+
+///////////////////////////////////////////////////////////////
+/// @brief Pass band shape of a FilterDesign.
+///////////////////////////////////////////////////////////////
+enum FilterBand {
+  LOW_PASS,
+  HIGH_PASS,
+  BAND_PASS
+};
+
+///////////////////////////////////////////////////////////////
+/// @brief Everything needed to design a filter.
+///////////////////////////////////////////////////////////////
+struct FilterSpec {
+  ////////////////////////////////////////////////////////////
+  /// @brief Analog prototype.
+  ////////////////////////////////////////////////////////////
+  FilterPrototype prototype;
+  ////////////////////////////////////////////////////////////
+  /// @brief Pass band shape.
+  ////////////////////////////////////////////////////////////
+  FilterBand band;
+  ////////////////////////////////////////////////////////////
+  /// @brief Prototype order. Band pass filters end up with
+  ///        twice this many poles.
+  ////////////////////////////////////////////////////////////
+  unsigned int order;
+  ////////////////////////////////////////////////////////////
+  /// @brief Sample rate in Hz.
+  ////////////////////////////////////////////////////////////
+  double sampleRate;
+  ////////////////////////////////////////////////////////////
+  /// @brief Cutoff in Hz. The lower edge for band pass.
+  ////////////////////////////////////////////////////////////
+  double cutoff;
+  ////////////////////////////////////////////////////////////
+  /// @brief Upper edge in Hz for band pass, otherwise unused.
+  ////////////////////////////////////////////////////////////
+  double upperCutoff;
+  ////////////////////////////////////////////////////////////
+  /// @brief Pass band ripple in dB for Chebyshev designs,
+  ///        otherwise unused.
+  ////////////////////////////////////////////////////////////
+  double rippleDb;
+};
+
+///////////////////////////////////////////////////////////////
+/// @class FilterDesign
+/// @ingroup DSP
+/// @brief Designs a digital filter the same way scipy.signal's
+///        iirfilter does: an analog prototype with unit cutoff
+///        is frequency transformed to the prewarped band edges
+///        and mapped to the z plane with the bilinear
+///        transform. The result is available as zeros, poles
+///        and gain, as second order sections for BiquadCascade,
+///        or as b/a weights for Filter.
+///
+/// @code
+///   FilterSpec spec = {BUTTERWORTH, LOW_PASS, 2, 500.0, 1.0, 0.0, 0.0};
+///   FilterDesign design(spec);
+///   std::vector<float> b, a;
+///   design.GetWeights(b, a);
+///   Filter lowPass(b.size(), &b[0], a.size(), &a[0]);
+/// @endcode
+///
+/// When the order and band are known at compile time,
+/// designButterworthSections computes the sections as a
+/// constant expression instead.
+///////////////////////////////////////////////////////////////
+class FilterDesign {
+
+ public:
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor designs the filter.
+  /// @param spec -- The filter specification.
+  /// @throws std::invalid_argument if the order is zero, a
+  ///         band edge is not between 0 and the Nyquist rate,
+  ///         the band pass edges are out of order, or the
+  ///         Chebyshev ripple is not positive.
+  ////////////////////////////////////////////////////////////
+  explicit FilterDesign(const FilterSpec& spec);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the FilterDesign
+  ////////////////////////////////////////////////////////////
+  ~FilterDesign();
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the digital zeros.
+  /// @return The zeros of the transfer function.
+  ////////////////////////////////////////////////////////////
+  inline const std::vector<std::complex<double> >& GetZeros(void) const {
+                                  return _zeros; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the digital poles.
+  /// @return The poles of the transfer function.
+  ////////////////////////////////////////////////////////////
+  inline const std::vector<std::complex<double> >& GetPoles(void) const {
+                                  return _poles; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the gain.
+  /// @return The gain of the transfer function.
+  ////////////////////////////////////////////////////////////
+  inline double GetGain(void) const { return _gain; }
+  ////////////////////////////////////////////////////////////
+  /// @brief Groups the design into second order sections.
+  /// @return Sections for a BiquadCascade.
+  ////////////////////////////////////////////////////////////
+  std::vector<BiquadSection> GetSections(void) const;
+  ////////////////////////////////////////////////////////////
+  /// @brief Expands the design into direct form weights.
+  ///        High orders lose precision in float; prefer
+  ///        GetSections above 4th order.
+  /// @param inWeights  -- Receives the input weights (b).
+  /// @param outWeights -- Receives the output weights (a).
+  ////////////////////////////////////////////////////////////
+  void GetWeights(std::vector<float>& inWeights,
+                  std::vector<float>& outWeights) const;
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Zeros of the digital transfer function.
+  ////////////////////////////////////////////////////////////
+  std::vector<std::complex<double> > _zeros;
+  ////////////////////////////////////////////////////////////
+  /// @brief Poles of the digital transfer function.
+  ////////////////////////////////////////////////////////////
+  std::vector<std::complex<double> > _poles;
+  ////////////////////////////////////////////////////////////
+  /// @brief Gain of the digital transfer function.
+  ////////////////////////////////////////////////////////////
+  double _gain;
+};
+
+///////////////////////////////////////////////////////////////
+/// @brief Constant expression math for the compile time
+///        designs. Accurate to double precision over the
+///        ranges the designs use.
+///////////////////////////////////////////////////////////////
+struct ConstexprMath {
+  static constexpr double PI = 3.14159265358979323846;
+  ////////////////////////////////////////////////////////////
+  /// @brief Sine by Taylor series after reducing x to
+  ///        [-pi, pi].
+  ////////////////////////////////////////////////////////////
+  static constexpr double sin(double x){
+    while (x > PI) x -= 2.0*PI;
+    while (x < -PI) x += 2.0*PI;
+    double term = x;
+    double sum = x;
+    for (int n=1; n<30; n++){
+      term *= -x*x/((2.0*n)*(2.0*n + 1.0));
+      sum += term;
+    }
+    return sum;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Cosine from sine.
+  ////////////////////////////////////////////////////////////
+  static constexpr double cos(double x){
+    return sin(x + 0.5*PI);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Tangent from sine and cosine.
+  ////////////////////////////////////////////////////////////
+  static constexpr double tan(double x){
+    return sin(x)/cos(x);
+  }
+};
+
+///////////////////////////////////////////////////////////////
+/// @brief Second order sections of a compile time Butterworth
+///        design. Odd orders end with a first order section.
+///////////////////////////////////////////////////////////////
+template <unsigned int Order>
+struct ButterworthSections {
+  static const unsigned int NumSections = (Order + 1)/2;
+  BiquadSection sections[NumSections];
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Designs a Butterworth low or high pass filter as a
+///        constant expression. Each pole pair of the analog
+///        prototype has quality factor
+///        1/(2 sin((2k+1) pi/(2N))), and the bilinear transform
+///        of each section has a closed form in the prewarped
+///        K = tan(pi*cutoff/sampleRate).
+/// @param band       -- LOW_PASS or HIGH_PASS.
+/// @param cutoff     -- Cutoff in Hz.
+/// @param sampleRate -- Sample rate in Hz.
+/// @return The sections, usable with BiquadCascade.
+////////////////////////////////////////////////////////////
+template <unsigned int Order>
+constexpr ButterworthSections<Order> designButterworthSections(
+    FilterBand band, double cutoff, double sampleRate){
+  static_assert(Order > 0, "Butterworth order must be positive");
+  if (band == BAND_PASS){
+    throw std::invalid_argument(
+        "designButterworthSections supports low and high pass only");
+  }
+  if (!(cutoff > 0.0) || !(cutoff < 0.5*sampleRate)){
+    throw std::invalid_argument("cutoff must be between 0 and sampleRate/2");
+  }
+  ButterworthSections<Order> result = {};
+  const double k = ConstexprMath::tan(ConstexprMath::PI*cutoff/sampleRate);
+  const double kk = k*k;
+  for (unsigned int s=0; s<Order/2; s++){
+    const double damping = 2.0*ConstexprMath::sin(
+        (2.0*s + 1.0)*ConstexprMath::PI/(2.0*Order));
+    const double norm = 1.0/(1.0 + k*damping + kk);
+    const double b0 = (band == LOW_PASS) ? kk*norm : norm;
+    const double b1 = (band == LOW_PASS) ? 2.0*b0 : -2.0*b0;
+    result.sections[s].b0 = static_cast<float>(b0);
+    result.sections[s].b1 = static_cast<float>(b1);
+    result.sections[s].b2 = static_cast<float>(b0);
+    result.sections[s].a1 = static_cast<float>(2.0*(kk - 1.0)*norm);
+    result.sections[s].a2 = static_cast<float>((1.0 - k*damping + kk)*norm);
+  }
+  if (Order % 2 != 0){
+    const double norm = 1.0/(1.0 + k);
+    const double b0 = (band == LOW_PASS) ? k*norm : norm;
+    BiquadSection& last = result.sections[Order/2];
+    last.b0 = static_cast<float>(b0);
+    last.b1 = static_cast<float>((band == LOW_PASS) ? b0 : -b0);
+    last.b2 = 0.0f;
+    last.a1 = static_cast<float>((k - 1.0)*norm);
+    last.a2 = 0.0f;
+  }
+  return result;
+}
+
+#endif  // FILTER_DESIGN_HH
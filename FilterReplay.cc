@@ -0,0 +1,330 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup Command line tool that replays a recorded capture
+///          through a chain of filters, the C++ counterpart of
+///          the lfilter step in ChupacabraAnalysis.py.
+///
+///   FilterReplay [options] <capture> <output>
+///
+///   -c, --column NAME   Column to filter, by name or index.
+///                       Repeat for more; default is all.
+///   -f, --filter SPEC   Appends a filter stage:
+///                         butter:low|high:ORDER:CUTOFF
+///                         butter:band:ORDER:LOW:HIGH
+///                         cheby1:low|high:ORDER:RIPPLE:CUTOFF
+///                         cheby1:band:ORDER:RIPPLE:LOW:HIGH
+///                         weights:b0,b1,...:a0,a1,...
+///   -r, --rate HZ       Sample rate for designed stages
+///                       (default 500).
+///   -n, --block FRAMES  Frames per block (default 4096).
+///   --binary            Write a packed binary capture instead
+///                       of CSV.
+///
+/// The capture may be CSV or packed binary (see
+/// CaptureReader). An output of "-" writes to stdout.
+/// Throughput is reported on stderr.
+///
+///////////////////////////////////////////////////////////////
+#include "CaptureReader.hh"
+#include "FilterBank.hh"
+#include "FilterDesign.hh"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////
+/// @brief Splits a string on a separator.
+////////////////////////////////////////////////////////////
+static std::vector<std::string> split(const std::string& text, char separator){
+  std::vector<std::string> fields;
+  size_t begin = 0;
+  for (;;){
+    const size_t end = text.find(separator, begin);
+    fields.push_back(text.substr(begin, end - begin));
+    if (end == std::string::npos){
+      return fields;
+    }
+    begin = end + 1;
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Parses a whole string as a number.
+/// @throws std::invalid_argument if it is not one.
+////////////////////////////////////////////////////////////
+static double parseValue(const std::string& text){
+  char* end = NULL;
+  const double value = std::strtod(text.c_str(), &end);
+  if (text.empty() || *end != '\0'){
+    throw std::invalid_argument("'" + text + "' is not a number");
+  }
+  return value;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Appends the filter banks for one --filter stage.
+///        Designed stages become one bank per second order
+///        section; weights stages become a single bank.
+/// @param spec        -- The stage specification.
+/// @param sampleRate  -- Sample rate for designed stages.
+/// @param numChannels -- Channels in each frame.
+/// @param chain       -- Receives the banks.
+/// @throws std::invalid_argument on a malformed stage.
+////////////////////////////////////////////////////////////
+static void addStage(const std::string& spec, double sampleRate,
+                     unsigned int numChannels,
+                     std::vector<FilterBank>& chain){
+  const std::vector<std::string> fields = split(spec, ':');
+  if (fields[0] == "weights"){
+    if (fields.size() != 3){
+      throw std::invalid_argument("weights stage needs b and a lists: " + spec);
+    }
+    std::vector<float> b, a;
+    const std::vector<std::string> bFields = split(fields[1], ',');
+    const std::vector<std::string> aFields = split(fields[2], ',');
+    for (size_t i=0; i<bFields.size(); i++){
+      b.push_back(static_cast<float>(parseValue(bFields[i])));
+    }
+    for (size_t i=0; i<aFields.size(); i++){
+      a.push_back(static_cast<float>(parseValue(aFields[i])));
+    }
+    chain.push_back(FilterBank(numChannels, b.size(), &b[0], a.size(), &a[0]));
+    return;
+  }
+
+  FilterSpec design = {BUTTERWORTH, LOW_PASS, 0, sampleRate, 0.0, 0.0, 0.0};
+  if (fields[0] == "cheby1"){
+    design.prototype = CHEBYSHEV_1;
+  } else if (fields[0] != "butter"){
+    throw std::invalid_argument("unknown filter stage: " + spec);
+  }
+  if (fields.size() < 2){
+    throw std::invalid_argument("filter stage needs a band: " + spec);
+  }
+  if (fields[1] == "high"){
+    design.band = HIGH_PASS;
+  } else if (fields[1] == "band"){
+    design.band = BAND_PASS;
+  } else if (fields[1] != "low"){
+    throw std::invalid_argument("unknown filter band: " + spec);
+  }
+  const size_t numValues = 2 + (design.prototype == CHEBYSHEV_1 ? 1 : 0) +
+                           (design.band == BAND_PASS ? 1 : 0);
+  if (fields.size() != 2 + numValues){
+    throw std::invalid_argument("wrong number of values in stage: " + spec);
+  }
+  size_t next = 2;
+  design.order = static_cast<unsigned int>(parseValue(fields[next++]));
+  if (design.prototype == CHEBYSHEV_1){
+    design.rippleDb = parseValue(fields[next++]);
+  }
+  design.cutoff = parseValue(fields[next++]);
+  if (design.band == BAND_PASS){
+    design.upperCutoff = parseValue(fields[next++]);
+  }
+  const std::vector<BiquadSection> sections = FilterDesign(design).GetSections();
+  for (size_t i=0; i<sections.size(); i++){
+    const float b[3] = {sections[i].b0, sections[i].b1, sections[i].b2};
+    const float a[3] = {1.0f, sections[i].a1, sections[i].a2};
+    chain.push_back(FilterBank(numChannels, 3, b, 3, a));
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Prints the usage summary.
+////////////////////////////////////////////////////////////
+static void usage(const char* program){
+  std::fprintf(stderr,
+      "usage: %s [options] <capture> <output>\n"
+      "  -c, --column NAME   column to filter (repeatable, default all)\n"
+      "  -f, --filter SPEC   append a filter stage (repeatable):\n"
+      "                        butter:low|high:ORDER:CUTOFF\n"
+      "                        butter:band:ORDER:LOW:HIGH\n"
+      "                        cheby1:low|high:ORDER:RIPPLE:CUTOFF\n"
+      "                        cheby1:band:ORDER:RIPPLE:LOW:HIGH\n"
+      "                        weights:b0,b1,...:a0,a1,...\n"
+      "  -r, --rate HZ       sample rate for designed stages (default 500)\n"
+      "  -n, --block FRAMES  frames per block (default 4096)\n"
+      "      --binary        write a packed binary capture instead of CSV\n",
+      program);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Writes a block of frames as CSV rows. Values are
+///        formatted into one fixed buffer, so no row
+///        allocates.
+/// @return false if the write failed.
+////////////////////////////////////////////////////////////
+static bool writeCsvBlock(std::FILE* file, const float* frames,
+                          unsigned int numFrames, unsigned int numChannels,
+                          std::vector<char>& text){
+  const size_t maxValue = 20;
+  text.resize(numChannels*maxValue + 1);
+  for (unsigned int n=0; n<numFrames; n++){
+    char* p = &text[0];
+    for (unsigned int c=0; c<numChannels; c++){
+      p += std::snprintf(p, maxValue, "%.9g", *frames++);
+      *p++ = (c + 1 < numChannels) ? ',' : '\n';
+    }
+    const size_t length = p - &text[0];
+    if (std::fwrite(&text[0], 1, length, file) != length){
+      return false;
+    }
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Owns the output stream so it is closed on every
+///        way out of main, including exceptions. Standard
+///        output is flushed rather than closed.
+////////////////////////////////////////////////////////////
+class OutputFile {
+ public:
+  explicit OutputFile(const std::string& path) :
+           _file((path == "-") ? stdout : std::fopen(path.c_str(), "wb")) {}
+  ~OutputFile(){ close(); }
+  OutputFile(const OutputFile&) = delete;
+  OutputFile& operator=(const OutputFile&) = delete;
+  ////////////////////////////////////////////////////////////
+  /// @brief Closes the stream, once.
+  /// @return false if the final write back failed.
+  ////////////////////////////////////////////////////////////
+  bool close(void){
+    if (_file == NULL){
+      return true;
+    }
+    const int status = (_file == stdout) ? std::fflush(_file)
+                                         : std::fclose(_file);
+    _file = NULL;
+    return status == 0;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief The stream, or NULL if it could not be opened.
+  ////////////////////////////////////////////////////////////
+  inline std::FILE* get(void) const { return _file; }
+ private:
+  std::FILE* _file;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Replays the capture.
+////////////////////////////////////////////////////////////
+int main(int argc, char** argv){
+  std::vector<std::string> columns, stages, paths;
+  double sampleRate = 500.0;
+  unsigned int blockFrames = 4096;
+  bool binaryOutput = false;
+  try {
+    for (int i=1; i<argc; i++){
+      const std::string arg = argv[i];
+      const bool hasValue = (i + 1 < argc);
+      if ((arg == "-c" || arg == "--column") && hasValue){
+        columns.push_back(argv[++i]);
+      } else if ((arg == "-f" || arg == "--filter") && hasValue){
+        stages.push_back(argv[++i]);
+      } else if ((arg == "-r" || arg == "--rate") && hasValue){
+        sampleRate = parseValue(argv[++i]);
+      } else if ((arg == "-n" || arg == "--block") && hasValue){
+        blockFrames = static_cast<unsigned int>(parseValue(argv[++i]));
+      } else if (arg == "--binary"){
+        binaryOutput = true;
+      } else if (arg == "-h" || arg == "--help"){
+        usage(argv[0]);
+        return 0;
+      } else if (arg.size() > 1 && arg[0] == '-'){
+        usage(argv[0]);
+        return 2;
+      } else {
+        paths.push_back(arg);
+      }
+    }
+    if (paths.size() != 2 || blockFrames == 0){
+      usage(argv[0]);
+      return 2;
+    }
+
+    CaptureReader capture(paths[0]);
+    if (!columns.empty()){
+      std::vector<unsigned int> selection;
+      for (size_t i=0; i<columns.size(); i++){
+        selection.push_back(capture.findColumn(columns[i]));
+      }
+      capture.selectColumns(selection);
+    }
+    const unsigned int numChannels = capture.GetNumSelected();
+    std::vector<FilterBank> chain;
+    for (size_t i=0; i<stages.size(); i++){
+      addStage(stages[i], sampleRate, numChannels, chain);
+    }
+
+    OutputFile outputFile(paths[1]);
+    std::FILE* output = outputFile.get();
+    if (output == NULL){
+      throw std::runtime_error("cannot create " + paths[1] + ": " +
+                               std::strerror(errno));
+    }
+    std::vector<std::string> names;
+    for (unsigned int i=0; i<numChannels; i++){
+      names.push_back(capture.GetColumnNames()[capture.GetSelectedColumns()[i]]);
+    }
+    bool written = true;
+    if (binaryOutput){
+      written = CaptureReader::writeBinaryHeader(output, names);
+    } else {
+      for (unsigned int i=0; i<numChannels && written; i++){
+        written = std::fprintf(output, "%s%c", names[i].c_str(),
+                               i + 1 < numChannels ? ',' : '\n') > 0;
+      }
+    }
+
+    /// Every stage filters the block in place.
+    std::vector<float> block(static_cast<size_t>(blockFrames)*numChannels);
+    std::vector<char> text;
+    unsigned long long numFrames = 0;
+    double filterSeconds = 0.0;
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    unsigned int count;
+    while (written && (count = capture.readFrames(&block[0], blockFrames)) > 0){
+      const std::chrono::steady_clock::time_point filterStart =
+          std::chrono::steady_clock::now();
+      for (size_t s=0; s<chain.size(); s++){
+        chain[s].filterFrames(&block[0], &block[0], count);
+      }
+      filterSeconds += std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - filterStart).count();
+      if (binaryOutput){
+        written = std::fwrite(&block[0], sizeof(float)*numChannels, count,
+                              output) == count;
+      } else {
+        written = writeCsvBlock(output, &block[0], count, numChannels, text);
+      }
+      numFrames += count;
+    }
+    written = outputFile.close() && written;
+    if (!written){
+      throw std::runtime_error("failed writing " + paths[1]);
+    }
+    const double totalSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    const double numSamples = static_cast<double>(numFrames)*numChannels;
+    std::fprintf(stderr,
+        "%llu frames x %u channels through %u sections in %.3f s\n"
+        "  end to end: %.3g samples/s\n"
+        "  filtering:  %.3g samples/s\n",
+        numFrames, numChannels, static_cast<unsigned int>(chain.size()),
+        totalSeconds,
+        totalSeconds > 0.0 ? numSamples/totalSeconds : 0.0,
+        filterSeconds > 0.0 ? numSamples/filterSeconds : 0.0);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "%s: %s\n", argv[0], e.what());
+    return 1;
+  }
+  return 0;
+}
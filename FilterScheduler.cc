@@ -0,0 +1,226 @@
+#include "FilterScheduler.hh"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor starts the worker threads.
+////////////////////////////////////////////////////////////
+FilterScheduler::FilterScheduler(unsigned int numWorkers, bool pinThreads) :
+         _filters(),
+         _workers(),
+         _partitionStale(true),
+         _input(NULL),
+         _output(NULL),
+         _numSamples(0),
+         _mutex(),
+         _startCondition(),
+         _doneCondition(),
+         _generation(0),
+         _running(false),
+         _stopping(false),
+         _busyWorkers(0)
+{
+  const unsigned int numCpus = std::thread::hardware_concurrency();
+  if (numWorkers == 0){
+    numWorkers = (numCpus == 0) ? 1 : numCpus;
+  }
+  for (unsigned int w=0; w<numWorkers; w++){
+    std::unique_ptr<Worker> worker(new Worker());
+    worker->nextChunk = 0;
+    worker->firstChunk = 0;
+    worker->endChunk = 0;
+    _workers.push_back(std::move(worker));
+  }
+  for (unsigned int w=0; w<numWorkers; w++){
+    _workers[w]->thread = std::thread(&FilterScheduler::run, this, w);
+#ifdef __linux__
+    if (pinThreads && numCpus > 0){
+      cpu_set_t cpus;
+      CPU_ZERO(&cpus);
+      CPU_SET(w % numCpus, &cpus);
+      pthread_setaffinity_np(_workers[w]->thread.native_handle(),
+                             sizeof(cpus), &cpus);
+    }
+#else
+    (void)pinThreads;
+#endif
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+FilterScheduler::~FilterScheduler() {
+  wait();
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+  }
+  _startCondition.notify_all();
+  for (size_t w=0; w<_workers.size(); w++){
+    _workers[w]->thread.join();
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Adds a filter between ticks.
+/// @param filter -- The filter to own.
+/// @return The filter's index.
+////////////////////////////////////////////////////////////
+unsigned int FilterScheduler::addFilter(std::unique_ptr<Filter> filter){
+  if (!filter){
+    throw std::invalid_argument("FilterScheduler cannot add a null filter");
+  }
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_running){
+    throw std::logic_error("FilterScheduler cannot add filters during a tick");
+  }
+  _filters.push_back(std::move(filter));
+  _partitionStale = true;
+  return static_cast<unsigned int>(_filters.size() - 1);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Gives each worker an equal contiguous run of
+///        chunks, the first workers taking one extra when
+///        the chunks do not divide evenly.
+////////////////////////////////////////////////////////////
+void FilterScheduler::partition(void){
+  const unsigned int numChunks = static_cast<unsigned int>(
+      (_filters.size() + FILTERS_PER_CHUNK - 1)/FILTERS_PER_CHUNK);
+  const unsigned int numWorkers = GetNumWorkers();
+  unsigned int chunk = 0;
+  for (unsigned int w=0; w<numWorkers; w++){
+    const unsigned int share = numChunks/numWorkers +
+                               (w < numChunks % numWorkers ? 1 : 0);
+    _workers[w]->firstChunk = chunk;
+    chunk += share;
+    _workers[w]->endChunk = chunk;
+  }
+  _partitionStale = false;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Looks up the worker assigned to a filter.
+/// @param index -- Index returned by addFilter.
+/// @return The worker index.
+////////////////////////////////////////////////////////////
+unsigned int FilterScheduler::GetWorkerOf(unsigned int index){
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_partitionStale && !_running){
+    partition();
+  }
+  const unsigned int chunk = index/FILTERS_PER_CHUNK;
+  for (unsigned int w=0; w<GetNumWorkers(); w++){
+    if (chunk < _workers[w]->endChunk){
+      return w;
+    }
+  }
+  return GetNumWorkers() - 1;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Runs one tick and waits for it.
+/// @param input      -- Stream major inputs.
+/// @param output     -- Stream major outputs.
+/// @param numSamples -- Samples per filter.
+////////////////////////////////////////////////////////////
+void FilterScheduler::process(const float* input, float* output,
+                              unsigned int numSamples){
+  start(input, output, numSamples);
+  wait();
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Publishes a tick and wakes the workers.
+/// @param input      -- Stream major inputs.
+/// @param output     -- Stream major outputs.
+/// @param numSamples -- Samples per filter.
+////////////////////////////////////////////////////////////
+void FilterScheduler::start(const float* input, float* output,
+                            unsigned int numSamples){
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_running){
+      throw std::logic_error("FilterScheduler tick already running");
+    }
+    if (_partitionStale){
+      partition();
+    }
+    _input = input;
+    _output = output;
+    _numSamples = numSamples;
+    for (size_t w=0; w<_workers.size(); w++){
+      _workers[w]->nextChunk.store(_workers[w]->firstChunk,
+                                   std::memory_order_relaxed);
+    }
+    _busyWorkers.store(GetNumWorkers(), std::memory_order_relaxed);
+    _running = true;
+    _generation++;
+  }
+  _startCondition.notify_all();
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Waits for the barrier at the end of the tick.
+////////////////////////////////////////////////////////////
+void FilterScheduler::wait(void){
+  std::unique_lock<std::mutex> lock(_mutex);
+  _doneCondition.wait(lock, [this]{ return !_running; });
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Runs every filter of one chunk over the tick.
+/// @param chunk -- The chunk index.
+////////////////////////////////////////////////////////////
+void FilterScheduler::processChunk(unsigned int chunk){
+  const size_t begin = static_cast<size_t>(chunk)*FILTERS_PER_CHUNK;
+  size_t end = begin + FILTERS_PER_CHUNK;
+  if (end > _filters.size()){
+    end = _filters.size();
+  }
+  for (size_t i=begin; i<end; i++){
+    const size_t offset = i*_numSamples;
+    _filters[i]->filterBlock(_input + offset, _output + offset, _numSamples);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Worker loop: sleep until a tick starts, run the
+///        worker's own chunks, steal what is left of the
+///        others', and arrive at the barrier.
+/// @param workerIndex -- This worker's index.
+////////////////////////////////////////////////////////////
+void FilterScheduler::run(unsigned int workerIndex){
+  const unsigned int numWorkers = GetNumWorkers();
+  unsigned long seen = 0;
+  for (;;){
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _startCondition.wait(lock, [this, seen]{
+          return _stopping || _generation != seen; });
+      if (_stopping){
+        return;
+      }
+      seen = _generation;
+    }
+    for (unsigned int k=0; k<numWorkers; k++){
+      Worker& victim = *_workers[(workerIndex + k) % numWorkers];
+      unsigned int chunk;
+      while ((chunk = victim.nextChunk.fetch_add(1, std::memory_order_relaxed))
+             < victim.endChunk){
+        processChunk(chunk);
+      }
+    }
+    if (_busyWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1){
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+      }
+      _doneCondition.notify_all();
+    }
+  }
+}
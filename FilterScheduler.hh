@@ -0,0 +1,203 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class drives many independent filters, one
+///          per sensor stream, across a pool of worker threads.
+///
+///////////////////////////////////////////////////////////////
+#ifndef FILTER_SCHEDULER_HH
+#define FILTER_SCHEDULER_HH
+
+#include "Filter.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @class FilterScheduler
+/// @ingroup DSP
+/// @brief Owns a set of filters and runs one block of samples
+///        through every filter per tick on a thread pool.
+///
+/// The filters are divided into chunks of FILTERS_PER_CHUNK,
+/// and each worker is given a fixed, contiguous run of
+/// chunks. A worker always starts a tick on its own chunks,
+/// so a filter's state stays in the cache of the core that
+/// last ran it. A worker that finishes early steals the
+/// remaining chunks of the others, which keeps uneven filter
+/// costs from stalling the tick. The tick ends at a barrier:
+/// process() returns once every filter has run.
+///
+/// A tick's samples are stream major: filter i reads
+/// numSamples inputs starting at input[i*numSamples] and
+/// writes its outputs at the same place in output.
+///
+/// @code
+///   FilterScheduler scheduler(8);
+///   for (unsigned int i=0; i<numSensors; i++){
+///     scheduler.addFilter(std::unique_ptr<Filter>(new Filter(3, b, 3, a)));
+///   }
+///   scheduler.process(&input[0], &output[0], samplesPerTick);
+/// @endcode
+///////////////////////////////////////////////////////////////
+class FilterScheduler {
+
+ public:
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of filters handed out as one unit of work.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int FILTERS_PER_CHUNK = 16;
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor starts the worker threads.
+  /// @param numWorkers -- Number of worker threads; zero for
+  ///                      one per hardware thread.
+  /// @param pinThreads -- Bind worker w to CPU w (modulo the
+  ///                      CPU count) where the platform
+  ///                      supports it.
+  ////////////////////////////////////////////////////////////
+  explicit FilterScheduler(unsigned int numWorkers = 0,
+                           bool pinThreads = false);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the FilterScheduler,
+  ///        waiting for a running tick and joining the
+  ///        workers.
+  ////////////////////////////////////////////////////////////
+  ~FilterScheduler();
+  FilterScheduler(const FilterScheduler&) = delete;
+  FilterScheduler& operator=(const FilterScheduler&) = delete;
+  ////////////////////////////////////////////////////////////
+  /// @brief Adds a filter. Must not be called during a tick.
+  /// @param filter -- The filter; the scheduler takes
+  ///                  ownership.
+  /// @return The filter's index, which selects its samples
+  ///         in each tick.
+  /// @throws std::invalid_argument if filter is null.
+  /// @throws std::logic_error if a tick is running.
+  ////////////////////////////////////////////////////////////
+  unsigned int addFilter(std::unique_ptr<Filter> filter);
+  ////////////////////////////////////////////////////////////
+  /// @brief Runs one tick and waits for it to finish.
+  /// @param input      -- GetNumFilters()*numSamples inputs,
+  ///                      stream major.
+  /// @param output     -- GetNumFilters()*numSamples outputs,
+  ///                      stream major. May alias input.
+  /// @param numSamples -- Samples per filter in this tick.
+  /// @throws std::logic_error if a tick is already running.
+  ////////////////////////////////////////////////////////////
+  void process(const float* input, float* output, unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief Starts a tick and returns at once, so the caller
+  ///        can prepare the next block meanwhile. The buffers
+  ///        must stay valid until wait() returns.
+  /// @throws std::logic_error if a tick is already running.
+  ////////////////////////////////////////////////////////////
+  void start(const float* input, float* output, unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief Blocks until the running tick, if any, finishes.
+  ////////////////////////////////////////////////////////////
+  void wait(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get a filter. Only safe
+  ///        between ticks.
+  /// @param index -- Index returned by addFilter.
+  /// @return The filter.
+  ////////////////////////////////////////////////////////////
+  inline Filter& GetFilter(unsigned int index){ return *_filters[index]; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the filter count.
+  /// @return The number of filters.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetNumFilters(void) const {
+                                  return static_cast<unsigned int>(_filters.size()); }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the worker count.
+  /// @return The number of worker threads.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetNumWorkers(void) const {
+                                  return static_cast<unsigned int>(_workers.size()); }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the worker a filter
+  ///        is assigned to. Only meaningful between ticks.
+  /// @param index -- Index returned by addFilter.
+  /// @return The worker that starts each tick on the filter.
+  ////////////////////////////////////////////////////////////
+  unsigned int GetWorkerOf(unsigned int index);
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Per worker state. The chunk counter is padded to
+  ///        its own cache line, since thieves write to it.
+  ////////////////////////////////////////////////////////////
+  struct Worker {
+    char padBefore[64];
+    std::atomic<unsigned int> nextChunk;
+    char padAfter[64];
+    unsigned int firstChunk;
+    unsigned int endChunk;
+    std::thread thread;
+  };
+  ////////////////////////////////////////////////////////////
+  /// @brief Worker thread body.
+  ////////////////////////////////////////////////////////////
+  void run(unsigned int workerIndex);
+  ////////////////////////////////////////////////////////////
+  /// @brief Runs every filter of one chunk over the tick.
+  ////////////////////////////////////////////////////////////
+  void processChunk(unsigned int chunk);
+  ////////////////////////////////////////////////////////////
+  /// @brief Reassigns chunk ranges after filters are added.
+  ////////////////////////////////////////////////////////////
+  void partition(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief The filters, by index.
+  ////////////////////////////////////////////////////////////
+  std::vector<std::unique_ptr<Filter> > _filters;
+  ////////////////////////////////////////////////////////////
+  /// @brief The workers.
+  ////////////////////////////////////////////////////////////
+  std::vector<std::unique_ptr<Worker> > _workers;
+  ////////////////////////////////////////////////////////////
+  /// @brief True when the chunk ranges are out of date.
+  ////////////////////////////////////////////////////////////
+  bool _partitionStale;
+  ////////////////////////////////////////////////////////////
+  /// @brief The current tick's buffers.
+  ////////////////////////////////////////////////////////////
+  const float* _input;
+  float* _output;
+  unsigned int _numSamples;
+  ////////////////////////////////////////////////////////////
+  /// @brief Guards the tick generation, the stop flag and the
+  ///        running flag.
+  ////////////////////////////////////////////////////////////
+  std::mutex _mutex;
+  ////////////////////////////////////////////////////////////
+  /// @brief Wakes the workers for a tick or to stop.
+  ////////////////////////////////////////////////////////////
+  std::condition_variable _startCondition;
+  ////////////////////////////////////////////////////////////
+  /// @brief Signals the end of a tick.
+  ////////////////////////////////////////////////////////////
+  std::condition_variable _doneCondition;
+  ////////////////////////////////////////////////////////////
+  /// @brief Incremented at the start of every tick.
+  ////////////////////////////////////////////////////////////
+  unsigned long _generation;
+  ////////////////////////////////////////////////////////////
+  /// @brief True while a tick is running.
+  ////////////////////////////////////////////////////////////
+  bool _running;
+  ////////////////////////////////////////////////////////////
+  /// @brief Set to stop the workers.
+  ////////////////////////////////////////////////////////////
+  bool _stopping;
+  ////////////////////////////////////////////////////////////
+  /// @brief Workers still busy in the running tick.
+  ////////////////////////////////////////////////////////////
+  std::atomic<unsigned int> _busyWorkers;
+};
+
+#endif  // FILTER_SCHEDULER_HH
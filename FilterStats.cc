@@ -0,0 +1,70 @@
+#include "FilterStats.hh"
+
+#include <limits>
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members.
+////////////////////////////////////////////////////////////
+FilterStats::FilterStats() :
+         _sequence(0),
+         _samples(0),
+         _nonFinite(0),
+         _saturated(0),
+         _pendingSamples(0),
+         _pendingNonFinite(0),
+         _pendingSaturated(0),
+         _saturationLevel(std::numeric_limits<float>::infinity())
+{
+  for (unsigned int i=0; i<FILTER_LATENCY_BUCKETS; i++){
+    _latency[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members.
+////////////////////////////////////////////////////////////
+FilterStats::FilterStats(const FilterStats& other) :
+         _sequence(0),
+         _samples(0),
+         _nonFinite(0),
+         _saturated(0),
+         _pendingSamples(0),
+         _pendingNonFinite(0),
+         _pendingSaturated(0),
+         _saturationLevel(other._saturationLevel)
+{
+  for (unsigned int i=0; i<FILTER_LATENCY_BUCKETS; i++){
+    _latency[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+FilterStats::~FilterStats() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Seqlock read: copy the counters, then check that
+///        the sequence count was even and has not moved. The
+///        acquire fence keeps the copies from being read
+///        after the second load of the count.
+/// @return The statistics between two updates.
+////////////////////////////////////////////////////////////
+FilterStatsSnapshot FilterStats::snapshot(void) const {
+  FilterStatsSnapshot copy;
+  uint64_t sequence;
+  do {
+    sequence = _sequence.load(std::memory_order_acquire);
+    copy.samples = _samples.load(std::memory_order_relaxed);
+    copy.nonFinite = _nonFinite.load(std::memory_order_relaxed);
+    copy.saturated = _saturated.load(std::memory_order_relaxed);
+    for (unsigned int i=0; i<FILTER_LATENCY_BUCKETS; i++){
+      copy.latency[i] = _latency[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((sequence & 1) != 0 ||
+           _sequence.load(std::memory_order_relaxed) != sequence);
+  return copy;
+}
@@ -0,0 +1,274 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class records run time statistics of one
+///          filter for monitoring in production.
+///
+///////////////////////////////////////////////////////////////
+#ifndef FILTER_STATS_HH
+#define FILTER_STATS_HH
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FILTER_STATS_TSC 1
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+////////////////////////////////////////////////////////////
+/// @brief Number of latency histogram buckets. Bucket i
+///        counts latencies of 2^i to 2^(i+1) - 1 ticks; the
+///        last bucket also takes everything longer.
+////////////////////////////////////////////////////////////
+static const unsigned int FILTER_LATENCY_BUCKETS = 32;
+
+////////////////////////////////////////////////////////////
+/// @brief Reads the time stamp counter, or a nanosecond
+///        clock where there is none.
+/// @return The current time in ticks.
+////////////////////////////////////////////////////////////
+inline uint64_t filterTimestamp(void){
+#ifdef FILTER_STATS_TSC
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+///////////////////////////////////////////////////////////////
+/// @brief A consistent copy of the statistics.
+///////////////////////////////////////////////////////////////
+struct FilterStatsSnapshot {
+  ////////////////////////////////////////////////////////////
+  /// @brief Samples filtered.
+  ////////////////////////////////////////////////////////////
+  uint64_t samples;
+  ////////////////////////////////////////////////////////////
+  /// @brief Outputs that were NaN or infinite.
+  ////////////////////////////////////////////////////////////
+  uint64_t nonFinite;
+  ////////////////////////////////////////////////////////////
+  /// @brief Finite outputs whose magnitude reached the
+  ///        saturation level.
+  ////////////////////////////////////////////////////////////
+  uint64_t saturated;
+  ////////////////////////////////////////////////////////////
+  /// @brief Histogram of the ticks spent per sample; see
+  ///        FilterStats for what is timed.
+  ////////////////////////////////////////////////////////////
+  uint64_t latency[FILTER_LATENCY_BUCKETS];
+};
+
+///////////////////////////////////////////////////////////////
+/// @class FilterStats
+/// @ingroup DSP
+/// @brief Sample counts, output anomalies and a latency
+///        histogram for one filter, written by the thread
+///        running the filter and readable from any thread.
+///
+/// Filter keeps one of these and updates it when it is built
+/// with FILTER_INSTRUMENTATION defined; without the macro the
+/// filter routines are unchanged. The macro changes Filter's
+/// layout, so it must be the same for every translation unit.
+///
+/// The hot path has to stay within a couple of nanoseconds
+/// per sample, which rules out timing every filter() call:
+/// reading the time stamp counter twice costs more than that.
+/// filter() therefore times one call in TIMING_PERIOD and
+/// only counts the others locally; the counts are published
+/// with the timed call, so a snapshot may lag by up to
+/// TIMING_PERIOD - 1 single samples. filterBlock() times the
+/// whole block, records the average per sample and publishes
+/// at its end. Every output is classified, with one
+/// comparison.
+///
+/// There is a single writer, so the counters are plain loads
+/// and stores of relaxed atomics rather than locked read
+/// modify writes. Each update is bracketed by a sequence
+/// count (a seqlock): snapshot() retries until it has copied
+/// the counters without an update in between, so a reader
+/// never blocks the writer and always sees one consistent
+/// state.
+///
+/// @code
+///   filter.GetStats().SetSaturationLevel(1.0f);
+///   ...
+///   const FilterStatsSnapshot now = filter.GetStats().snapshot();
+/// @endcode
+///////////////////////////////////////////////////////////////
+class FilterStats {
+
+ public:
+  ////////////////////////////////////////////////////////////
+  /// @brief filter() times one call in this many.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int TIMING_PERIOD = 64;
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor starts with every count at zero
+  ///        and no saturation level.
+  ////////////////////////////////////////////////////////////
+  FilterStats();
+  //////////////////////////////////////////////////////////
+  /// @brief A copy starts its own counts from zero; only the
+  ///        saturation level is copied.
+  ////////////////////////////////////////////////////////////
+  FilterStats(const FilterStats& other);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the FilterStats.
+  ////////////////////////////////////////////////////////////
+  ~FilterStats();
+  ////////////////////////////////////////////////////////////
+  /// @brief Copies the counters without stopping the writer.
+  /// @return The statistics as of one point between updates.
+  ////////////////////////////////////////////////////////////
+  FilterStatsSnapshot snapshot(void) const;
+  ////////////////////////////////////////////////////////////
+  /// @brief Sets the output magnitude counted as saturated.
+  ///        Set it before filtering starts; it is read by the
+  ///        writer without synchronization.
+  /// @param level -- Saturation level; infinity turns the
+  ///                 count off.
+  ////////////////////////////////////////////////////////////
+  inline void SetSaturationLevel(float level){ _saturationLevel = level; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the saturation level.
+  /// @return The output magnitude counted as saturated.
+  ////////////////////////////////////////////////////////////
+  inline float GetSaturationLevel(void) const { return _saturationLevel; }
+  ////////////////////////////////////////////////////////////
+  /// @brief Starts a filter() call.
+  /// @return The start time if this call is timed, else 0.
+  ////////////////////////////////////////////////////////////
+  inline uint64_t beginSample(void){
+    return _pendingSamples + 1 == TIMING_PERIOD ? filterTimestamp() : 0;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Finishes a filter() call. The counts are kept
+  ///        locally and published with the timed call.
+  /// @param outputValue -- The filter output.
+  /// @param start       -- What beginSample() returned.
+  ////////////////////////////////////////////////////////////
+  inline void endSample(float outputValue, uint64_t start){
+    _pendingSamples++;
+    classify(outputValue, _pendingNonFinite, _pendingSaturated);
+    if (start != 0){
+      publish(0, 0, 0, filterTimestamp() - start);
+    }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Starts a filterBlock() call.
+  /// @return The start time.
+  ////////////////////////////////////////////////////////////
+  inline uint64_t beginBlock(void){ return filterTimestamp(); }
+  ////////////////////////////////////////////////////////////
+  /// @brief Finishes a filterBlock() call.
+  /// @param numSamples -- Samples in the block.
+  /// @param nonFinite  -- Outputs classify() found not finite.
+  /// @param saturated  -- Outputs classify() found saturated.
+  /// @param start      -- What beginBlock() returned.
+  ////////////////////////////////////////////////////////////
+  inline void endBlock(unsigned int numSamples, unsigned int nonFinite,
+                       unsigned int saturated, uint64_t start){
+    if (numSamples != 0){
+      publish(numSamples, nonFinite, saturated,
+              (filterTimestamp() - start)/numSamples);
+    }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Counts an output that is not finite or is at the
+  ///        saturation level. Finite outputs below the level
+  ///        take a single comparison.
+  /// @param outputValue -- The filter output.
+  /// @param nonFinite   -- Incremented for NaN or infinity.
+  /// @param saturated   -- Incremented for saturation.
+  ////////////////////////////////////////////////////////////
+  inline void classify(float outputValue, unsigned int& nonFinite,
+                       unsigned int& saturated) const {
+    if (!(std::fabs(outputValue) < _saturationLevel)){
+      if (std::isfinite(outputValue)){
+        saturated++;
+      } else {
+        nonFinite++;
+      }
+    }
+  }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Adds one update and the pending filter() counts
+  ///        to the counters inside a write of the sequence
+  ///        count.
+  /// @param numSamples -- Samples to add.
+  /// @param nonFinite  -- Non-finite outputs to add.
+  /// @param saturated  -- Saturated outputs to add.
+  /// @param ticks      -- Ticks per sample to record, or 0
+  ///                      if the update was not timed.
+  ////////////////////////////////////////////////////////////
+  inline void publish(unsigned int numSamples, unsigned int nonFinite,
+                      unsigned int saturated, uint64_t ticks){
+    const uint64_t sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    add(_samples, numSamples + _pendingSamples);
+    nonFinite += _pendingNonFinite;
+    saturated += _pendingSaturated;
+    if ((nonFinite | saturated) != 0){
+      add(_nonFinite, nonFinite);
+      add(_saturated, saturated);
+    }
+    _pendingSamples = 0;
+    _pendingNonFinite = 0;
+    _pendingSaturated = 0;
+    if (ticks != 0){
+      add(_latency[bucket(ticks)], 1);
+    }
+    _sequence.store(sequence + 2, std::memory_order_release);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Single writer increment.
+  ////////////////////////////////////////////////////////////
+  static inline void add(std::atomic<uint64_t>& counter, uint64_t amount){
+    counter.store(counter.load(std::memory_order_relaxed) + amount,
+                  std::memory_order_relaxed);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Histogram bucket of a latency, floor(log2).
+  ////////////////////////////////////////////////////////////
+  static inline unsigned int bucket(uint64_t ticks){
+    unsigned int i = 0;
+    while (ticks > 1 && i + 1 < FILTER_LATENCY_BUCKETS){
+      ticks >>= 1;
+      i++;
+    }
+    return i;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Odd while the writer is updating the counters.
+  ////////////////////////////////////////////////////////////
+  std::atomic<uint64_t> _sequence;
+  ////////////////////////////////////////////////////////////
+  /// @brief The counters; see FilterStatsSnapshot.
+  ////////////////////////////////////////////////////////////
+  std::atomic<uint64_t> _samples;
+  std::atomic<uint64_t> _nonFinite;
+  std::atomic<uint64_t> _saturated;
+  std::atomic<uint64_t> _latency[FILTER_LATENCY_BUCKETS];
+  ////////////////////////////////////////////////////////////
+  /// @brief Writer side counts of the filter() calls since
+  ///        the last publish; the call that makes it
+  ///        TIMING_PERIOD samples is timed.
+  ////////////////////////////////////////////////////////////
+  unsigned int _pendingSamples;
+  unsigned int _pendingNonFinite;
+  unsigned int _pendingSaturated;
+  ////////////////////////////////////////////////////////////
+  /// @brief Output magnitude counted as saturated.
+  ////////////////////////////////////////////////////////////
+  float _saturationLevel;
+};
+
+#endif  // FILTER_STATS_HH
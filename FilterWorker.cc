@@ -0,0 +1,134 @@
+#include "FilterWorker.hh"
+
+#include <chrono>
+
+////////////////////////////////////////////////////////////
+/// @brief Idle polls the worker yields for before it starts
+///        sleeping between polls.
+////////////////////////////////////////////////////////////
+static const unsigned int IDLE_YIELDS = 64;
+
+////////////////////////////////////////////////////////////
+/// @brief Sleep between polls once the worker has been idle
+///        for a while; bounds the added latency at low rates.
+////////////////////////////////////////////////////////////
+static const std::chrono::microseconds IDLE_SLEEP(100);
+
+////////////////////////////////////////////////////////////
+/// @brief Yields, then sleeps, as a wait drags on.
+/// @param idlePolls -- Consecutive polls that found nothing.
+////////////////////////////////////////////////////////////
+static void backOff(unsigned int& idlePolls){
+  if (idlePolls < IDLE_YIELDS){
+    idlePolls++;
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(IDLE_SLEEP);
+  }
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor creates the queues and starts the
+///        worker.
+////////////////////////////////////////////////////////////
+FilterWorker::FilterWorker(Filter& filter, unsigned int inputCapacity,
+                           unsigned int outputCapacity) :
+         _filter(filter),
+         _inputQueue(inputCapacity),
+         _outputQueue(outputCapacity),
+         _inputOverruns(0),
+         _outputStalls(0),
+         _outputDrops(0),
+         _samplesFiltered(0),
+         _stopping(false),
+         _thread()
+{
+  _thread = std::thread(&FilterWorker::run, this);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+FilterWorker::~FilterWorker() {
+  stop();
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Queues one sample, counting it if dropped.
+/// @param sample -- The input sample.
+/// @return false if the sample was dropped.
+////////////////////////////////////////////////////////////
+bool FilterWorker::submit(float sample){
+  if (_inputQueue.push(sample)){
+    return true;
+  }
+  _inputOverruns.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Queues a block, counting the samples dropped.
+/// @param samples    -- Input samples, oldest first.
+/// @param numSamples -- Number of samples.
+/// @return The number queued.
+////////////////////////////////////////////////////////////
+unsigned int FilterWorker::submitBlock(const float* samples,
+                                       unsigned int numSamples){
+  const unsigned int queued = _inputQueue.pushBlock(samples, numSamples);
+  if (queued < numSamples){
+    _inputOverruns.fetch_add(numSamples - queued, std::memory_order_relaxed);
+  }
+  return queued;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Stops and joins the worker.
+////////////////////////////////////////////////////////////
+void FilterWorker::stop(void){
+  _stopping.store(true, std::memory_order_release);
+  if (_thread.joinable()){
+    _thread.join();
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Worker loop: take a block of input, filter it and
+///        publish it, waiting for output space as needed. The
+///        stop flag is read before the input queue, so every
+///        sample submitted before stop() is filtered. Once
+///        stopping, outputs that do not fit are counted as
+///        drops instead of waited for.
+////////////////////////////////////////////////////////////
+void FilterWorker::run(void){
+  float block[MAX_BLOCK];
+  unsigned int idlePolls = 0;
+  for (;;){
+    const bool stopping = _stopping.load(std::memory_order_acquire);
+    const unsigned int count = _inputQueue.popBlock(block, MAX_BLOCK);
+    if (count == 0){
+      if (stopping){
+        return;
+      }
+      backOff(idlePolls);
+      continue;
+    }
+    idlePolls = 0;
+    _filter.filterBlock(block, block, count);
+    _samplesFiltered.fetch_add(count, std::memory_order_relaxed);
+
+    unsigned int published = _outputQueue.pushBlock(block, count);
+    if (published < count){
+      _outputStalls.fetch_add(1, std::memory_order_relaxed);
+      unsigned int stallPolls = 0;
+      while (published < count &&
+             !_stopping.load(std::memory_order_acquire)){
+        backOff(stallPolls);
+        published += _outputQueue.pushBlock(block + published,
+                                            count - published);
+      }
+      if (published < count){
+        _outputDrops.fetch_add(count - published, std::memory_order_relaxed);
+      }
+    }
+  }
+}
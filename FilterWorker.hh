@@ -0,0 +1,175 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class runs a filter on its own thread, fed
+///          and drained through lock free queues, so the
+///          acquisition loop never waits on filtering.
+///
+///////////////////////////////////////////////////////////////
+#ifndef FILTER_WORKER_HH
+#define FILTER_WORKER_HH
+
+#include "Filter.hh"
+#include "SpscQueue.hh"
+
+#include <atomic>
+#include <thread>
+
+///////////////////////////////////////////////////////////////
+/// @class FilterWorker
+/// @ingroup DSP
+/// @brief Moves filtering off the acquisition thread. The
+///        acquisition thread calls submit() for each sample;
+///        a worker thread drains the input queue in blocks
+///        through Filter::filterBlock and publishes the
+///        outputs on an output queue, read with receive().
+///
+/// submit() never blocks. When the input queue is full the
+/// sample is dropped and counted as an overrun, so the
+/// acquisition loop's timing does not depend on the filter.
+/// When the output queue is full the worker stops draining
+/// input until the consumer catches up (backpressure), and
+/// counts a stall; a persistently slow consumer therefore
+/// shows up as input overruns rather than silently lost
+/// outputs.
+///
+/// stop() does not wait for the consumer: outputs that find
+/// the output queue full once stop() has been called are
+/// dropped and counted, see GetOutputDrops(). Every sample
+/// accepted by submit() is therefore either received or
+/// counted there.
+///
+/// Exactly one thread may call submit() and one thread may
+/// call receive(). While the worker runs the filter belongs
+/// to it and must not be touched by other threads.
+///
+/// @code
+///   FilterWorker worker(lowPass, 1024, 1024);
+///   // acquisition thread, 500 Hz:
+///   worker.submit(readSensor());
+///   // consumer thread:
+///   float y;
+///   while (worker.receive(y)) { log(y); }
+/// @endcode
+///////////////////////////////////////////////////////////////
+class FilterWorker {
+
+ public:
+  ////////////////////////////////////////////////////////////
+  /// @brief Most samples the worker filters in one block.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int MAX_BLOCK = 256;
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor creates the queues and starts
+  ///        the worker thread.
+  /// @param filter         -- The filter to run. It may be a
+  ///                          derived filter or chain, and
+  ///                          must outlive the worker.
+  /// @param inputCapacity  -- Minimum input queue capacity.
+  /// @param outputCapacity -- Minimum output queue capacity.
+  /// @throws std::invalid_argument if a capacity is zero.
+  ////////////////////////////////////////////////////////////
+  FilterWorker(Filter& filter, unsigned int inputCapacity,
+               unsigned int outputCapacity);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the FilterWorker,
+  ///        stopping the worker thread.
+  ////////////////////////////////////////////////////////////
+  ~FilterWorker();
+  FilterWorker(const FilterWorker&) = delete;
+  FilterWorker& operator=(const FilterWorker&) = delete;
+  ////////////////////////////////////////////////////////////
+  /// @brief Producer: queues one sample for filtering.
+  /// @param sample -- The input sample.
+  /// @return false if the input queue was full and the
+  ///         sample was dropped.
+  ////////////////////////////////////////////////////////////
+  bool submit(float sample);
+  ////////////////////////////////////////////////////////////
+  /// @brief Producer: queues a block of samples. Samples that
+  ///        do not fit are dropped and counted.
+  /// @param samples    -- Input samples, oldest first.
+  /// @param numSamples -- Number of samples.
+  /// @return The number queued.
+  ////////////////////////////////////////////////////////////
+  unsigned int submitBlock(const float* samples, unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief Consumer: takes the oldest filter output.
+  /// @param output -- Receives the output.
+  /// @return false if no output is ready.
+  ////////////////////////////////////////////////////////////
+  inline bool receive(float& output){ return _outputQueue.pop(output); }
+  ////////////////////////////////////////////////////////////
+  /// @brief Consumer: takes up to maxOutputs outputs.
+  /// @param outputs    -- Receives the outputs, oldest first.
+  /// @param maxOutputs -- Capacity of outputs.
+  /// @return The number taken.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int receiveBlock(float* outputs, unsigned int maxOutputs){
+                                  return _outputQueue.popBlock(outputs, maxOutputs); }
+  ////////////////////////////////////////////////////////////
+  /// @brief Stops the worker after it has filtered every
+  ///        queued sample. Outputs that do not fit in the
+  ///        output queue at that point are dropped and
+  ///        counted in GetOutputDrops(). Idempotent.
+  ////////////////////////////////////////////////////////////
+  void stop(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the input overruns.
+  /// @return Samples dropped because the input queue was full.
+  ////////////////////////////////////////////////////////////
+  inline unsigned long GetInputOverruns(void) const {
+                                  return _inputOverruns.load(std::memory_order_relaxed); }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the output stalls.
+  /// @return Times the worker waited for output queue space.
+  ////////////////////////////////////////////////////////////
+  inline unsigned long GetOutputStalls(void) const {
+                                  return _outputStalls.load(std::memory_order_relaxed); }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the output drops.
+  /// @return Filtered samples dropped because the output
+  ///         queue was full after stop() was called.
+  ////////////////////////////////////////////////////////////
+  inline unsigned long GetOutputDrops(void) const {
+                                  return _outputDrops.load(std::memory_order_relaxed); }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the filtered count.
+  /// @return Samples the worker has filtered.
+  ////////////////////////////////////////////////////////////
+  inline unsigned long GetSamplesFiltered(void) const {
+                                  return _samplesFiltered.load(std::memory_order_relaxed); }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Worker thread body.
+  ////////////////////////////////////////////////////////////
+  void run(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief The filter run by the worker.
+  ////////////////////////////////////////////////////////////
+  Filter& _filter;
+  ////////////////////////////////////////////////////////////
+  /// @brief Samples waiting to be filtered.
+  ////////////////////////////////////////////////////////////
+  SpscQueue<float> _inputQueue;
+  ////////////////////////////////////////////////////////////
+  /// @brief Filter outputs waiting to be received.
+  ////////////////////////////////////////////////////////////
+  SpscQueue<float> _outputQueue;
+  ////////////////////////////////////////////////////////////
+  /// @brief Counters, written by one thread each.
+  ////////////////////////////////////////////////////////////
+  std::atomic<unsigned long> _inputOverruns;
+  std::atomic<unsigned long> _outputStalls;
+  std::atomic<unsigned long> _outputDrops;
+  std::atomic<unsigned long> _samplesFiltered;
+  ////////////////////////////////////////////////////////////
+  /// @brief Set to stop the worker.
+  ////////////////////////////////////////////////////////////
+  std::atomic<bool> _stopping;
+  ////////////////////////////////////////////////////////////
+  /// @brief The worker thread.
+  ////////////////////////////////////////////////////////////
+  std::thread _thread;
+};
+
+#endif  // FILTER_WORKER_HH
@@ -0,0 +1,149 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup Q15 and Q31 fixed point sample types for filtering
+///          integer ADC streams without float conversions.
+///
+///////////////////////////////////////////////////////////////
+#ifndef FIXED_POINT_HH
+#define FIXED_POINT_HH
+
+#include "SampleTraits.hh"
+
+#include <stdint.h>
+
+////////////////////////////////////////////////////////////
+/// @brief Rounds a value to the nearest integer and clamps it
+///        to [lo, hi]. Usable in constant expressions.
+////////////////////////////////////////////////////////////
+inline constexpr int64_t saturatingRound(double value,
+                                       int64_t lo, int64_t hi){
+  return value >= static_cast<double>(hi) ? hi :
+         value <= static_cast<double>(lo) ? lo :
+         static_cast<int64_t>(value >= 0.0 ? value + 0.5 : value - 0.5);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Clamps a wide integer to [lo, hi].
+////////////////////////////////////////////////////////////
+inline int64_t saturate(int64_t value, int64_t lo, int64_t hi){
+  return value > hi ? hi : (value < lo ? lo : value);
+}
+
+///////////////////////////////////////////////////////////////
+/// @class Q15
+/// @ingroup DSP
+/// @brief Signed fixed point sample with 15 fractional bits,
+///        covering [-1, 1). Filter weights for Q15 samples are
+///        32 bit with 15 fractional bits, so recursive weights
+///        such as a[1] = -1.98 are representable.
+///////////////////////////////////////////////////////////////
+struct Q15 {
+  static const int FRACTIONAL_BITS = 15;
+  int16_t raw;
+  ////////////////////////////////////////////////////////////
+  /// @brief Converts from float, rounding and saturating.
+  ////////////////////////////////////////////////////////////
+  static inline Q15 fromFloat(float value){
+    Q15 result = {static_cast<int16_t>(
+        saturatingRound(value*32768.0, INT16_MIN, INT16_MAX))};
+    return result;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Converts to float.
+  ////////////////////////////////////////////////////////////
+  inline float toFloat(void) const { return raw/32768.0f; }
+  ////////////////////////////////////////////////////////////
+  /// @brief Converts a weight to the Q15 filter weight format.
+  ///        Usable in constant expressions.
+  ////////////////////////////////////////////////////////////
+  static constexpr int32_t weight(double value){
+    return static_cast<int32_t>(
+        saturatingRound(value*32768.0, INT32_MIN, INT32_MAX));
+  }
+};
+
+///////////////////////////////////////////////////////////////
+/// @class Q31
+/// @ingroup DSP
+/// @brief Signed fixed point sample with 31 fractional bits,
+///        covering [-1, 1). Filter weights for Q31 samples are
+///        32 bit with 29 fractional bits, covering [-4, 4).
+///////////////////////////////////////////////////////////////
+struct Q31 {
+  static const int FRACTIONAL_BITS = 31;
+  static const int WEIGHT_FRACTIONAL_BITS = 29;
+  int32_t raw;
+  ////////////////////////////////////////////////////////////
+  /// @brief Converts from float, rounding and saturating.
+  ////////////////////////////////////////////////////////////
+  static inline Q31 fromFloat(float value){
+    Q31 result = {static_cast<int32_t>(
+        saturatingRound(value*2147483648.0, INT32_MIN, INT32_MAX))};
+    return result;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Converts to float.
+  ////////////////////////////////////////////////////////////
+  inline float toFloat(void) const {
+    return static_cast<float>(raw/2147483648.0);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Converts a weight to the Q31 filter weight format.
+  ///        Usable in constant expressions.
+  ////////////////////////////////////////////////////////////
+  static constexpr int32_t weight(double value){
+    return static_cast<int32_t>(
+        saturatingRound(value*536870912.0, INT32_MIN, INT32_MAX));
+  }
+};
+
+///////////////////////////////////////////////////////////////
+/// @brief Q15 arithmetic. Products of 32 bit weights and
+///        16 bit samples carry 30 fractional bits and are
+///        summed in 64 bits, so no intermediate can overflow.
+///        The output is rounded back to 15 fractional bits and
+///        saturated. a[0] must be one (Q15::weight(1.0)).
+///////////////////////////////////////////////////////////////
+template <>
+struct SampleTraits<Q15> {
+  typedef int32_t Weight;
+  typedef int64_t Accumulator;
+  static inline Accumulator product(Weight w, Q15 x){
+    return static_cast<int64_t>(w)*x.raw;
+  }
+  static inline bool isValidLeading(Weight a0){ return a0 == Q15::weight(1.0); }
+  static inline Weight normalize(Weight w, Weight){ return w; }
+  static inline bool isValidWeight(Weight){ return true; }
+  static inline Q15 output(Accumulator in, Accumulator out){
+    const int64_t half = int64_t(1) << (Q15::FRACTIONAL_BITS - 1);
+    Q15 result = {static_cast<int16_t>(saturate(
+        (in - out + half) >> Q15::FRACTIONAL_BITS, INT16_MIN, INT16_MAX))};
+    return result;
+  }
+};
+
+///////////////////////////////////////////////////////////////
+/// @brief Q31 arithmetic. Each 32x32 bit product is rounded
+///        to 31 fractional bits before it is summed in 64
+///        bits, leaving 32 bits of headroom for the sum. The
+///        output is saturated. a[0] must be one
+///        (Q31::weight(1.0)).
+///////////////////////////////////////////////////////////////
+template <>
+struct SampleTraits<Q31> {
+  typedef int32_t Weight;
+  typedef int64_t Accumulator;
+  static inline Accumulator product(Weight w, Q31 x){
+    const int64_t half = int64_t(1) << (Q31::WEIGHT_FRACTIONAL_BITS - 1);
+    return (static_cast<int64_t>(w)*x.raw + half) >> Q31::WEIGHT_FRACTIONAL_BITS;
+  }
+  static inline bool isValidLeading(Weight a0){ return a0 == Q31::weight(1.0); }
+  static inline Weight normalize(Weight w, Weight){ return w; }
+  static inline bool isValidWeight(Weight){ return true; }
+  static inline Q31 output(Accumulator in, Accumulator out){
+    Q31 result = {static_cast<int32_t>(saturate(in - out,
+                                                INT32_MIN, INT32_MAX))};
+    return result;
+  }
+};
+
+#endif  // FIXED_POINT_HH
@@ -0,0 +1,149 @@
+#include "GuardedFilter.hh"
+#include "DenormalGuard.hh"
+
+#include <cmath>
+
+constexpr float GuardedFilter::DENORMAL_OFFSET;
+
+////////////////////////////////////////////////////////////
+/// @brief Finite check for the hot loops: one comparison,
+///        false for NaN and both infinities.
+////////////////////////////////////////////////////////////
+static inline bool isFinite(float value){
+  return std::fabs(value) <= 3.40282347e+38f;
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members.
+////////////////////////////////////////////////////////////
+GuardedFilter::GuardedFilter(const std::vector<float>& inWeights,
+                             const std::vector<float>& outWeights,
+                             DenormalMode denormals,
+                             NonFinitePolicy nonFinite) :
+         Filter(inWeights, outWeights),
+         _denormals(denormals),
+         _nonFinite(nonFinite),
+         _lastInput(0.0f),
+         _counters()
+{
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+GuardedFilter::~GuardedFilter() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Zeroes both mirrored delay lines.
+////////////////////////////////////////////////////////////
+void GuardedFilter::reset(void){
+  initBuffer(_inputBuffer, 2*_numInWeights);
+  initBuffer(_outputBuffer, 2*_numOutWeights);
+  _inputHead = 0;
+  _outputHead = 0;
+  _counters.resets++;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Zeroes the event counts.
+////////////////////////////////////////////////////////////
+void GuardedFilter::ClearCounters(void){
+  _counters = FilterHealthCounters();
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Counts and, under NONFINITE_HOLD, replaces a
+///        non-finite input, then applies the offset.
+/// @param inputValue -- The input.
+/// @return The input to filter.
+////////////////////////////////////////////////////////////
+inline float GuardedFilter::screen(float inputValue){
+  if (isFinite(inputValue)){
+    _lastInput = inputValue;
+  } else {
+    _counters.nonFiniteInputs++;
+    if (_nonFinite == NONFINITE_HOLD){
+      inputValue = _lastInput;
+    }
+  }
+  return _denormals == DENORMALS_OFFSET ? inputValue + DENORMAL_OFFSET :
+                                          inputValue;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filters one sample with the guards.
+/// @param inputValue input value.
+/// @return Output from the filter
+////////////////////////////////////////////////////////////
+float GuardedFilter::filter(float inputValue){
+  float outputValue;
+  if (_denormals == DENORMALS_FLUSH){
+    DenormalGuard flushDenormals;
+    outputValue = Filter::filter(screen(inputValue));
+  } else {
+    outputValue = Filter::filter(screen(inputValue));
+  }
+  if (!isFinite(outputValue)){
+    _counters.nonFiniteOutputs++;
+    if (_nonFinite != NONFINITE_PROPAGATE){
+      reset();
+      outputValue = 0.0f;
+    }
+  }
+  return outputValue;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filters the block a tile at a time, under one
+///        DenormalGuard for the whole block.
+/// @param input      -- Input samples, oldest first.
+/// @param output     -- Destination for the filter outputs.
+/// @param numSamples -- Number of samples in the block.
+////////////////////////////////////////////////////////////
+void GuardedFilter::filterBlock(const float* input, float* output,
+                                unsigned int numSamples){
+  if (_denormals == DENORMALS_FLUSH){
+    DenormalGuard flushDenormals;
+    filterTile(input, output, numSamples);
+  } else {
+    filterTile(input, output, numSamples);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Screens each tile into a local copy, which also
+///        makes in place blocks safe to refilter, runs the
+///        base class block routine over it and checks the
+///        outputs. After a non-finite output under RESET or
+///        HOLD, the state is zeroed and the rest of the tile
+///        is filtered again from the copy.
+/// @param input      -- Input samples, oldest first.
+/// @param output     -- Destination for the filter outputs.
+/// @param numSamples -- Number of samples.
+////////////////////////////////////////////////////////////
+void GuardedFilter::filterTile(const float* input, float* output,
+                               unsigned int numSamples){
+  float tile[TILE_SIZE];
+  for (unsigned int n=0; n<numSamples; n+=TILE_SIZE){
+    const unsigned int count = (numSamples - n < TILE_SIZE) ?
+                               numSamples - n : TILE_SIZE;
+    for (unsigned int i=0; i<count; i++){
+      tile[i] = screen(input[n + i]);
+    }
+    float* out = output + n;
+    Filter::filterBlock(tile, out, count);
+    for (unsigned int i=0; i<count; i++){
+      if (isFinite(out[i])){
+        continue;
+      }
+      _counters.nonFiniteOutputs++;
+      if (_nonFinite != NONFINITE_PROPAGATE){
+        reset();
+        out[i] = 0.0f;
+        Filter::filterBlock(tile + i + 1, out + i + 1, count - i - 1);
+      }
+    }
+  }
+}
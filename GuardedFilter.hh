@@ -0,0 +1,205 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class defines a filter that keeps its state
+///          numerically healthy.
+///
+///////////////////////////////////////////////////////////////
+#ifndef GUARDED_FILTER_HH
+#define GUARDED_FILTER_HH
+
+#include "Filter.hh"
+
+#include <cstdint>
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @brief How a GuardedFilter keeps its state off denormals.
+///////////////////////////////////////////////////////////////
+enum DenormalMode {
+  ////////////////////////////////////////////////////////////
+  /// @brief Nothing is done.
+  ////////////////////////////////////////////////////////////
+  DENORMALS_KEEP,
+  ////////////////////////////////////////////////////////////
+  /// @brief FTZ and DAZ are set while the filter runs; see
+  ///        DenormalGuard.
+  ////////////////////////////////////////////////////////////
+  DENORMALS_FLUSH,
+  ////////////////////////////////////////////////////////////
+  /// @brief DENORMAL_OFFSET is added to every input. This
+  ///        works without FTZ support but only for filters
+  ///        that pass DC: a high pass removes the offset and
+  ///        its state decays as before.
+  ////////////////////////////////////////////////////////////
+  DENORMALS_OFFSET
+};
+
+///////////////////////////////////////////////////////////////
+/// @brief What a GuardedFilter does about NaN and infinity.
+///////////////////////////////////////////////////////////////
+enum NonFinitePolicy {
+  ////////////////////////////////////////////////////////////
+  /// @brief They are only counted; a NaN stays in the state.
+  ////////////////////////////////////////////////////////////
+  NONFINITE_PROPAGATE,
+  ////////////////////////////////////////////////////////////
+  /// @brief A non-finite output is replaced by 0 and the
+  ///        delay lines are zeroed, so filtering restarts
+  ///        from rest with the next sample.
+  ////////////////////////////////////////////////////////////
+  NONFINITE_RESET,
+  ////////////////////////////////////////////////////////////
+  /// @brief A non-finite input is replaced by the last finite
+  ///        input before it reaches the state, so a dropout
+  ///        costs one held sample instead of a restart. An
+  ///        output that still goes non-finite (an unstable
+  ///        filter overflowing) is handled as by RESET.
+  ////////////////////////////////////////////////////////////
+  NONFINITE_HOLD
+};
+
+///////////////////////////////////////////////////////////////
+/// @brief Events a GuardedFilter has counted.
+///////////////////////////////////////////////////////////////
+struct FilterHealthCounters {
+  ////////////////////////////////////////////////////////////
+  /// @brief Inputs that were NaN or infinite.
+  ////////////////////////////////////////////////////////////
+  uint64_t nonFiniteInputs;
+  ////////////////////////////////////////////////////////////
+  /// @brief Filter outputs that were NaN or infinite, before
+  ///        the policy replaced them.
+  ////////////////////////////////////////////////////////////
+  uint64_t nonFiniteOutputs;
+  ////////////////////////////////////////////////////////////
+  /// @brief Times the delay lines were zeroed.
+  ////////////////////////////////////////////////////////////
+  uint64_t resets;
+};
+
+///////////////////////////////////////////////////////////////
+/// @class GuardedFilter
+/// @ingroup DSP
+/// @brief A Filter that guards its recursive state against
+///        the two ways it goes bad in long runs: denormals,
+///        which make every call many times slower while a
+///        feedback path decays through them during quiet
+///        periods, and NaN, which once in the output buffer
+///        feeds back into every later output.
+///
+/// The filtering itself is Filter's. filterBlock() works in
+/// tiles: each tile of input is screened into a local copy,
+/// filtered, and its outputs checked with one comparison
+/// each; the slow path only runs when something is wrong.
+/// The counters are plain integers owned by the filtering
+/// thread.
+///
+/// @code
+///   GuardedFilter lowPass(b, a, DENORMALS_FLUSH, NONFINITE_HOLD);
+///   lowPass.filterBlock(input, output, numSamples);
+///   if (lowPass.GetCounters().nonFiniteInputs != 0){ ... }
+/// @endcode
+///////////////////////////////////////////////////////////////
+class GuardedFilter : public Filter {
+
+ public:
+  ////////////////////////////////////////////////////////////
+  /// @brief Input offset of DENORMALS_OFFSET: far above the
+  ///        denormal range, far below any signal of interest.
+  ////////////////////////////////////////////////////////////
+  static constexpr float DENORMAL_OFFSET = 1e-20f;
+  ////////////////////////////////////////////////////////////
+  /// @brief Samples screened and filtered together by
+  ///        filterBlock.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int TILE_SIZE = 256;
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor sets the weights and policies.
+  /// @param inWeights  -- The input weights (b).
+  /// @param outWeights -- The output weights (a).
+  /// @param denormals  -- How denormals are avoided.
+  /// @param nonFinite  -- What is done about NaN and infinity.
+  /// @throws std::invalid_argument as Filter::SetWeights.
+  ////////////////////////////////////////////////////////////
+  GuardedFilter(const std::vector<float>& inWeights,
+                const std::vector<float>& outWeights,
+                DenormalMode denormals = DENORMALS_FLUSH,
+                NonFinitePolicy nonFinite = NONFINITE_RESET);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the GuardedFilter.
+  ////////////////////////////////////////////////////////////
+  virtual ~GuardedFilter();
+  ////////////////////////////////////////////////////////////
+  /// @brief Main filter routine, with the guards. Callers
+  ///        running many single samples with DENORMALS_FLUSH
+  ///        should hold a DenormalGuard around the loop.
+  /// @param inputValue input value.
+  /// @return Output from the filter
+  ////////////////////////////////////////////////////////////
+  virtual float filter(float inputValue);
+  ////////////////////////////////////////////////////////////
+  /// @brief Block filter routine, with the guards. Outputs
+  ///        are bit-identical to calling filter() once per
+  ///        sample.
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for the filter outputs.
+  ///                      May alias input.
+  /// @param numSamples -- Number of samples in the block.
+  ////////////////////////////////////////////////////////////
+  virtual void filterBlock(const float* input, float* output,
+                           unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief Zeroes the delay lines and counts a reset.
+  ////////////////////////////////////////////////////////////
+  void reset(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the event counts.
+  /// @return The counters.
+  ////////////////////////////////////////////////////////////
+  inline const FilterHealthCounters& GetCounters(void) const {
+                                  return _counters; }
+  ////////////////////////////////////////////////////////////
+  /// @brief Zeroes the event counts.
+  ////////////////////////////////////////////////////////////
+  void ClearCounters(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Accessor functions for the policies. They may be
+  ///        changed between calls.
+  ////////////////////////////////////////////////////////////
+  inline DenormalMode GetDenormalMode(void) const { return _denormals; }
+  inline void SetDenormalMode(DenormalMode mode){ _denormals = mode; }
+  inline NonFinitePolicy GetNonFinitePolicy(void) const {
+                                  return _nonFinite; }
+  inline void SetNonFinitePolicy(NonFinitePolicy policy){
+                                  _nonFinite = policy; }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Counts a non-finite input and applies the hold
+  ///        policy to it.
+  /// @param inputValue -- The input.
+  /// @return The input to filter.
+  ////////////////////////////////////////////////////////////
+  inline float screen(float inputValue);
+  ////////////////////////////////////////////////////////////
+  /// @brief Screens and filters one tile.
+  ////////////////////////////////////////////////////////////
+  void filterTile(const float* input, float* output, unsigned int count);
+  ////////////////////////////////////////////////////////////
+  /// @brief How denormals are avoided.
+  ////////////////////////////////////////////////////////////
+  DenormalMode _denormals;
+  ////////////////////////////////////////////////////////////
+  /// @brief What is done about NaN and infinity.
+  ////////////////////////////////////////////////////////////
+  NonFinitePolicy _nonFinite;
+  ////////////////////////////////////////////////////////////
+  /// @brief Last finite input, held by NONFINITE_HOLD.
+  ////////////////////////////////////////////////////////////
+  float _lastInput;
+  ////////////////////////////////////////////////////////////
+  /// @brief The event counts.
+  ////////////////////////////////////////////////////////////
+  FilterHealthCounters _counters;
+};
+
+#endif  // GUARDED_FILTER_HH
@@ -0,0 +1,86 @@
+#include "Interpolator.hh"
+
+#include <cmath>
+#include <stdexcept>
+
+////////////////////////////////////////////////////////////
+/// @brief Rejects empty or non-finite taps and a zero factor.
+/// @param taps   -- The FIR weights.
+/// @param factor -- Outputs per input.
+/// @return The tap count.
+////////////////////////////////////////////////////////////
+static unsigned int checkedTapCount(const std::vector<float>& taps,
+                                    unsigned int factor){
+  if (factor == 0){
+    throw std::invalid_argument("Interpolator factor must be nonzero");
+  }
+  if (taps.empty()){
+    throw std::invalid_argument("Interpolator needs at least one tap");
+  }
+  for (size_t i=0; i<taps.size(); i++){
+    if (!std::isfinite(taps[i])){
+      throw std::invalid_argument("Interpolator taps must be finite");
+    }
+  }
+  return static_cast<unsigned int>(taps.size());
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members.
+////////////////////////////////////////////////////////////
+Interpolator::Interpolator(const std::vector<float>& taps,
+                           unsigned int factor) :
+         _factor(factor),
+         _numTaps(checkedTapCount(taps, factor)),
+         _phaseLength((_numTaps + factor - 1)/factor),
+         _phases(static_cast<size_t>(factor)*_phaseLength, 0.0f),
+         _history(2*_phaseLength, 0.0f),
+         _head(0)
+{
+  for (unsigned int i=0; i<_numTaps; i++){
+    _phases[(i % factor)*_phaseLength + i/factor] = taps[i];
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+Interpolator::~Interpolator() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Zeroes the history.
+////////////////////////////////////////////////////////////
+void Interpolator::reset(void){
+  _history.assign(_history.size(), 0.0f);
+  _head = 0;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Output p after input n is the sum over k of
+///        h[p + k*L] x[n - k]: phase p against the history.
+/// @param input      -- Input samples, oldest first.
+/// @param output     -- Destination for the outputs.
+/// @param numSamples -- Number of input samples.
+////////////////////////////////////////////////////////////
+void Interpolator::filterBlock(const float* input, float* output,
+                               unsigned int numSamples){
+  const unsigned int length = _phaseLength;
+  float* history = &_history[0];
+  for (unsigned int n=0; n<numSamples; n++){
+    _head = (_head == 0 ? length : _head) - 1;
+    history[_head] = input[n];
+    history[_head + length] = input[n];
+    const float* newest = history + _head;
+    const float* phase = &_phases[0];
+    for (unsigned int p=0; p<_factor; p++){
+      float sum = 0.0f;
+      for (unsigned int k=0; k<length; k++){
+        sum += phase[k]*newest[k];
+      }
+      *output++ = sum;
+      phase += length;
+    }
+  }
+}
@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class defines an interpolating FIR filter
+///          that never multiplies by the inserted zeros.
+///
+///////////////////////////////////////////////////////////////
+#ifndef INTERPOLATOR_HH
+#define INTERPOLATOR_HH
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @class Interpolator
+/// @ingroup DSP
+/// @brief Upsamples by an integer factor L and low pass
+///        filters. The output is what a direct form Filter
+///        built from the same b weights (a = {1}) would give
+///        for the input with L-1 zeros after every sample.
+///        The taps are split into L phases, h[p], h[p+L], ...,
+///        and output p of each input's L outputs applies phase
+///        p to the input history alone, so the zeros cost
+///        nothing and the work per output drops by L.
+///
+/// Zero stuffing divides the signal's gain by L; scale the taps
+/// by L for a unity gain interpolator.
+///
+/// @code
+///   Interpolator toDisplay(lowPass, 4);
+///   std::vector<float> upsampled(4*numSamples);
+///   toDisplay.filterBlock(input, &upsampled[0], numSamples);
+/// @endcode
+///////////////////////////////////////////////////////////////
+class Interpolator {
+
+ public:
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor splits the taps into phases and
+  ///        zeroes the history.
+  /// @param taps   -- The FIR weights (b), at the output rate.
+  /// @param factor -- Outputs per input, at least 1.
+  /// @throws std::invalid_argument if there are no taps, a
+  ///         tap is not finite, or the factor is zero.
+  ////////////////////////////////////////////////////////////
+  Interpolator(const std::vector<float>& taps, unsigned int factor);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the Interpolator.
+  ////////////////////////////////////////////////////////////
+  ~Interpolator();
+  ////////////////////////////////////////////////////////////
+  /// @brief Upsamples and filters a block of inputs.
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for GetFactor() outputs
+  ///                      per input. Must not overlap input.
+  /// @param numSamples -- Number of input samples.
+  ////////////////////////////////////////////////////////////
+  void filterBlock(const float* input, float* output,
+                   unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief Zeroes the history.
+  ////////////////////////////////////////////////////////////
+  void reset(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the factor.
+  /// @return Outputs per input.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetFactor(void) const { return _factor; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the tap count.
+  /// @return Number of FIR weights.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetNumTaps(void) const { return _numTaps; }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Outputs per input.
+  ////////////////////////////////////////////////////////////
+  unsigned int _factor;
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of FIR weights.
+  ////////////////////////////////////////////////////////////
+  unsigned int _numTaps;
+  ////////////////////////////////////////////////////////////
+  /// @brief Taps per phase, ceil(_numTaps/_factor).
+  ////////////////////////////////////////////////////////////
+  unsigned int _phaseLength;
+  ////////////////////////////////////////////////////////////
+  /// @brief Phase p's taps h[p + k*_factor] at
+  ///        p*_phaseLength + k, zero past the last tap.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> _phases;
+  ////////////////////////////////////////////////////////////
+  /// @brief The last _phaseLength inputs, stored twice over so
+  ///        that they read newest first from _history[_head]
+  ///        without wrapping.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> _history;
+  ////////////////////////////////////////////////////////////
+  /// @brief Position of the newest input in _history.
+  ////////////////////////////////////////////////////////////
+  unsigned int _head;
+};
+
+#endif  // INTERPOLATOR_HH
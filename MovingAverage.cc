@@ -0,0 +1,129 @@
+#include "MovingAverage.hh"
+
+#include <stdexcept>
+#include <vector>
+
+////////////////////////////////////////////////////////////
+/// @brief Checks the window length before the window is
+///        allocated.
+/// @param windowLength -- Number of inputs averaged.
+/// @return windowLength.
+////////////////////////////////////////////////////////////
+static unsigned int checkedWindow(unsigned int windowLength){
+  if (windowLength == 0){
+    throw std::invalid_argument("MovingAverage window length must be "
+                                "nonzero");
+  }
+  return windowLength;
+}
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members.
+////////////////////////////////////////////////////////////
+MovingAverage::MovingAverage(unsigned int windowLength) :
+         Filter(std::vector<float>(checkedWindow(windowLength),
+                                   1.0f/windowLength),
+                std::vector<float>(1, 1.0f)),
+         _sinceResum(0),
+         _sum(0.0),
+         _scale(1.0/windowLength)
+{
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+MovingAverage::~MovingAverage() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Rejects new weights.
+////////////////////////////////////////////////////////////
+void MovingAverage::SetWeights(unsigned int, const float*,
+                               unsigned int, const float*){
+  throw std::invalid_argument("MovingAverage weights are fixed by its "
+                              "window length");
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Zeroes the window, the last output and the sum.
+////////////////////////////////////////////////////////////
+void MovingAverage::reset(void){
+  initBuffer(_inputBuffer, 2*_numInWeights);
+  initBuffer(_outputBuffer, 2*_numOutWeights);
+  _inputHead = 0;
+  _outputHead = 0;
+  _sinceResum = 0;
+  _sum = 0.0;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Sums the window, newest input first.
+////////////////////////////////////////////////////////////
+void MovingAverage::resum(void){
+  const float* window = &_inputBuffer[_inputHead];
+  double exact = 0.0;
+  for (unsigned int i=0; i<_numInWeights; i++){
+    exact += window[i];
+  }
+  _sum = exact;
+  _sinceResum = 0;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Picks up a window written by RestoreState or
+///        SetSteadyState.
+////////////////////////////////////////////////////////////
+void MovingAverage::delayLinesChanged(void){
+  resum();
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Updates the running sum. The window is the base
+///        class's mirrored input delay line: the slot the new
+///        head moves onto holds the input leaving the window.
+///        Once per window length the sum is recomputed from
+///        the window so that its rounding error never outlives
+///        one window. The output delay line holds the output,
+///        as in Filter::filter.
+/// @param inputValue input value.
+/// @return Output from the filter
+////////////////////////////////////////////////////////////
+inline float MovingAverage::step(float inputValue){
+  const unsigned int length = _numInWeights;
+  _inputHead = (_inputHead == 0 ? length : _inputHead) - 1;
+  _sum += static_cast<double>(inputValue) - _inputBuffer[_inputHead];
+  _inputBuffer[_inputHead] = inputValue;
+  _inputBuffer[_inputHead + length] = inputValue;
+  if (++_sinceResum == length){
+    resum();
+  }
+  const float outputValue = static_cast<float>(_sum*_scale);
+  _outputBuffer[0] = outputValue;
+  _outputBuffer[1] = outputValue;
+  return outputValue;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filters one sample.
+/// @param inputValue input value.
+/// @return Output from the filter
+////////////////////////////////////////////////////////////
+float MovingAverage::filter(float inputValue){
+  return step(inputValue);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filters the block one sample at a time without the
+///        virtual call per sample.
+/// @param input      -- Input samples, oldest first.
+/// @param output     -- Destination for the filter outputs.
+/// @param numSamples -- Number of samples in the block.
+////////////////////////////////////////////////////////////
+void MovingAverage::filterBlock(const float* input, float* output,
+                                unsigned int numSamples){
+  for (unsigned int n=0; n<numSamples; n++){
+    output[n] = step(input[n]);
+  }
+}
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class defines a moving average filter of any
+///          window length, computed from a running sum.
+///
+///////////////////////////////////////////////////////////////
+#ifndef MOVING_AVERAGE_HH
+#define MOVING_AVERAGE_HH
+
+#include "Filter.hh"
+
+///////////////////////////////////////////////////////////////
+/// @class MovingAverage
+/// @ingroup DSP
+/// @brief Mean of the last N inputs, at a constant cost per
+///        sample whatever N is: each sample adds the newest
+///        input to a running sum and subtracts the one leaving
+///        the window. Its outputs match a direct form Filter
+///        with N weights of 1/N, starting from zeroed history.
+///        Those weights are what the base Filter holds, and
+///        the window is its input delay line, so the weight
+///        accessors, FilterAnalysis and SaveState/RestoreState
+///        describe the filter as it runs. SetWeights is
+///        rejected: the window length fixes the weights.
+///
+/// The running sum is kept in double precision and recomputed
+/// exactly from the window once every N samples, so rounding
+/// cannot build up over long runs; the recomputation costs one
+/// addition per sample on average.
+///
+/// @code
+///   MovingAverage smoother(1000);
+///   smoother.filterBlock(input, output, numSamples);
+/// @endcode
+///////////////////////////////////////////////////////////////
+class MovingAverage : public Filter {
+
+ public:
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor builds the filter with zeroed
+  ///        history.
+  /// @param windowLength -- Number of inputs averaged.
+  /// @throws std::invalid_argument if windowLength is zero.
+  ////////////////////////////////////////////////////////////
+  explicit MovingAverage(unsigned int windowLength);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the MovingAverage.
+  ////////////////////////////////////////////////////////////
+  virtual ~MovingAverage();
+  ////////////////////////////////////////////////////////////
+  /// @brief Main filter routine.
+  /// @param inputValue input value.
+  /// @return Output from the filter
+  ////////////////////////////////////////////////////////////
+  virtual float filter(float inputValue);
+  ////////////////////////////////////////////////////////////
+  /// @brief Block filter routine. Outputs are bit-identical
+  ///        to calling filter() once per sample.
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for the filter outputs.
+  ///                      May alias input.
+  /// @param numSamples -- Number of samples in the block.
+  ////////////////////////////////////////////////////////////
+  virtual void filterBlock(const float* input, float* output,
+                           unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief Always throws: the weights are N weights of 1/N.
+  /// @throws std::invalid_argument always.
+  ////////////////////////////////////////////////////////////
+  virtual void SetWeights(unsigned int numInWeights, const float* inWeights,
+                          unsigned int numOutWeights,
+                          const float* outWeights);
+  ////////////////////////////////////////////////////////////
+  /// @brief Zeroes the window.
+  ////////////////////////////////////////////////////////////
+  void reset(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the window length.
+  /// @return Number of inputs averaged.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int GetWindowLength(void) const {
+                                  return _numInWeights; }
+
+ protected:
+  ////////////////////////////////////////////////////////////
+  /// @brief Recomputes the sum from a restored window.
+  ////////////////////////////////////////////////////////////
+  virtual void delayLinesChanged(void);
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Filters one sample.
+  ////////////////////////////////////////////////////////////
+  inline float step(float inputValue);
+  ////////////////////////////////////////////////////////////
+  /// @brief Recomputes the sum exactly from the window.
+  ////////////////////////////////////////////////////////////
+  void resum(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Inputs since the sum was last recomputed.
+  ////////////////////////////////////////////////////////////
+  unsigned int _sinceResum;
+  ////////////////////////////////////////////////////////////
+  /// @brief Sum of the inputs in the window.
+  ////////////////////////////////////////////////////////////
+  double _sum;
+  ////////////////////////////////////////////////////////////
+  /// @brief 1/GetWindowLength().
+  ////////////////////////////////////////////////////////////
+  double _scale;
+};
+
+#endif  // MOVING_AVERAGE_HH
@@ -1,17 +1,32 @@
 #include "MovingAvg3rdOrder.hh"
 
+////////////////////////////////////////////////////////////
+/// @brief Filter weights, fixed at compile time.
+////////////////////////////////////////////////////////////
+static constexpr StaticFilter<3, 1>::Coefficients kWeights = {
+  {0.33333f, 0.33333f, 0.33333f},
+  {1.0f}
+};
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the filter weights
+///        necessary for a three point moving average.
+////////////////////////////////////////////////////////////
+StaticMovingAvg3rdOrder::StaticMovingAvg3rdOrder() :
+         StaticFilter<3, 1>(kWeights)
+{
+}
+
 //////////////////////////////////////////////////////////
 /// @brief The c'tor constructs the filter weights
 ///        necessary for a three point moving average.
 ////////////////////////////////////////////////////////////
-MovingAvg3rdOrder::MovingAvg3rdOrder()
+MovingAvg3rdOrder::MovingAvg3rdOrder() :
+         Filter(std::vector<float>(kWeights.inputWeights,
+                                   kWeights.inputWeights + 3),
+                std::vector<float>(kWeights.outputWeights,
+                                   kWeights.outputWeights + 1))
 {
-  _numInWeights = 3;
-  _numOutWeights = 1;
-  _inputWeights[0] = 0.33333;
-  _inputWeights[1] = 0.33333;
-  _inputWeights[2] = 0.33333;
-  _outputWeights[0]   = 1;
 }
 
 ////////////////////////////////////////////////////////////
@@ -20,3 +35,23 @@ MovingAvg3rdOrder::MovingAvg3rdOrder()
 MovingAvg3rdOrder::~MovingAvg3rdOrder() {
 
 }
+
+////////////////////////////////////////////////////////////
+/// @brief Three tap FIR block loop.
+/// @param input      -- Input samples, oldest first.
+/// @param output     -- Destination for the filter outputs.
+/// @param numSamples -- Number of samples in the block.
+////////////////////////////////////////////////////////////
+void MovingAvg3rdOrder::filterBlock(const float* input, float* output,
+                                    unsigned int numSamples) {
+  staticFilterBlock<StaticFilter<3, 1> >(input, output, numSamples);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief staticFilterBlock runs the same equation as
+///        Filter::filter.
+/// @return true.
+////////////////////////////////////////////////////////////
+bool MovingAvg3rdOrder::IsDifferenceEquation(void) const {
+  return true;
+}
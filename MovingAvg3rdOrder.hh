@@ -1,7 +1,8 @@
 ///////////////////////////////////////////////////////////////
 /// @ingroup This class defines a three point moving average
 ///          filter. It derives from the generic digital
-///          Filter base class.
+///          Filter base class. A compile time StaticFilter
+///          version is defined alongside it.
 ///
 /// @author
 ///         $Author: Mike Moore $
@@ -15,6 +16,25 @@
 #define MOVING_AVG_3RD_ORDER_HH
 
 #include "Filter.hh"
+#include "StaticFilter.hh"
+
+///////////////////////////////////////////////////////////////
+/// @class StaticMovingAvg3rdOrder
+/// @ingroup DSP
+/// @brief Three point moving average as a StaticFilter, for
+///        use where the tap counts must be known at compile
+///        time, such as a StaticFilterChain stage.
+///////////////////////////////////////////////////////////////
+class StaticMovingAvg3rdOrder : public StaticFilter<3, 1> {
+
+ public:
+  //////////////////////////////////////////////////////////
+  /// @brief The default c'tor constructs the
+  ///        StaticMovingAvg3rdOrder class
+  ////////////////////////////////////////////////////////////
+  StaticMovingAvg3rdOrder();
+
+};
 
 ///////////////////////////////////////////////////////////////
 /// @class MovingAvg3rdOrder class defines a three point
@@ -35,6 +55,22 @@ class MovingAvg3rdOrder : public Filter {
   ///        MovingAvg3rdOrder class
   ////////////////////////////////////////////////////////////
   ~MovingAvg3rdOrder();
+  ////////////////////////////////////////////////////////////
+  /// @brief Block filter routine specialized for this
+  ///        filter's fixed tap counts. The block runs through
+  ///        a StaticMovingAvg3rdOrder loaded from this
+  ///        filter's state (see Filter::staticFilterBlock).
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for the filter outputs.
+  /// @param numSamples -- Number of samples in the block.
+  ////////////////////////////////////////////////////////////
+  virtual void filterBlock(const float* input, float* output,
+                           unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief The block routine is the difference equation.
+  /// @return true.
+  ////////////////////////////////////////////////////////////
+  virtual bool IsDifferenceEquation(void) const;
 
 };
 
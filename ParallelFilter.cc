@@ -0,0 +1,210 @@
+#include "ParallelFilter.hh"
+
+#include <algorithm>
+#include <climits>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////
+/// @brief Samples handed to filterBlock at a time, which
+///        keeps the count inside its unsigned int.
+////////////////////////////////////////////////////////////
+static const size_t SERIAL_BLOCK = 1u << 20;
+
+////////////////////////////////////////////////////////////
+/// @brief Square matrix in row major order.
+////////////////////////////////////////////////////////////
+typedef std::vector<double> Matrix;
+
+////////////////////////////////////////////////////////////
+/// @brief Product of two order by order matrices.
+////////////////////////////////////////////////////////////
+static Matrix multiply(const Matrix& left, const Matrix& right,
+                       unsigned int order){
+  Matrix product(order*order, 0.0);
+  for (unsigned int i=0; i<order; i++){
+    for (unsigned int k=0; k<order; k++){
+      const double l = left[i*order + k];
+      for (unsigned int j=0; j<order; j++){
+        product[i*order + j] += l*right[k*order + j];
+      }
+    }
+  }
+  return product;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The zero input response over a whole chunk: the
+///        companion matrix of the output weights, which maps
+///        [y[n-1] ... y[n-order]] to the same one sample on,
+///        raised to the chunk length by repeated squaring.
+/// @param a      -- Normalized output weights, order + 1.
+/// @param order  -- Number of past outputs in the state.
+/// @param length -- Samples in the chunk.
+////////////////////////////////////////////////////////////
+static Matrix zeroInputResponse(const float* a, unsigned int order,
+                                size_t length){
+  Matrix step(order*order, 0.0);
+  for (unsigned int k=0; k<order; k++){
+    step[k] = -static_cast<double>(a[k + 1]);
+  }
+  for (unsigned int i=1; i<order; i++){
+    step[i*order + i - 1] = 1.0;
+  }
+  Matrix power(order*order, 0.0);
+  for (unsigned int i=0; i<order; i++){
+    power[i*order + i] = 1.0;
+  }
+  for (; length != 0; length >>= 1){
+    if (length & 1){
+      power = multiply(power, step, order);
+    }
+    step = multiply(step, step, order);
+  }
+  return power;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief filterBlock over any number of samples.
+////////////////////////////////////////////////////////////
+static void filterSpan(Filter& filter, const float* input, float* output,
+                       size_t numSamples){
+  for (size_t n=0; n<numSamples; n+=SERIAL_BLOCK){
+    filter.filterBlock(input + n, output + n, static_cast<unsigned int>(
+        std::min(SERIAL_BLOCK, numSamples - n)));
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filters a span only for the state it ends in,
+///        through a small scratch buffer.
+////////////////////////////////////////////////////////////
+static void runSpan(Filter& filter, const float* input, size_t numSamples){
+  float scratch[1024];
+  for (size_t n=0; n<numSamples; n+=1024){
+    filter.filterBlock(input + n, scratch, static_cast<unsigned int>(
+        std::min<size_t>(1024, numSamples - n)));
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Chunk boundaries, the first chunk being two units
+///        long and the others one.
+////////////////////////////////////////////////////////////
+static std::vector<size_t> chunkStarts(size_t numSamples,
+                                       unsigned int numChunks){
+  std::vector<size_t> starts(numChunks + 1);
+  const size_t units = numChunks + 1;
+  for (unsigned int c=0; c<numChunks; c++){
+    starts[c] = (c == 0) ? 0 : numSamples*(c + 1)/units;
+  }
+  starts[numChunks] = numSamples;
+  return starts;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Three passes: the first chunk for real and the
+///        others from zero output history in parallel, the
+///        true start states serially, then the other chunks
+///        again in parallel.
+////////////////////////////////////////////////////////////
+void filterParallel(Filter& filter, const float* input, float* output,
+                    size_t numSamples, unsigned int numThreads){
+  if (!filter.IsDifferenceEquation()){
+    throw std::invalid_argument("filterParallel needs a filter that is "
+                                "its difference equation");
+  }
+  if (numThreads == 0){
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const unsigned int numChunks = static_cast<unsigned int>(std::min<size_t>(
+      numThreads, numSamples/PARALLEL_MIN_CHUNK));
+  if (numChunks < 2){
+    filterSpan(filter, input, output, numSamples);
+    return;
+  }
+  const unsigned int numIn = filter.GetNumInWeights();
+  const unsigned int numOut = filter.GetNumOutWeights();
+  const unsigned int order = numOut - 1;
+  const std::vector<size_t> starts = chunkStarts(numSamples, numChunks);
+
+  /// Each chunk's input history, and the one the whole signal
+  /// ends with, read before anything is written to output.
+  std::vector<float> initialInputs(numIn), initialOutputs(numOut);
+  filter.GetInputBufferSnapshot(&initialInputs[0]);
+  filter.GetOutputBufferSnapshot(&initialOutputs[0]);
+  std::vector<std::vector<float> > inputHistory(numChunks + 1,
+                                                std::vector<float>(numIn));
+  for (unsigned int c=0; c<=numChunks; c++){
+    for (unsigned int i=0; i<numIn; i++){
+      inputHistory[c][i] = (starts[c] > i) ? input[starts[c] - 1 - i] :
+                           initialInputs[i - starts[c]];
+    }
+  }
+
+  std::vector<Filter> chunks(numChunks, filter);
+  const std::vector<float> zeroOutputs(numOut, 0.0f);
+  std::vector<std::vector<float> > endOutputs(numChunks,
+                                              std::vector<float>(numOut));
+  std::vector<std::thread> threads;
+  for (unsigned int c=1; c<numChunks; c++){
+    threads.push_back(std::thread([&, c](){
+      chunks[c].RestoreBufferSnapshot(&inputHistory[c][0],
+                                      order ? &zeroOutputs[0] :
+                                              &initialOutputs[0]);
+      if (order == 0){
+        filterSpan(chunks[c], input + starts[c], output + starts[c],
+                   starts[c + 1] - starts[c]);
+      } else {
+        runSpan(chunks[c], input + starts[c], starts[c + 1] - starts[c]);
+        chunks[c].GetOutputBufferSnapshot(&endOutputs[c][0]);
+      }
+    }));
+  }
+  filterSpan(chunks[0], input, output, starts[1]);
+  chunks[0].GetOutputBufferSnapshot(&endOutputs[0][0]);
+  for (size_t t=0; t<threads.size(); t++){
+    threads[t].join();
+  }
+
+  if (order != 0){
+    /// Chunk c starts where chunk c-1 ended: its zero history
+    /// end plus the zero input response to its own start.
+    std::vector<std::vector<float> > startOutputs(numChunks,
+                                                  std::vector<float>(numOut));
+    startOutputs[1] = endOutputs[0];
+    Matrix response;
+    size_t responseLength = 0;
+    for (unsigned int c=2; c<numChunks; c++){
+      const size_t length = starts[c] - starts[c - 1];
+      if (length != responseLength){
+        response = zeroInputResponse(filter.GetOutputWeights(), order, length);
+        responseLength = length;
+      }
+      for (unsigned int i=0; i<numOut; i++){
+        double value = endOutputs[c - 1][i];
+        if (i < order){
+          for (unsigned int j=0; j<order; j++){
+            value += response[i*order + j]*startOutputs[c - 1][j];
+          }
+        }
+        startOutputs[c][i] = static_cast<float>(value);
+      }
+    }
+    threads.clear();
+    for (unsigned int c=1; c<numChunks; c++){
+      threads.push_back(std::thread([&, c](){
+        chunks[c].RestoreBufferSnapshot(&inputHistory[c][0],
+                                        &startOutputs[c][0]);
+        filterSpan(chunks[c], input + starts[c], output + starts[c],
+                   starts[c + 1] - starts[c]);
+      }));
+    }
+    for (size_t t=0; t<threads.size(); t++){
+      threads[t].join();
+    }
+  }
+  std::vector<float> finalOutputs(numOut);
+  chunks[numChunks - 1].GetOutputBufferSnapshot(&finalOutputs[0]);
+  filter.RestoreBufferSnapshot(&inputHistory[numChunks][0], &finalOutputs[0]);
+}
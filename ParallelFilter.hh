@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This file filters one long signal on several
+///          threads at once, IIR recursion included.
+///
+///////////////////////////////////////////////////////////////
+#ifndef PARALLEL_FILTER_HH
+#define PARALLEL_FILTER_HH
+
+#include "Filter.hh"
+
+#include <cstddef>
+#include <stdexcept>
+
+////////////////////////////////////////////////////////////
+/// @brief Fewest samples per thread worth starting a thread
+///        for; shorter signals are filtered serially.
+////////////////////////////////////////////////////////////
+static const size_t PARALLEL_MIN_CHUNK = 65536;
+
+////////////////////////////////////////////////////////////
+/// @brief Runs a long signal through a filter on several
+///        threads, for offline batches. The result equals
+///        filter.filterBlock() over the whole signal to within
+///        rounding, and the filter is left in the state the
+///        serial call would leave it in.
+///
+/// The signal is cut into one chunk per thread. A chunk's
+/// input history is just the inputs before it, so only the
+/// output history, the recursive state, is unknown when it
+/// starts. Every chunk but the first is filtered once from a
+/// zero output history to find how it ends. The state a chunk
+/// ends in is that end plus the zero input response to the
+/// state it started in, which is a fixed linear map of the
+/// start state (the state space matrix raised to the chunk
+/// length), so the true start state of each chunk follows
+/// from its predecessor's in a short serial pass. The chunks
+/// are then filtered again, in parallel, from their true
+/// states. The first chunk starts from the filter's own state
+/// and is filtered only once, so it is made twice as long:
+/// with T threads the batch takes about 2/(T+1) of the serial
+/// time. FIR filters need no second pass.
+///
+/// The restarted chunks round differently from a serial run,
+/// by about as much as the float direct form's own rounding
+/// error, which is large for high order filters with poles
+/// near 1.
+///
+/// @code
+///   Filter lowPass(b, a);
+///   filterParallel(lowPass, &capture[0], &capture[0], capture.size());
+/// @endcode
+/// @param filter     -- The filter. Its IsDifferenceEquation()
+///                      must be true: other derived classes'
+///                      recursion is not known from their
+///                      weights.
+/// @param input      -- Input samples, oldest first.
+/// @param output     -- Destination for the filter outputs.
+///                      May alias input.
+/// @param numSamples -- Number of samples.
+/// @param numThreads -- Threads to use; zero for one per
+///                      hardware thread.
+/// @throws std::invalid_argument if filter is not its
+///         difference equation.
+////////////////////////////////////////////////////////////
+void filterParallel(Filter& filter, const float* input, float* output,
+                    size_t numSamples, unsigned int numThreads = 0);
+
+#endif  // PARALLEL_FILTER_HH
@@ -0,0 +1,356 @@
+#include "Polynomial.hh"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+////////////////////////////////////////////////////////////
+/// The eigenvalue solver below follows the textbook
+/// descriptions in
+///
+///   G. H. Golub and C. F. Van Loan, Matrix Computations,
+///   4th ed., Johns Hopkins University Press, 2013:
+///   Algorithm 5.1.1 (Householder vector), Algorithm 7.5.1
+///   (Francis QR step) and Section 7.5.5 (deflation).
+///
+///   B. N. Parlett and C. Reinsch, "Balancing a matrix for
+///   calculation of eigenvalues and eigenvectors",
+///   Numerische Mathematik 13, 1969, pp. 293-304.
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+/// @brief Iteration limit for one eigenvalue in the QR loop.
+////////////////////////////////////////////////////////////
+static const int MAX_QR_ITERATIONS = 60;
+
+////////////////////////////////////////////////////////////
+/// @brief A Francis step with an ad hoc shift is taken every
+///        this many iterations on a block that has not
+///        deflated, to break cycles of the standard shift.
+////////////////////////////////////////////////////////////
+static const int EXCEPTIONAL_SHIFT_PERIOD = 10;
+
+////////////////////////////////////////////////////////////
+/// @brief Dense square matrix stored by rows.
+////////////////////////////////////////////////////////////
+class SquareMatrix {
+ public:
+  explicit SquareMatrix(int n) : _n(n), _data(n*n, 0.0) {}
+  inline double& operator()(int i, int j){ return _data[i*_n + j]; }
+  inline int size(void) const { return _n; }
+ private:
+  int _n;
+  std::vector<double> _data;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Balances the matrix with a diagonal similarity
+///        transform D^-1 A D, so that each row and column
+///        carry similar weight (Parlett and Reinsch). D holds
+///        powers of two, so no rounding is introduced. This
+///        improves the accuracy of the eigenvalues.
+/// @param a -- The matrix, balanced in place.
+////////////////////////////////////////////////////////////
+static void balance(SquareMatrix& a){
+  const int n = a.size();
+  bool changed = true;
+  while (changed){
+    changed = false;
+    for (int i=0; i<n; i++){
+      double rowNorm = 0.0, colNorm = 0.0;
+      for (int j=0; j<n; j++){
+        if (j != i){
+          rowNorm += std::fabs(a(i, j));
+          colNorm += std::fabs(a(j, i));
+        }
+      }
+      if (rowNorm == 0.0 || colNorm == 0.0){
+        continue;
+      }
+      /// Scaling column i by f and row i by 1/f evens the two
+      /// norms when f = sqrt(rowNorm/colNorm). Use the nearest
+      /// power of two, and only when it shrinks their sum
+      /// noticeably, which guarantees the sweeps terminate.
+      const int exponent = static_cast<int>(
+          std::floor(0.5*std::log2(rowNorm/colNorm) + 0.5));
+      if (exponent == 0){
+        continue;
+      }
+      const double f = std::ldexp(1.0, exponent);
+      if (colNorm*f + rowNorm/f >= 0.95*(colNorm + rowNorm)){
+        continue;
+      }
+      for (int j=0; j<n; j++){
+        a(i, j) /= f;
+        a(j, i) *= f;
+      }
+      changed = true;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Computes a Householder reflector P = I - beta v v^T
+///        with v[0] = 1 that maps x onto a multiple of e1.
+/// @param x   -- The vector to reflect.
+/// @param len -- Its length, 2 or 3.
+/// @param v   -- Receives the Householder vector.
+/// @return beta, or 0 if x is already a multiple of e1.
+////////////////////////////////////////////////////////////
+static double householder(const double* x, int len, double* v){
+  double tail = 0.0;
+  for (int i=1; i<len; i++){
+    tail += x[i]*x[i];
+  }
+  v[0] = 1.0;
+  if (tail == 0.0){
+    for (int i=1; i<len; i++) v[i] = 0.0;
+    return 0.0;
+  }
+  const double norm = std::sqrt(x[0]*x[0] + tail);
+  /// Pick the form of v[0] that avoids cancellation.
+  const double head = x[0] <= 0.0 ? x[0] - norm : -tail/(x[0] + norm);
+  for (int i=1; i<len; i++){
+    v[i] = x[i]/head;
+  }
+  return 2.0*head*head/(tail + head*head);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Applies P = I - beta v v^T from the left to rows
+///        row..row+len-1, columns first..last of the matrix.
+////////////////////////////////////////////////////////////
+static void reflectRows(SquareMatrix& a, const double* v, double beta,
+                        int len, int row, int first, int last){
+  for (int j=first; j<=last; j++){
+    double dot = 0.0;
+    for (int i=0; i<len; i++) dot += v[i]*a(row + i, j);
+    dot *= beta;
+    for (int i=0; i<len; i++) a(row + i, j) -= dot*v[i];
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Applies P = I - beta v v^T from the right to
+///        columns col..col+len-1, rows first..last.
+////////////////////////////////////////////////////////////
+static void reflectColumns(SquareMatrix& a, const double* v, double beta,
+                           int len, int col, int first, int last){
+  for (int i=first; i<=last; i++){
+    double dot = 0.0;
+    for (int j=0; j<len; j++) dot += a(i, col + j)*v[j];
+    dot *= beta;
+    for (int j=0; j<len; j++) a(i, col + j) -= dot*v[j];
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Performs one implicit double shift (Francis) QR
+///        step on the unreduced Hessenberg block lo..hi,
+///        which holds at least three rows. The two shifts
+///        are the roots of z^2 - sum*z + product.
+/// @param a       -- The Hessenberg matrix.
+/// @param lo      -- First row of the block.
+/// @param hi      -- Last row of the block.
+/// @param sum     -- Sum of the two shifts.
+/// @param product -- Product of the two shifts.
+////////////////////////////////////////////////////////////
+static void francisStep(SquareMatrix& a, int lo, int hi,
+                        double sum, double product){
+  /// First column of (H - mu1 I)(H - mu2 I); only its top
+  /// three entries are nonzero.
+  double x[3];
+  x[0] = a(lo, lo)*a(lo, lo) + a(lo, lo+1)*a(lo+1, lo)
+         - sum*a(lo, lo) + product;
+  x[1] = a(lo+1, lo)*(a(lo, lo) + a(lo+1, lo+1) - sum);
+  x[2] = a(lo+1, lo)*a(lo+2, lo+1);
+  double v[3];
+  /// Chase the bulge down the subdiagonal.
+  for (int k=lo; k<=hi-2; k++){
+    const double beta = householder(x, 3, v);
+    const int left = k > lo ? k - 1 : lo;
+    reflectRows(a, v, beta, 3, k, left, hi);
+    const int bottom = k + 3 < hi ? k + 3 : hi;
+    reflectColumns(a, v, beta, 3, k, lo, bottom);
+    if (k > lo){
+      a(k+1, k-1) = 0.0;
+      a(k+2, k-1) = 0.0;
+    }
+    x[0] = a(k+1, k);
+    x[1] = a(k+2, k);
+    if (k < hi-2) x[2] = a(k+3, k);
+  }
+  const double beta = householder(x, 2, v);
+  reflectRows(a, v, beta, 2, hi-1, hi-2, hi);
+  reflectColumns(a, v, beta, 2, hi-1, lo, hi);
+  a(hi, hi-2) = 0.0;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Appends the eigenvalues of a real 2x2 block.
+///        Complex eigenvalues come out as an exact conjugate
+///        pair and real ones with a zero imaginary part.
+////////////////////////////////////////////////////////////
+static void blockEigenvalues(double p, double q, double r, double s,
+                             std::vector<std::complex<double> >& roots){
+  const double mean = 0.5*(p + s);
+  const double half = 0.5*(p - s);
+  const double disc = half*half + q*r;
+  if (disc < 0.0){
+    const double im = std::sqrt(-disc);
+    roots.push_back(std::complex<double>(mean, im));
+    roots.push_back(std::complex<double>(mean, -im));
+    return;
+  }
+  /// Take the larger root directly and the other from the
+  /// determinant, which avoids cancellation.
+  const double root = std::sqrt(disc);
+  const double large = mean >= 0.0 ? mean + root : mean - root;
+  const double small = large != 0.0 ? (p*s - q*r)/large : mean - root;
+  roots.push_back(std::complex<double>(large, 0.0));
+  roots.push_back(std::complex<double>(small, 0.0));
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Finds all eigenvalues of an upper Hessenberg matrix
+///        with the Francis double shift QR algorithm. Small
+///        subdiagonal entries are set to zero as they appear,
+///        splitting off 1x1 and 2x2 blocks from the bottom.
+/// @param a     -- The matrix. It is destroyed.
+/// @param roots -- Receives the eigenvalues.
+/// @throws std::runtime_error if the iteration does not
+///         converge.
+////////////////////////////////////////////////////////////
+static void hessenbergEigenvalues(SquareMatrix& a,
+                                  std::vector<std::complex<double> >& roots){
+  const int n = a.size();
+  double norm = 0.0;
+  for (int i=0; i<n; i++){
+    for (int j=0; j<n; j++){
+      norm += std::fabs(a(i, j));
+    }
+  }
+  const double eps = std::numeric_limits<double>::epsilon();
+  int hi = n - 1;
+  int iterations = 0;
+  while (hi >= 0){
+    /// The active block lo..hi is the largest trailing block
+    /// with no negligible subdiagonal entry.
+    int lo = hi;
+    while (lo > 0){
+      double scale = std::fabs(a(lo-1, lo-1)) + std::fabs(a(lo, lo));
+      if (scale == 0.0) scale = norm;
+      if (std::fabs(a(lo, lo-1)) <= eps*scale){
+        a(lo, lo-1) = 0.0;
+        break;
+      }
+      lo--;
+    }
+    if (lo == hi){
+      roots.push_back(std::complex<double>(a(hi, hi), 0.0));
+      hi--;
+      iterations = 0;
+    } else if (lo == hi-1){
+      blockEigenvalues(a(hi-1, hi-1), a(hi-1, hi), a(hi, hi-1), a(hi, hi),
+                       roots);
+      hi -= 2;
+      iterations = 0;
+    } else {
+      if (iterations == MAX_QR_ITERATIONS){
+        throw std::runtime_error(
+            "polynomialRoots: QR iteration did not converge");
+      }
+      ++iterations;
+      double sum, product;
+      if (iterations % EXCEPTIONAL_SHIFT_PERIOD == 0){
+        /// Ad hoc complex pair centred beside the trailing
+        /// diagonal entry, sized by the last subdiagonals.
+        const double size = std::fabs(a(hi, hi-1)) + std::fabs(a(hi-1, hi-2));
+        const double centre = a(hi, hi) + size;
+        sum = 2.0*centre;
+        product = centre*centre + size*size;
+      } else {
+        /// Standard shifts: the eigenvalues of the trailing
+        /// 2x2 block.
+        sum = a(hi-1, hi-1) + a(hi, hi);
+        product = a(hi-1, hi-1)*a(hi, hi) - a(hi-1, hi)*a(hi, hi-1);
+      }
+      francisStep(a, lo, hi, sum, product);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Finds the roots of a real polynomial.
+/// @param coeffs -- Coefficients, highest power first.
+/// @param roots  -- Receives the roots.
+////////////////////////////////////////////////////////////
+void polynomialRoots(const std::vector<double>& coeffs,
+                     std::vector<std::complex<double> >& roots){
+  roots.clear();
+  size_t first = 0;
+  while (first < coeffs.size() && coeffs[first] == 0.0){
+    first++;
+  }
+  size_t last = coeffs.size();
+  while (last > first && coeffs[last-1] == 0.0){
+    last--;
+    roots.push_back(std::complex<double>(0.0, 0.0));
+  }
+  if (last <= first + 1){
+    return;
+  }
+  /// Companion matrix of the monic polynomial: the scaled
+  /// coefficients along the first row, ones below the diagonal.
+  const int n = static_cast<int>(last - first - 1);
+  SquareMatrix a(n);
+  for (int j=0; j<n; j++){
+    a(0, j) = -coeffs[first + j + 1]/coeffs[first];
+  }
+  for (int i=1; i<n; i++){
+    a(i, i-1) = 1.0;
+  }
+  balance(a);
+  hessenbergEigenvalues(a, roots);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Multiplies two polynomials.
+/// @param lhs -- First polynomial's coefficients.
+/// @param rhs -- Second polynomial's coefficients.
+/// @return The product's coefficients.
+////////////////////////////////////////////////////////////
+std::vector<double> polynomialMultiply(const std::vector<double>& lhs,
+                                       const std::vector<double>& rhs){
+  if (lhs.empty() || rhs.empty()){
+    return std::vector<double>();
+  }
+  std::vector<double> product(lhs.size() + rhs.size() - 1, 0.0);
+  for (size_t i=0; i<lhs.size(); i++){
+    for (size_t j=0; j<rhs.size(); j++){
+      product[i + j] += lhs[i]*rhs[j];
+    }
+  }
+  return product;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Builds the monic polynomial with the given roots.
+/// @param roots -- The polynomial's roots.
+/// @return Coefficients, highest power first.
+////////////////////////////////////////////////////////////
+std::vector<double> polynomialFromRoots(
+    const std::vector<std::complex<double> >& roots){
+  std::vector<std::complex<double> > poly(1, std::complex<double>(1.0, 0.0));
+  for (size_t k=0; k<roots.size(); k++){
+    poly.push_back(std::complex<double>(0.0, 0.0));
+    for (size_t i=poly.size()-1; i>0; i--){
+      poly[i] -= roots[k]*poly[i-1];
+    }
+  }
+  std::vector<double> coeffs(poly.size());
+  for (size_t i=0; i<poly.size(); i++){
+    coeffs[i] = poly[i].real();
+  }
+  return coeffs;
+}
@@ -0,0 +1,49 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup Polynomial helpers used to factor and rebuild
+///          filter transfer functions.
+///
+///////////////////////////////////////////////////////////////
+#ifndef POLYNOMIAL_HH
+#define POLYNOMIAL_HH
+
+#include <complex>
+#include <vector>
+
+////////////////////////////////////////////////////////////
+/// @brief Finds the roots of a real polynomial as the
+///        eigenvalues of its companion matrix. The matrix is
+///        balanced and then reduced with the shifted QR
+///        algorithm for upper Hessenberg matrices. Complex
+///        roots are returned as exact conjugate pairs.
+/// @param coeffs -- Coefficients, highest power first.
+///                  Leading zeros are ignored and trailing
+///                  zeros are returned as exact roots at 0.
+/// @param roots  -- Receives the roots.
+/// @throws std::runtime_error if the QR iteration does not
+///         converge.
+////////////////////////////////////////////////////////////
+void polynomialRoots(const std::vector<double>& coeffs,
+                     std::vector<std::complex<double> >& roots);
+
+////////////////////////////////////////////////////////////
+/// @brief Multiplies two polynomials (convolves their
+///        coefficient lists).
+/// @param lhs -- First polynomial's coefficients.
+/// @param rhs -- Second polynomial's coefficients.
+/// @return The product's coefficients, in the same order.
+////////////////////////////////////////////////////////////
+std::vector<double> polynomialMultiply(const std::vector<double>& lhs,
+                                       const std::vector<double>& rhs);
+
+////////////////////////////////////////////////////////////
+/// @brief Builds the monic polynomial with the given roots.
+///        Complex roots must appear in conjugate pairs for
+///        the result to be real; the imaginary residue is
+///        dropped.
+/// @param roots -- The polynomial's roots.
+/// @return Coefficients, highest power first.
+////////////////////////////////////////////////////////////
+std::vector<double> polynomialFromRoots(
+    const std::vector<std::complex<double> >& roots);
+
+#endif  // POLYNOMIAL_HH
@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup Arithmetic policy describing how a filter stores
+///          its weights and accumulates products for a given
+///          sample type.
+///
+///////////////////////////////////////////////////////////////
+#ifndef SAMPLE_TRAITS_HH
+#define SAMPLE_TRAITS_HH
+
+#include <stdexcept>
+
+///////////////////////////////////////////////////////////////
+/// @class SampleTraits
+/// @ingroup DSP
+/// @brief Arithmetic used by StaticFilter for samples of type
+///        T. This primary template covers float and double:
+///        weights and accumulators are T itself, and the
+///        weights are divided by a[0] once at construction,
+///        as Filter does.
+///
+/// Fixed point sample types specialize this template (see
+/// FixedPoint.hh) with wider weight and accumulator types.
+/// A specialization provides:
+///   - Weight, the stored weight type,
+///   - Accumulator, the type products are summed in,
+///   - isValidLeading(a0), whether a[0] can be used,
+///   - normalize(w, a0), a weight with a[0] folded in,
+///   - isValidWeight(w), whether a normalized weight can be
+///     used,
+///   - product(w, x), one weighted sample as an Accumulator,
+///   - output(in, out), the new output sample from the input
+///     and output contributions.
+///////////////////////////////////////////////////////////////
+template <typename T>
+struct SampleTraits {
+  typedef T Weight;
+  typedef T Accumulator;
+  static inline bool isValidLeading(Weight a0){
+    return a0 != T(0) && a0 - a0 == T(0);
+  }
+  static inline Weight normalize(Weight w, Weight a0){ return w/a0; }
+  static inline bool isValidWeight(Weight w){ return w - w == T(0); }
+  static inline Accumulator product(Weight w, T x){ return w*x; }
+  static inline T output(Accumulator in, Accumulator out){ return in - out; }
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Folds a[0] into a set of weights, as every filter
+///        does once when it takes new weights. Nothing is
+///        written if the weights are rejected.
+/// @tparam Traits        -- The SampleTraits of the filter.
+/// @param numInWeights   -- Number of input weights (b).
+/// @param inWeights      -- The input weights.
+/// @param numOutWeights  -- Number of output weights (a).
+/// @param outWeights     -- The output weights.
+/// @param normInWeights  -- Receives the normalized b.
+/// @param normOutWeights -- Receives the normalized a.
+/// @throws std::invalid_argument if Traits rejects a[0], or
+///         a weight divided by a[0] is not finite, as happens
+///         when a tiny a[0] overflows it.
+////////////////////////////////////////////////////////////
+template <typename Traits>
+void normalizeWeights(unsigned int numInWeights,
+                      const typename Traits::Weight* inWeights,
+                      unsigned int numOutWeights,
+                      const typename Traits::Weight* outWeights,
+                      typename Traits::Weight* normInWeights,
+                      typename Traits::Weight* normOutWeights){
+  const typename Traits::Weight leading = outWeights[0];
+  if (!Traits::isValidLeading(leading)){
+    throw std::invalid_argument("Filter output weight a[0] must be nonzero "
+                                "and finite (one for fixed point)");
+  }
+  for (unsigned int i=0; i<numInWeights; i++){
+    if (!Traits::isValidWeight(Traits::normalize(inWeights[i], leading))){
+      throw std::invalid_argument("Filter weights must be finite after "
+                                  "normalizing by a[0]");
+    }
+  }
+  for (unsigned int i=0; i<numOutWeights; i++){
+    if (!Traits::isValidWeight(Traits::normalize(outWeights[i], leading))){
+      throw std::invalid_argument("Filter weights must be finite after "
+                                  "normalizing by a[0]");
+    }
+  }
+  for (unsigned int i=0; i<numInWeights; i++){
+    normInWeights[i] = Traits::normalize(inWeights[i], leading);
+  }
+  for (unsigned int i=0; i<numOutWeights; i++){
+    normOutWeights[i] = Traits::normalize(outWeights[i], leading);
+  }
+}
+
+#endif  // SAMPLE_TRAITS_HH
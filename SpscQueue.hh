@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup Lock free single producer, single consumer ring
+///          queue for handing samples between threads.
+///
+///////////////////////////////////////////////////////////////
+#ifndef SPSC_QUEUE_HH
+#define SPSC_QUEUE_HH
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @class SpscQueue
+/// @ingroup DSP
+/// @brief Bounded ring queue for exactly one producer thread
+///        and one consumer thread. Neither side locks or
+///        waits: push fails when the queue is full and pop
+///        fails when it is empty.
+///
+/// The capacity is rounded up to a power of two so positions
+/// wrap with a mask. The producer and consumer positions live
+/// on separate cache lines, and each side keeps a private
+/// copy of the other's position, reading the shared one only
+/// when its copy says the queue is full (or empty). In the
+/// steady state each operation touches one shared line.
+///////////////////////////////////////////////////////////////
+template <typename T>
+class SpscQueue {
+
+ public:
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor allocates the ring.
+  /// @param capacity -- Minimum number of queued items.
+  /// @throws std::invalid_argument if capacity is zero or
+  ///         too large to round up.
+  ////////////////////////////////////////////////////////////
+  explicit SpscQueue(unsigned int capacity) :
+           _mask(0),
+           _items(),
+           _head(0),
+           _cachedTail(0),
+           _tail(0),
+           _cachedHead(0)
+  {
+    if (capacity == 0 || capacity > (1u << 31)){
+      throw std::invalid_argument("SpscQueue capacity must be 1 to 2^31");
+    }
+    unsigned int size = 1;
+    while (size < capacity){
+      size <<= 1;
+    }
+    _mask = size - 1;
+    _items.resize(size);
+  }
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+  ////////////////////////////////////////////////////////////
+  /// @brief Producer: appends one item.
+  /// @param item -- The item.
+  /// @return false if the queue is full.
+  ////////////////////////////////////////////////////////////
+  bool push(const T& item){
+    return pushBlock(&item, 1) == 1;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Producer: appends as many items as fit.
+  /// @param items    -- The items, oldest first.
+  /// @param numItems -- Number of items offered.
+  /// @return The number appended.
+  ////////////////////////////////////////////////////////////
+  unsigned int pushBlock(const T* items, unsigned int numItems){
+    const unsigned int tail = _tail.load(std::memory_order_relaxed);
+    unsigned int space = capacity() - (tail - _cachedHead);
+    if (space < numItems){
+      _cachedHead = _head.load(std::memory_order_acquire);
+      space = capacity() - (tail - _cachedHead);
+    }
+    const unsigned int count = numItems < space ? numItems : space;
+    for (unsigned int i=0; i<count; i++){
+      _items[(tail + i) & _mask] = items[i];
+    }
+    _tail.store(tail + count, std::memory_order_release);
+    return count;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Consumer: removes the oldest item.
+  /// @param item -- Receives the item.
+  /// @return false if the queue is empty.
+  ////////////////////////////////////////////////////////////
+  bool pop(T& item){
+    return popBlock(&item, 1) == 1;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Consumer: removes up to maxItems of the oldest
+  ///        items.
+  /// @param items    -- Receives the items, oldest first.
+  /// @param maxItems -- Capacity of items.
+  /// @return The number removed.
+  ////////////////////////////////////////////////////////////
+  unsigned int popBlock(T* items, unsigned int maxItems){
+    const unsigned int head = _head.load(std::memory_order_relaxed);
+    unsigned int available = _cachedTail - head;
+    if (available < maxItems){
+      _cachedTail = _tail.load(std::memory_order_acquire);
+      available = _cachedTail - head;
+    }
+    const unsigned int count = maxItems < available ? maxItems : available;
+    for (unsigned int i=0; i<count; i++){
+      items[i] = _items[(head + i) & _mask];
+    }
+    _head.store(head + count, std::memory_order_release);
+    return count;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of queued items. Exact only when called
+  ///        from one side while the other is idle.
+  ////////////////////////////////////////////////////////////
+  unsigned int size(void) const {
+    return _tail.load(std::memory_order_acquire) -
+           _head.load(std::memory_order_acquire);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of items the queue holds when full.
+  ////////////////////////////////////////////////////////////
+  inline unsigned int capacity(void) const { return _mask + 1; }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief capacity() - 1; positions wrap with this mask.
+  ////////////////////////////////////////////////////////////
+  unsigned int _mask;
+  ////////////////////////////////////////////////////////////
+  /// @brief The ring.
+  ////////////////////////////////////////////////////////////
+  std::vector<T> _items;
+  char _padConsumer[64];
+  ////////////////////////////////////////////////////////////
+  /// @brief Consumer position: the next item to pop. Free
+  ///        running; only the low bits index the ring.
+  ////////////////////////////////////////////////////////////
+  std::atomic<unsigned int> _head;
+  ////////////////////////////////////////////////////////////
+  /// @brief Consumer's copy of _tail.
+  ////////////////////////////////////////////////////////////
+  unsigned int _cachedTail;
+  char _padProducer[64];
+  ////////////////////////////////////////////////////////////
+  /// @brief Producer position: where the next item goes.
+  ////////////////////////////////////////////////////////////
+  std::atomic<unsigned int> _tail;
+  ////////////////////////////////////////////////////////////
+  /// @brief Producer's copy of _head.
+  ////////////////////////////////////////////////////////////
+  unsigned int _cachedHead;
+  char _padEnd[64];
+};
+
+#endif  // SPSC_QUEUE_HH
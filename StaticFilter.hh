@@ -0,0 +1,262 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class defines a digital filter whose tap
+///          counts and sample type are fixed at compile time.
+///          It implements the same difference equation as
+///          the generic Filter base class.
+///
+///////////////////////////////////////////////////////////////
+#ifndef STATIC_FILTER_HH
+#define STATIC_FILTER_HH
+
+#include "SampleTraits.hh"
+
+#include <stdexcept>
+
+///////////////////////////////////////////////////////////////
+/// @brief Compile time loop helpers for StaticFilter. Each
+///        helper expands to straight line code over the index
+///        range [Begin, End) so the filter loops are always
+///        fully unrolled, independent of optimizer heuristics.
+///////////////////////////////////////////////////////////////
+template <unsigned int Begin, unsigned int End>
+struct StaticFilterUnroll {
+  ////////////////////////////////////////////////////////////
+  /// @brief acc += w[i]*x[i] for i in [Begin, End), in order,
+  ///        with the products formed by Traits::product.
+  ////////////////////////////////////////////////////////////
+  template <typename Traits, typename A, typename W, typename T>
+  static inline void accumulate(A& acc, const W* w, const T* x){
+    acc += Traits::product(w[Begin], x[Begin]);
+    StaticFilterUnroll<Begin + 1, End>::template accumulate<Traits>(acc, w, x);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief buff[i] = buff[i-1] for i from End-1 down to Begin.
+  ////////////////////////////////////////////////////////////
+  template <typename T>
+  static inline void shift(T* buff){
+    StaticFilterUnroll<Begin + 1, End>::shift(buff);
+    buff[Begin] = buff[Begin - 1];
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief dest[i] = src[i] for i in [Begin, End).
+  ////////////////////////////////////////////////////////////
+  template <typename T>
+  static inline void copy(T* dest, const T* src){
+    dest[Begin] = src[Begin];
+    StaticFilterUnroll<Begin + 1, End>::copy(dest, src);
+  }
+};
+
+///////////////////////////////////////////////////////////////
+/// @brief Terminates the StaticFilterUnroll recursion.
+///////////////////////////////////////////////////////////////
+template <unsigned int End>
+struct StaticFilterUnroll<End, End> {
+  template <typename Traits, typename A, typename W, typename T>
+  static inline void accumulate(A&, const W*, const T*){}
+  template <typename T>
+  static inline void shift(T*){}
+  template <typename T>
+  static inline void copy(T*, const T*){}
+};
+
+///////////////////////////////////////////////////////////////
+/// @class StaticFilter
+/// @ingroup DSP
+/// @brief Digital filter with NB input weights and NA output
+///        weights known at compile time. It evaluates the same
+///        equation, in the same order, as Filter::filter, but
+///        every loop is unrolled and the object holds only its
+///        own weights and delay lines, so it is exactly
+///        2*(NB+NA)*sizeof(T) bytes with no virtual table
+///        (for float and double samples).
+///
+/// The arithmetic comes from Traits, which defaults to
+/// SampleTraits<T>. float and double behave like Filter;
+/// the Q15 and Q31 types in FixedPoint.hh use wider weights
+/// and accumulators with a saturating output:
+///
+/// @code
+///   StaticFilter<3, 1, Q15> avgFilter(avgWeightsQ15);
+///   Q15 y = avgFilter.filter(Q15::fromFloat(0.25f));
+/// @endcode
+///
+/// The weights may be supplied as a constant expression
+/// through the Coefficients aggregate:
+///
+/// @code
+///   static constexpr StaticFilter<3, 1>::Coefficients avg =
+///       {{0.33333f, 0.33333f, 0.33333f}, {1.0f}};
+///   StaticFilter<3, 1> avgFilter(avg);
+/// @endcode
+///////////////////////////////////////////////////////////////
+template <unsigned int NB, unsigned int NA, typename T = float,
+          typename Traits = SampleTraits<T> >
+class StaticFilter {
+  static_assert(NB > 0, "StaticFilter needs at least one input weight");
+  static_assert(NA > 0, "StaticFilter needs at least one output weight");
+
+ public:
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of input weights (b) of this filter.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int NumInWeights = NB;
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of output weights (a) of this filter.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int NumOutWeights = NA;
+  ////////////////////////////////////////////////////////////
+  /// @brief Stored weight type.
+  ////////////////////////////////////////////////////////////
+  typedef typename Traits::Weight Weight;
+  ////////////////////////////////////////////////////////////
+  /// @brief Type the weighted samples are summed in.
+  ////////////////////////////////////////////////////////////
+  typedef typename Traits::Accumulator Accumulator;
+  ////////////////////////////////////////////////////////////
+  /// @brief Aggregate holding one set of filter weights. It
+  ///        can be declared constexpr.
+  ////////////////////////////////////////////////////////////
+  struct Coefficients {
+    Weight inputWeights[NB];
+    Weight outputWeights[NA];
+  };
+  ////////////////////////////////////////////////////////////
+  /// @brief Constructs the filter from a set of weights with
+  ///        zeroed delay lines. The weights are normalized by
+  ///        a[0] here, so the filter routines never divide.
+  /// @param weights -- The input and output weights.
+  /// @throws std::invalid_argument if Traits rejects a[0]:
+  ///         zero or not finite for float and double, other
+  ///         than one for fixed point. Also thrown if a float
+  ///         or double weight is not finite once divided by
+  ///         a[0].
+  ////////////////////////////////////////////////////////////
+  explicit StaticFilter(const Coefficients& weights){
+    setWeights(weights.inputWeights, weights.outputWeights);
+    reset();
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Constructs the filter from weight arrays with
+  ///        zeroed delay lines.
+  /// @param inWeights  -- NB input weights.
+  /// @param outWeights -- NA output weights.
+  /// @throws std::invalid_argument if Traits rejects a[0] or
+  ///         a normalized weight.
+  ////////////////////////////////////////////////////////////
+  StaticFilter(const Weight* inWeights, const Weight* outWeights){
+    setWeights(inWeights, outWeights);
+    reset();
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Main filter routine.
+  /// @param inputValue input value.
+  /// @return Output from the filter
+  ////////////////////////////////////////////////////////////
+  inline T filter(T inputValue){
+    Accumulator outputContribution = Accumulator();
+    Accumulator inputContribution = Accumulator();
+    StaticFilterUnroll<1, NB>::shift(_inputBuffer);
+    _inputBuffer[0] = inputValue;
+    StaticFilterUnroll<1, NA>::shift(_outputBuffer);
+    StaticFilterUnroll<0, NB>::template accumulate<Traits>(
+        inputContribution, _inputWeights, _inputBuffer);
+    StaticFilterUnroll<1, NA>::template accumulate<Traits>(
+        outputContribution, _outputWeights, _outputBuffer);
+    _outputBuffer[0] = Traits::output(inputContribution, outputContribution);
+    return _outputBuffer[0];
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Block filter routine. The delay lines and weights
+  ///        are copied into locals for the whole block, so the
+  ///        state stays in registers. Outputs are bit-identical
+  ///        to calling filter() once per sample.
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for the filter outputs.
+  /// @param numSamples -- Number of samples in the block.
+  ////////////////////////////////////////////////////////////
+  void filterBlock(const T* input, T* output, unsigned int numSamples){
+    Weight b[NB], a[NA];
+    T x[NB], y[NA];
+    StaticFilterUnroll<0, NB>::copy(b, _inputWeights);
+    StaticFilterUnroll<0, NA>::copy(a, _outputWeights);
+    StaticFilterUnroll<0, NB>::copy(x, _inputBuffer);
+    StaticFilterUnroll<0, NA>::copy(y, _outputBuffer);
+    for(unsigned int n=0; n<numSamples; n++){
+      Accumulator outputContribution = Accumulator();
+      Accumulator inputContribution = Accumulator();
+      StaticFilterUnroll<1, NB>::shift(x);
+      x[0] = input[n];
+      StaticFilterUnroll<1, NA>::shift(y);
+      StaticFilterUnroll<0, NB>::template accumulate<Traits>(
+          inputContribution, b, x);
+      StaticFilterUnroll<1, NA>::template accumulate<Traits>(
+          outputContribution, a, y);
+      y[0] = Traits::output(inputContribution, outputContribution);
+      output[n] = y[0];
+    }
+    StaticFilterUnroll<0, NB>::copy(_inputBuffer, x);
+    StaticFilterUnroll<0, NA>::copy(_outputBuffer, y);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Zeroes the input and output delay lines.
+  ////////////////////////////////////////////////////////////
+  void reset(void){
+    for(unsigned int i=0; i<NB; i++){ _inputBuffer[i] = T(); }
+    for(unsigned int i=0; i<NA; i++){ _outputBuffer[i] = T(); }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the current input
+  ///        buffer of the filter, newest sample first.
+  /// @return The current input buffer of the filter.
+  ////////////////////////////////////////////////////////////
+  inline T* GetCurrentInputBuffer(void){ return _inputBuffer; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the current output
+  ///        buffer of the filter, newest output first.
+  /// @return The current output buffer of the filter.
+  ////////////////////////////////////////////////////////////
+  inline T* GetCurrentOutputBuffer(void){ return _outputBuffer; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the filter's input
+  ///        weights, normalized by a[0].
+  /// @return The filters input weights
+  ////////////////////////////////////////////////////////////
+  inline Weight* GetInputWeights(void){ return _inputWeights; }
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the filter's output
+  ///        weights, normalized by a[0].
+  /// @return The filters output weights
+  ////////////////////////////////////////////////////////////
+  inline Weight* GetOutputWeights(void){ return _outputWeights; }
+
+ protected:
+  ////////////////////////////////////////////////////////////
+  /// @brief Checks the weights and stores them normalized.
+  ///        Nothing is stored if they are rejected.
+  ////////////////////////////////////////////////////////////
+  void setWeights(const Weight* inWeights, const Weight* outWeights){
+    normalizeWeights<Traits>(NB, inWeights, NA, outWeights,
+                             _inputWeights, _outputWeights);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Buffer holding the input signal values, newest
+  ///        first.
+  ////////////////////////////////////////////////////////////
+  T _inputBuffer[NB];
+  ////////////////////////////////////////////////////////////
+  /// @brief Buffer holding the output signal values, newest
+  ///        first.
+  ////////////////////////////////////////////////////////////
+  T _outputBuffer[NA];
+  ////////////////////////////////////////////////////////////
+  /// @brief Weights applied to the input signal (b).
+  ////////////////////////////////////////////////////////////
+  Weight _inputWeights[NB];
+  ////////////////////////////////////////////////////////////
+  /// @brief Weights applied to the output signal (a).
+  ////////////////////////////////////////////////////////////
+  Weight _outputWeights[NA];
+};
+
+#endif  // STATIC_FILTER_HH
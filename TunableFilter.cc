@@ -0,0 +1,67 @@
+#include "TunableFilter.hh"
+
+#include <algorithm>
+
+//////////////////////////////////////////////////////////
+/// @brief The c'tor constructs the class members. The
+///        storage is first grown to the mailbox maximum with
+///        placeholder weights; setting the real weights after
+///        keeps that room.
+////////////////////////////////////////////////////////////
+TunableFilter::TunableFilter(const std::vector<float>& inWeights,
+                             const std::vector<float>& outWeights,
+                             CoefficientMailbox& mailbox) :
+         Filter(inWeights, outWeights),
+         _mailbox(mailbox)
+{
+  std::vector<float> b(std::max<size_t>(mailbox.GetMaxInWeights(),
+                                        inWeights.size()), 0.0f);
+  std::vector<float> a(std::max<size_t>(mailbox.GetMaxOutWeights(),
+                                        outWeights.size()), 0.0f);
+  a[0] = 1.0f;
+  SetWeights(static_cast<unsigned int>(b.size()), &b[0],
+             static_cast<unsigned int>(a.size()), &a[0]);
+  SetWeights(static_cast<unsigned int>(inWeights.size()), &inWeights[0],
+             static_cast<unsigned int>(outWeights.size()), &outWeights[0]);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Default  d'tor
+////////////////////////////////////////////////////////////
+TunableFilter::~TunableFilter() {
+
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The mailbox has already checked and normalized the
+///        set, and the storage has room for it.
+////////////////////////////////////////////////////////////
+inline void TunableFilter::pickUpWeights(void){
+  const CoefficientSet* weights = _mailbox.take();
+  if (weights != NULL){
+    installWeights(weights->numInWeights, &weights->inWeights[0],
+                   weights->numOutWeights, &weights->outWeights[0]);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Picks up new weights, then filters the sample.
+/// @param inputValue input value.
+/// @return Output from the filter
+////////////////////////////////////////////////////////////
+float TunableFilter::filter(float inputValue){
+  pickUpWeights();
+  return Filter::filter(inputValue);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Picks up new weights, then filters the block.
+/// @param input      -- Input samples, oldest first.
+/// @param output     -- Destination for the filter outputs.
+/// @param numSamples -- Number of samples in the block.
+////////////////////////////////////////////////////////////
+void TunableFilter::filterBlock(const float* input, float* output,
+                                unsigned int numSamples){
+  pickUpWeights();
+  Filter::filterBlock(input, output, numSamples);
+}
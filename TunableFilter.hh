@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup This class defines a filter whose weights can be
+///          retuned from another thread while it runs.
+///
+///////////////////////////////////////////////////////////////
+#ifndef TUNABLE_FILTER_HH
+#define TUNABLE_FILTER_HH
+
+#include "CoefficientMailbox.hh"
+#include "Filter.hh"
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////
+/// @class TunableFilter
+/// @ingroup DSP
+/// @brief A Filter that takes new weights from a
+///        CoefficientMailbox. Before each call to filter() or
+///        filterBlock() it checks the mailbox, and if a control
+///        thread has published a set since the last check, the
+///        set replaces the weights with the delay lines kept,
+///        as SetWeights would. A block is always filtered with
+///        one set of weights from start to end.
+///
+/// The check is one atomic load when nothing is new, and the
+/// swap never allocates or locks: the filter's storage is
+/// sized for the mailbox maximum at construction.
+///
+/// @code
+///   CoefficientMailbox mailbox(3, 3);
+///   TunableFilter lowPass(b, a, mailbox);
+///   // real time thread
+///   lowPass.filterBlock(input, output, numSamples);
+///   // control thread
+///   mailbox.publish(retunedB, retunedA);
+/// @endcode
+///////////////////////////////////////////////////////////////
+class TunableFilter : public Filter {
+
+ public:
+  //////////////////////////////////////////////////////////
+  /// @brief This constructor sets the starting weights and
+  ///        reserves room for any set the mailbox can hold.
+  /// @param inWeights  -- The input weights (b).
+  /// @param outWeights -- The output weights (a).
+  /// @param mailbox    -- Source of new weights. It must
+  ///                      outlive the filter and feed no other.
+  /// @throws std::invalid_argument as Filter::SetWeights.
+  ////////////////////////////////////////////////////////////
+  TunableFilter(const std::vector<float>& inWeights,
+                const std::vector<float>& outWeights,
+                CoefficientMailbox& mailbox);
+  //////////////////////////////////////////////////////////
+  /// @brief The default d'tor destructs the TunableFilter.
+  ////////////////////////////////////////////////////////////
+  virtual ~TunableFilter();
+  TunableFilter(const TunableFilter&) = delete;
+  TunableFilter& operator=(const TunableFilter&) = delete;
+  ////////////////////////////////////////////////////////////
+  /// @brief Main filter routine. Picks up new weights first.
+  /// @param inputValue input value.
+  /// @return Output from the filter
+  ////////////////////////////////////////////////////////////
+  virtual float filter(float inputValue);
+  ////////////////////////////////////////////////////////////
+  /// @brief Block filter routine. Picks up new weights first.
+  /// @param input      -- Input samples, oldest first.
+  /// @param output     -- Destination for the filter outputs.
+  ///                      May alias input.
+  /// @param numSamples -- Number of samples in the block.
+  ////////////////////////////////////////////////////////////
+  virtual void filterBlock(const float* input, float* output,
+                           unsigned int numSamples);
+  ////////////////////////////////////////////////////////////
+  /// @brief An accessor function to get the mailbox.
+  /// @return The mailbox the filter takes weights from.
+  ////////////////////////////////////////////////////////////
+  inline CoefficientMailbox& GetMailbox(void){ return _mailbox; }
+
+ private:
+  ////////////////////////////////////////////////////////////
+  /// @brief Installs the newest published set, if any.
+  ////////////////////////////////////////////////////////////
+  inline void pickUpWeights(void);
+  ////////////////////////////////////////////////////////////
+  /// @brief Source of new weights.
+  ////////////////////////////////////////////////////////////
+  CoefficientMailbox& _mailbox;
+};
+
+#endif  // TUNABLE_FILTER_HH
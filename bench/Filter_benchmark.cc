@@ -0,0 +1,687 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup Google Benchmark suite for the filters. Every
+///          benchmark reports samples per second, and the
+///          time_per_sample counter is the figure to hold later
+///          optimizations against.
+///
+/// Machine readable results:
+///
+///   Filter_benchmark --benchmark_out=filter_bench.json
+///                    --benchmark_out_format=json
+///
+/// Compare two runs with tools/compare.py from the Google
+/// Benchmark sources. Building a second copy with
+/// -DFILTER_INSTRUMENTATION and comparing BM_FilterPerSample
+/// and BM_FilterBlock measures the cost of the statistics.
+///
+///////////////////////////////////////////////////////////////
+#include "../AdaptiveFilter.hh"
+#include "../ButterworthLowPass3rdOrder.hh"
+#include "../Filter.hh"
+#include "../FilterArena.hh"
+#include "../FilterAnalysis.hh"
+#include "../FilterBank.hh"
+#include "../FilterChain.hh"
+#include "../Decimator.hh"
+#include "../FftFilter.hh"
+#include "../GuardedFilter.hh"
+#include "../Interpolator.hh"
+#include "../MovingAverage.hh"
+#include "../ParallelFilter.hh"
+#include "../TunableFilter.hh"
+#include "../FilterScheduler.hh"
+#include "../FixedPoint.hh"
+#include "../MovingAvg3rdOrder.hh"
+#include "../StaticFilter.hh"
+#include "benchmark/benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+////////////////////////////////////////////////////////////
+/// @brief Samples in one block for the block benchmarks.
+////////////////////////////////////////////////////////////
+static const unsigned int BLOCK_SIZE = 1024;
+
+////////////////////////////////////////////////////////////
+/// @brief Bytes written between iterations of the cold
+///        cache benchmarks. Raise it on machines whose last
+///        level cache is larger.
+////////////////////////////////////////////////////////////
+static const size_t EVICTION_BYTES = 64*1024*1024;
+
+////////////////////////////////////////////////////////////
+/// @brief A noisy sine, the same shape as the unit test
+///        signals.
+////////////////////////////////////////////////////////////
+static std::vector<float> testSignal(size_t length){
+  std::vector<float> signal(length);
+  for (size_t i=0; i<length; i++){
+    signal[i] = std::sin(0.05f*i) + 0.1f*std::sin(1.7f*i);
+  }
+  return signal;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Stable weights with the given number of taps:
+///        an averaging b and an a whose feedback sums to less
+///        than a[0].
+////////////////////////////////////////////////////////////
+static void testWeights(unsigned int numTaps, std::vector<float>& b,
+                        std::vector<float>& a){
+  b.assign(numTaps, 1.0f/numTaps);
+  a.assign(numTaps, 0.0f);
+  a[0] = 1.0f;
+  for (unsigned int i=1; i<numTaps; i++){
+    a[i] = ((i % 2) ? -0.1f : 0.1f)*std::pow(0.5f, static_cast<float>(i - 1));
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Reports samples per second and time per sample.
+////////////////////////////////////////////////////////////
+static void reportSamples(benchmark::State& state, double samplesPerIteration){
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()*
+                                               samplesPerIteration));
+  state.counters["time_per_sample"] = benchmark::Counter(
+      samplesPerIteration,
+      benchmark::Counter::kIsIterationInvariantRate |
+      benchmark::Counter::kInvert);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filter::filter one sample at a time, with NB = NA
+///        = range(0) taps.
+////////////////////////////////////////////////////////////
+static void BM_FilterPerSample(benchmark::State& state){
+  std::vector<float> b, a;
+  testWeights(static_cast<unsigned int>(state.range(0)), b, a);
+  Filter filter(b.size(), &b[0], a.size(), &a[0]);
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  for (auto _ : state){
+    for (unsigned int i=0; i<BLOCK_SIZE; i++){
+      benchmark::DoNotOptimize(filter.filter(signal[i]));
+    }
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_FilterPerSample)->DenseRange(2, MAX_FILTER_SIZE, 2)->Arg(1);
+
+////////////////////////////////////////////////////////////
+/// @brief Filter::filterBlock with range(0) taps and
+///        range(1) samples per block.
+////////////////////////////////////////////////////////////
+static void BM_FilterBlock(benchmark::State& state){
+  std::vector<float> b, a;
+  testWeights(static_cast<unsigned int>(state.range(0)), b, a);
+  Filter filter(b.size(), &b[0], a.size(), &a[0]);
+  const unsigned int blockSize = static_cast<unsigned int>(state.range(1));
+  const std::vector<float> signal = testSignal(blockSize);
+  std::vector<float> output(blockSize);
+  for (auto _ : state){
+    filter.filterBlock(&signal[0], &output[0], blockSize);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, blockSize);
+}
+BENCHMARK(BM_FilterBlock)
+    ->ArgsProduct({{1, 3, 8, MAX_FILTER_SIZE}, {64, BLOCK_SIZE, 16384}});
+
+////////////////////////////////////////////////////////////
+/// @brief TunableFilter with 3 taps and range(0) samples per
+///        block, idle or taking a new weight set every block.
+///        Compare with BM_FilterBlock/3.
+////////////////////////////////////////////////////////////
+static void BM_TunableFilterBlock(benchmark::State& state){
+  std::vector<float> b, a;
+  testWeights(3, b, a);
+  CoefficientMailbox mailbox(3, 3);
+  TunableFilter filter(b, a, mailbox);
+  const unsigned int blockSize = static_cast<unsigned int>(state.range(0));
+  const bool retune = state.range(1) != 0;
+  const std::vector<float> signal = testSignal(blockSize);
+  std::vector<float> output(blockSize);
+  for (auto _ : state){
+    if (retune){
+      mailbox.publish(b, a);
+    }
+    filter.filterBlock(&signal[0], &output[0], blockSize);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, blockSize);
+}
+BENCHMARK(BM_TunableFilterBlock)->ArgsProduct({{64, BLOCK_SIZE}, {0, 1}});
+
+////////////////////////////////////////////////////////////
+/// @brief MovingAvg3rdOrder, per sample and per block.
+////////////////////////////////////////////////////////////
+static void BM_MovingAvg3rdOrderPerSample(benchmark::State& state){
+  MovingAvg3rdOrder filter;
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  for (auto _ : state){
+    for (unsigned int i=0; i<BLOCK_SIZE; i++){
+      benchmark::DoNotOptimize(filter.filter(signal[i]));
+    }
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_MovingAvg3rdOrderPerSample);
+
+static void BM_MovingAvg3rdOrderBlock(benchmark::State& state){
+  MovingAvg3rdOrder filter;
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<float> output(BLOCK_SIZE);
+  for (auto _ : state){
+    filter.filterBlock(&signal[0], &output[0], BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_MovingAvg3rdOrderBlock);
+
+////////////////////////////////////////////////////////////
+/// @brief ButterworthLowPass3rdOrder designed for the test
+///        stand (1 Hz at 500 Hz), per sample and per block.
+////////////////////////////////////////////////////////////
+static void BM_ButterworthLowPass3rdOrderPerSample(benchmark::State& state){
+  ButterworthLowPass3rdOrder filter(1.0, 500.0);
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  for (auto _ : state){
+    for (unsigned int i=0; i<BLOCK_SIZE; i++){
+      benchmark::DoNotOptimize(filter.filter(signal[i]));
+    }
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_ButterworthLowPass3rdOrderPerSample);
+
+static void BM_ButterworthLowPass3rdOrderBlock(benchmark::State& state){
+  ButterworthLowPass3rdOrder filter(1.0, 500.0);
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<float> output(BLOCK_SIZE);
+  for (auto _ : state){
+    filter.filterBlock(&signal[0], &output[0], BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_ButterworthLowPass3rdOrderBlock);
+
+////////////////////////////////////////////////////////////
+/// @brief Second order StaticFilter block processing in
+///        float, Q15 and Q31, to weigh fixed point against
+///        float on the target.
+////////////////////////////////////////////////////////////
+static void BM_StaticFilterFloatBlock(benchmark::State& state){
+  const float b[3] = {0.05f, 0.1f, 0.05f};
+  const float a[3] = {1.0f, -1.3f, 0.5f};
+  StaticFilter<3, 3> filter(b, a);
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<float> output(BLOCK_SIZE);
+  for (auto _ : state){
+    filter.filterBlock(&signal[0], &output[0], BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_StaticFilterFloatBlock);
+
+template <typename Q>
+static void BM_StaticFilterFixedBlock(benchmark::State& state){
+  const int32_t b[3] = {Q::weight(0.05), Q::weight(0.1), Q::weight(0.05)};
+  const int32_t a[3] = {Q::weight(1.0), Q::weight(-1.3), Q::weight(0.5)};
+  StaticFilter<3, 3, Q> filter(b, a);
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<Q> input(BLOCK_SIZE), output(BLOCK_SIZE);
+  for (unsigned int i=0; i<BLOCK_SIZE; i++){
+    input[i] = Q::fromFloat(0.5f*signal[i]);
+  }
+  for (auto _ : state){
+    filter.filterBlock(&input[0], &output[0], BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK_TEMPLATE(BM_StaticFilterFixedBlock, Q15);
+BENCHMARK_TEMPLATE(BM_StaticFilterFixedBlock, Q31);
+
+////////////////////////////////////////////////////////////
+/// @brief range(0) independent Filter instances, each
+///        filtering its own block, as when many channels are
+///        processed one object at a time.
+////////////////////////////////////////////////////////////
+static void BM_FilterManyInstances(benchmark::State& state){
+  const unsigned int numInstances = static_cast<unsigned int>(state.range(0));
+  const unsigned int blockSize = 256;
+  std::vector<float> b, a;
+  testWeights(3, b, a);
+  std::vector<Filter> filters(numInstances,
+                              Filter(b.size(), &b[0], a.size(), &a[0]));
+  const std::vector<float> signal = testSignal(blockSize);
+  std::vector<float> output(blockSize);
+  for (auto _ : state){
+    for (unsigned int f=0; f<numInstances; f++){
+      filters[f].filterBlock(&signal[0], &output[0], blockSize);
+    }
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, static_cast<double>(numInstances)*blockSize);
+}
+BENCHMARK(BM_FilterManyInstances)->RangeMultiplier(8)->Range(1, 4096);
+
+////////////////////////////////////////////////////////////
+/// @brief BM_FilterManyInstances with every filter's storage
+///        packed back to back in one FilterArena.
+////////////////////////////////////////////////////////////
+static void BM_FilterManyInstancesArena(benchmark::State& state){
+  const unsigned int numInstances = static_cast<unsigned int>(state.range(0));
+  const unsigned int blockSize = 256;
+  std::vector<float> b, a;
+  testWeights(3, b, a);
+  FilterArena arena(numInstances*Filter::StorageSize(b.size(), a.size()));
+  std::vector<Filter> filters;
+  filters.reserve(numInstances);
+  for (unsigned int f=0; f<numInstances; f++){
+    filters.push_back(Filter(b, a, &arena));
+  }
+  const std::vector<float> signal = testSignal(blockSize);
+  std::vector<float> output(blockSize);
+  for (auto _ : state){
+    for (unsigned int f=0; f<numInstances; f++){
+      filters[f].filterBlock(&signal[0], &output[0], blockSize);
+    }
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, static_cast<double>(numInstances)*blockSize);
+}
+BENCHMARK(BM_FilterManyInstancesArena)->RangeMultiplier(8)->Range(1, 4096);
+
+////////////////////////////////////////////////////////////
+/// @brief Long FIR filters of range(0) taps, in direct form
+///        and by partitioned FFT convolution.
+////////////////////////////////////////////////////////////
+static void BM_FirDirectForm(benchmark::State& state){
+  const std::vector<float> taps(state.range(0), 1.0f/state.range(0));
+  Filter filter(taps, std::vector<float>(1, 1.0f));
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<float> output(BLOCK_SIZE);
+  for (auto _ : state){
+    filter.filterBlock(&signal[0], &output[0], BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_FirDirectForm)->RangeMultiplier(4)->Range(16, 4096);
+
+static void BM_FftFilter(benchmark::State& state){
+  const std::vector<float> taps(state.range(0), 1.0f/state.range(0));
+  FftFilter filter(taps, static_cast<unsigned int>(state.range(1)));
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<float> output(BLOCK_SIZE);
+  for (auto _ : state){
+    filter.filterBlock(&signal[0], &output[0], BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_FftFilter)->ArgsProduct({{16, 64, 256, 1024, 4096}, {32, 64, 128}});
+
+////////////////////////////////////////////////////////////
+/// @brief Running sum moving average of range(0) samples;
+///        compare with BM_FirDirectForm at the same length.
+////////////////////////////////////////////////////////////
+static void BM_MovingAverage(benchmark::State& state){
+  MovingAverage filter(static_cast<unsigned int>(state.range(0)));
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<float> output(BLOCK_SIZE);
+  for (auto _ : state){
+    filter.filterBlock(&signal[0], &output[0], BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_MovingAverage)->RangeMultiplier(4)->Range(16, 4096);
+
+////////////////////////////////////////////////////////////
+/// @brief A quiet period: zero input into a slowly decaying
+///        resonance whose state starts in the denormal range,
+///        with a plain Filter and with GuardedFilter in each
+///        DenormalMode (range(0) + 1, 0 for plain).
+////////////////////////////////////////////////////////////
+static void BM_FilterDenormals(benchmark::State& state){
+  const std::vector<float> b(1, 1e-4f);
+  const std::vector<float> a{1.0f, -1.9f, 0.9025f};
+  Filter plain(b, a);
+  GuardedFilter guarded(b, a, static_cast<DenormalMode>(
+      std::max<int64_t>(state.range(0) - 1, 0)));
+  Filter& filter = state.range(0) == 0 ? plain : guarded;
+  const std::vector<float> quiet(BLOCK_SIZE, 0.0f);
+  std::vector<float> output(BLOCK_SIZE);
+  const float tinyInputs[1] = {0.0f};
+  const float tinyOutputs[3] = {1e-39f, 1e-39f, 1e-39f};
+  for (auto _ : state){
+    state.PauseTiming();
+    filter.RestoreBufferSnapshot(tinyInputs, tinyOutputs);
+    state.ResumeTiming();
+    filter.filterBlock(&quiet[0], &output[0], BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_FilterDenormals)->DenseRange(0, 3);
+
+////////////////////////////////////////////////////////////
+/// @brief Start up validation of one tuned filter of range(0)
+///        taps: frequency response on freqz's 512 point grid
+///        (time per grid point), group delay, and the
+///        stability margin (time per filter).
+////////////////////////////////////////////////////////////
+static void BM_FrequencyResponse(benchmark::State& state){
+  std::vector<float> b, a;
+  testWeights(static_cast<unsigned int>(state.range(0)), b, a);
+  Filter filter(b, a);
+  FilterAnalysis analysis;
+  std::vector<std::complex<double> > response(analysis.GetNumPoints());
+  for (auto _ : state){
+    analysis.frequencyResponse(filter, &response[0]);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, analysis.GetNumPoints());
+}
+BENCHMARK(BM_FrequencyResponse)->Arg(3)->Arg(MAX_FILTER_SIZE);
+
+static void BM_GroupDelay(benchmark::State& state){
+  std::vector<float> b, a;
+  testWeights(static_cast<unsigned int>(state.range(0)), b, a);
+  Filter filter(b, a);
+  FilterAnalysis analysis;
+  std::vector<double> delay(analysis.GetNumPoints());
+  for (auto _ : state){
+    analysis.groupDelay(filter, &delay[0]);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, analysis.GetNumPoints());
+}
+BENCHMARK(BM_GroupDelay)->Arg(3)->Arg(MAX_FILTER_SIZE);
+
+static void BM_StabilityMargin(benchmark::State& state){
+  std::vector<float> b, a;
+  testWeights(static_cast<unsigned int>(state.range(0)), b, a);
+  Filter filter(b, a);
+  for (auto _ : state){
+    benchmark::DoNotOptimize(FilterAnalysis::stabilityMargin(filter));
+  }
+}
+BENCHMARK(BM_StabilityMargin)->Arg(3)->Arg(MAX_FILTER_SIZE);
+
+////////////////////////////////////////////////////////////
+/// @brief NLMS adaptation with range(0) taps, updating every
+///        range(1) samples, on kernel range(2); compare with
+///        BM_FirDirectForm at the same length.
+////////////////////////////////////////////////////////////
+static void BM_AdaptiveFilter(benchmark::State& state){
+  const AdaptiveSpec spec = {NLMS, static_cast<unsigned int>(state.range(0)),
+                             0.1f, 0.0f,
+                             static_cast<unsigned int>(state.range(1))};
+  AdaptiveFilter filter(spec);
+  if (!filter.SetKernel(static_cast<AdaptiveFilter::Kernel>(state.range(2)))){
+    state.SkipWithError("kernel not supported");
+    return;
+  }
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<float> desired(signal.rbegin(), signal.rend());
+  std::vector<float> error(BLOCK_SIZE);
+  for (auto _ : state){
+    filter.adaptBlock(&signal[0], &desired[0], &error[0], BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_AdaptiveFilter)
+    ->ArgsProduct({{16, 64, 256, 1024, 4096}, {1, 4},
+                   {AdaptiveFilter::SCALAR_KERNEL, AdaptiveFilter::AVX2_KERNEL}});
+
+////////////////////////////////////////////////////////////
+/// @brief Decimation by 10 with a 64 tap low pass, by
+///        filtering every input and discarding 9 of 10
+///        outputs, and with the Decimator. Time is per input.
+////////////////////////////////////////////////////////////
+static void BM_DecimateByDiscard(benchmark::State& state){
+  Filter filter(std::vector<float>(64, 1.0f/64), std::vector<float>(1, 1.0f));
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<float> output(BLOCK_SIZE);
+  for (auto _ : state){
+    filter.filterBlock(&signal[0], &output[0], BLOCK_SIZE);
+    for (unsigned int n=0; n<BLOCK_SIZE; n+=10){
+      output[n/10] = output[n];
+    }
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_DecimateByDiscard);
+
+static void BM_Decimator(benchmark::State& state){
+  Decimator decimator(std::vector<float>(64, 1.0f/64), 10);
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<float> output(decimator.GetMaxOutputs(BLOCK_SIZE));
+  for (auto _ : state){
+    decimator.filterBlock(&signal[0], &output[0], BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_Decimator);
+
+////////////////////////////////////////////////////////////
+/// @brief Interpolation by 10 with a 64 tap low pass. Time
+///        is per output.
+////////////////////////////////////////////////////////////
+static void BM_Interpolator(benchmark::State& state){
+  Interpolator interpolator(std::vector<float>(64, 10.0f/64), 10);
+  const std::vector<float> signal = testSignal(BLOCK_SIZE/10);
+  std::vector<float> output(BLOCK_SIZE);
+  for (auto _ : state){
+    interpolator.filterBlock(&signal[0], &output[0], BLOCK_SIZE/10);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, 10*(BLOCK_SIZE/10));
+}
+BENCHMARK(BM_Interpolator);
+
+////////////////////////////////////////////////////////////
+/// @brief A 4th order IIR over a long recording on range(0)
+///        threads. Only faster than one thread with as many
+///        free cores.
+////////////////////////////////////////////////////////////
+static void BM_FilterParallel(benchmark::State& state){
+  float b[5] = {0.0004f, 0.0017f, 0.0025f, 0.0017f, 0.0004f};
+  float a[5] = {1.0f, -3.1806f, 3.8612f, -2.1122f, 0.4383f};
+  Filter filter(5, b, 5, a);
+  const size_t length = 16*PARALLEL_MIN_CHUNK;
+  std::vector<float> signal(length);
+  for (size_t n=0; n<length; n+=BLOCK_SIZE){
+    const std::vector<float> block = testSignal(BLOCK_SIZE);
+    std::copy(block.begin(), block.end(), signal.begin() + n);
+  }
+  std::vector<float> output(length);
+  for (auto _ : state){
+    filterParallel(filter, &signal[0], &output[0], length,
+                   static_cast<unsigned int>(state.range(0)));
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, length);
+}
+BENCHMARK(BM_FilterParallel)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+////////////////////////////////////////////////////////////
+/// @brief The same workload as BM_FilterManyInstances run
+///        through one FilterBank.
+////////////////////////////////////////////////////////////
+static void BM_FilterBankManyChannels(benchmark::State& state){
+  const unsigned int numChannels = static_cast<unsigned int>(state.range(0));
+  const unsigned int numFrames = 256;
+  std::vector<float> b, a;
+  testWeights(3, b, a);
+  FilterBank bank(numChannels, b.size(), &b[0], a.size(), &a[0]);
+  const std::vector<float> signal = testSignal(numFrames*numChannels);
+  std::vector<float> output(numFrames*numChannels);
+  for (auto _ : state){
+    bank.filterFrames(&signal[0], &output[0], numFrames);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, static_cast<double>(numChannels)*numFrames);
+}
+BENCHMARK(BM_FilterBankManyChannels)->RangeMultiplier(8)->Range(1, 4096);
+
+////////////////////////////////////////////////////////////
+/// @brief 4096 independent filters driven by a
+///        FilterScheduler with range(0) workers, 64 samples
+///        per stream per tick. Compare against
+///        BM_FilterManyInstances/4096 for the scaling.
+////////////////////////////////////////////////////////////
+static void BM_FilterScheduler(benchmark::State& state){
+  const unsigned int numFilters = 4096;
+  const unsigned int samplesPerTick = 64;
+  std::vector<float> b, a;
+  testWeights(3, b, a);
+  FilterScheduler scheduler(static_cast<unsigned int>(state.range(0)));
+  for (unsigned int f=0; f<numFilters; f++){
+    scheduler.addFilter(std::unique_ptr<Filter>(
+        new Filter(b.size(), &b[0], a.size(), &a[0])));
+  }
+  const std::vector<float> signal = testSignal(numFilters*samplesPerTick);
+  std::vector<float> output(numFilters*samplesPerTick);
+  for (auto _ : state){
+    scheduler.process(&signal[0], &output[0], samplesPerTick);
+  }
+  reportSamples(state, static_cast<double>(numFilters)*samplesPerTick);
+}
+BENCHMARK(BM_FilterScheduler)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+
+////////////////////////////////////////////////////////////
+/// @brief A three stage chain: the test stand low pass, a
+///        moving average and a first order Filter. Run stage
+///        by stage per sample (as composed before chains),
+///        through a FilterChain, a StaticFilterChain, and as
+///        the collapsed single Filter.
+////////////////////////////////////////////////////////////
+static void BM_ChainStagesPerSample(benchmark::State& state){
+  ButterworthLowPass3rdOrder lowPass(1.0, 500.0);
+  MovingAvg3rdOrder average;
+  std::vector<float> b, a;
+  testWeights(2, b, a);
+  Filter shelf(b.size(), &b[0], a.size(), &a[0]);
+  Filter& last = shelf;
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<float> output(BLOCK_SIZE);
+  for (auto _ : state){
+    for (unsigned int i=0; i<BLOCK_SIZE; i++){
+      output[i] = last.filter(average.filter(lowPass.filter(signal[i])));
+    }
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_ChainStagesPerSample);
+
+static void BM_FilterChain(benchmark::State& state){
+  ButterworthLowPass3rdOrder lowPass(1.0, 500.0);
+  MovingAvg3rdOrder average;
+  std::vector<float> b, a;
+  testWeights(2, b, a);
+  Filter shelf(b.size(), &b[0], a.size(), &a[0]);
+  FilterChain chain;
+  chain.addStage(lowPass);
+  chain.addStage(average);
+  chain.addStage(shelf);
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<float> output(BLOCK_SIZE);
+  for (auto _ : state){
+    chain.filterBlock(&signal[0], &output[0], BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_FilterChain);
+
+static void BM_StaticFilterChain(benchmark::State& state){
+  std::vector<float> b, a;
+  testWeights(2, b, a);
+  StaticFilterChain<StaticButterworthLowPass3rdOrder,
+                    StaticMovingAvg3rdOrder,
+                    StaticFilter<2, 2> >
+      chain(StaticButterworthLowPass3rdOrder(1.0, 500.0),
+            StaticMovingAvg3rdOrder(),
+            StaticFilter<2, 2>(&b[0], &a[0]));
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<float> output(BLOCK_SIZE);
+  for (auto _ : state){
+    chain.filterBlock(&signal[0], &output[0], BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_StaticFilterChain);
+
+static void BM_FilterChainCollapsed(benchmark::State& state){
+  ButterworthLowPass3rdOrder lowPass(1.0, 500.0);
+  MovingAvg3rdOrder average;
+  std::vector<float> b, a;
+  testWeights(2, b, a);
+  Filter shelf(b.size(), &b[0], a.size(), &a[0]);
+  FilterChain chain;
+  chain.addStage(lowPass);
+  chain.addStage(average);
+  chain.addStage(shelf);
+  Filter single = chain.collapse();
+  const std::vector<float> signal = testSignal(BLOCK_SIZE);
+  std::vector<float> output(BLOCK_SIZE);
+  for (auto _ : state){
+    single.filterBlock(&signal[0], &output[0], BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+  reportSamples(state, BLOCK_SIZE);
+}
+BENCHMARK(BM_FilterChainCollapsed);
+
+////////////////////////////////////////////////////////////
+/// @brief Filter::filterBlock on a short block, with the
+///        filter, signal and output either left in cache
+///        (range(1) == 0) or evicted before every iteration
+///        (range(1) == 1). The eviction runs with the timer
+///        paused; the pause itself costs some tens of ns per
+///        iteration, which the warm variant pays too.
+////////////////////////////////////////////////////////////
+static void BM_FilterCache(benchmark::State& state){
+  std::vector<float> b, a;
+  testWeights(static_cast<unsigned int>(state.range(0)), b, a);
+  Filter filter(b.size(), &b[0], a.size(), &a[0]);
+  const bool cold = state.range(1) != 0;
+  const unsigned int blockSize = 64;
+  const std::vector<float> signal = testSignal(blockSize);
+  std::vector<float> output(blockSize);
+  std::vector<char> eviction(cold ? EVICTION_BYTES : 1);
+  char fill = 0;
+  for (auto _ : state){
+    state.PauseTiming();
+    if (cold){
+      for (size_t i=0; i<eviction.size(); i+=64){
+        eviction[i] = fill;
+      }
+      fill++;
+      benchmark::ClobberMemory();
+    }
+    state.ResumeTiming();
+    filter.filterBlock(&signal[0], &output[0], blockSize);
+    benchmark::ClobberMemory();
+  }
+  state.SetLabel(cold ? "cold" : "warm");
+  reportSamples(state, blockSize);
+}
+BENCHMARK(BM_FilterCache)->ArgsProduct({{3, MAX_FILTER_SIZE}, {0, 1}})
+                         ->Iterations(500);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////
+/// @class AdaptiveFilterTest
+/// @ingroup DSP
+///
+/// @brief Test class for the LMS family adaptive filter. Each
+///        algorithm must identify an unknown FIR system from
+///        its input and output, on every kernel.
+///////////////////////////////////////////////////////////////
+#include "../AdaptiveFilter.hh"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+class AdaptiveFilterTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Adaptive filter test setup function
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     unsigned int seed = 12345;
+     input.resize(SIGNAL_LENGTH);
+     for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+       seed = seed*1664525u + 1013904223u;
+       input[n] = static_cast<float>(seed >> 8)/(1u << 23) - 1.0f;
+     }
+     for (unsigned int k=0; k<PLANT_LENGTH; k++){
+       plant.push_back(std::cos(0.7f*k)*std::exp(-0.2f*k));
+     }
+     desired.assign(SIGNAL_LENGTH, 0.0f);
+     for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+       for (unsigned int k=0; k<PLANT_LENGTH && k<=n; k++){
+         desired[n] += plant[k]*input[n - k];
+       }
+     }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Runs a filter over the whole signal.
+  /// @return The largest weight error against the plant.
+  ////////////////////////////////////////////////////////////
+  float identify(AdaptiveFilter& adaptive){
+    std::vector<float> error(SIGNAL_LENGTH);
+    adaptive.adaptBlock(&input[0], &desired[0], &error[0], SIGNAL_LENGTH);
+    float worst = 0.0f;
+    for (unsigned int k=0; k<PLANT_LENGTH; k++){
+      worst = std::max(worst, std::fabs(adaptive.GetInputWeights()[k] -
+                                        plant[k]));
+    }
+    return worst;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the test signal.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int SIGNAL_LENGTH = 20000;
+  ////////////////////////////////////////////////////////////
+  /// @brief Taps of the unknown system; deliberately not a
+  ///        multiple of the vector widths.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int PLANT_LENGTH = 21;
+  ////////////////////////////////////////////////////////////
+  /// @brief White noise in [-1, 1), the plant's response to
+  ///        it, and the plant's taps.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> input;
+  std::vector<float> desired;
+  std::vector<float> plant;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief LMS and NLMS converge to the plant on every kernel
+///        the CPU has, and filter() then reproduces the plant
+///        without adapting further.
+////////////////////////////////////////////////////////////
+TEST_F(AdaptiveFilterTest, IdentifiesSystem) {
+  const AdaptiveFilter::Kernel kernels[] = {AdaptiveFilter::SCALAR_KERNEL,
+                                            AdaptiveFilter::SSE_KERNEL,
+                                            AdaptiveFilter::AVX2_KERNEL};
+  const AdaptiveSpec specs[] = {{LMS, PLANT_LENGTH, 0.05f, 0.0f, 1},
+                                {NLMS, PLANT_LENGTH, 0.5f, 0.0f, 1}};
+  for (const AdaptiveSpec& spec : specs){
+    for (AdaptiveFilter::Kernel kernel : kernels){
+      AdaptiveFilter adaptive(spec);
+      if (!adaptive.SetKernel(kernel)){
+        continue;
+      }
+      ASSERT_LT(identify(adaptive), 1e-4) << spec.algorithm << " " << kernel;
+      const float* weights = adaptive.GetInputWeights();
+      const std::vector<float> learned(weights, weights + PLANT_LENGTH);
+      /// Once the history holds the restarted signal.
+      for (unsigned int n=0; n<100; n++){
+        const float y = adaptive.filter(input[n]);
+        if (n >= PLANT_LENGTH){
+          ASSERT_NEAR(desired[n], y, 1e-3);
+        }
+      }
+      for (unsigned int k=0; k<PLANT_LENGTH; k++){
+        ASSERT_EQ(learned[k], adaptive.GetInputWeights()[k]);
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief adaptBlock matches adapt() exactly, in place too.
+////////////////////////////////////////////////////////////
+TEST_F(AdaptiveFilterTest, BlockMatchesPerSample) {
+  const AdaptiveSpec spec = {NLMS, 37, 0.3f, 0.0f, 3};
+  AdaptiveFilter perSample(spec);
+  AdaptiveFilter blocks(spec);
+  std::vector<float> error(desired.begin(), desired.begin() + 1000);
+  blocks.adaptBlock(&input[0], &error[0], &error[0], 1000);
+  for (unsigned int n=0; n<1000; n++){
+    ASSERT_EQ(perSample.adapt(input[n], desired[n]), error[n]) << n;
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Updating every fourth sample still converges, and
+///        leakage trades a biased, smaller solution for
+///        bounded weights.
+////////////////////////////////////////////////////////////
+TEST_F(AdaptiveFilterTest, IntervalAndLeakage) {
+  AdaptiveSpec spec = {NLMS, PLANT_LENGTH, 0.5f, 0.0f, 4};
+  AdaptiveFilter sparse(spec);
+  ASSERT_LT(identify(sparse), 1e-3);
+
+  spec.algorithm = LEAKY_LMS;
+  spec.stepSize = 0.05f;
+  spec.leakage = 0.01f;
+  spec.updateInterval = 1;
+  AdaptiveFilter leaky(spec);
+  const float leakyError = identify(leaky);
+  ASSERT_GT(leakyError, 1e-3);
+  ASSERT_LT(leakyError, 0.05);
+  double plantNorm = 0.0, leakyNorm = 0.0;
+  for (unsigned int k=0; k<PLANT_LENGTH; k++){
+    plantNorm += plant[k]*plant[k];
+    leakyNorm += leaky.GetInputWeights()[k]*leaky.GetInputWeights()[k];
+  }
+  ASSERT_LT(leakyNorm, plantNorm);
+
+  leaky.reset();
+  ASSERT_EQ(0.0f, leaky.filter(1.0f));
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Rejected settings.
+////////////////////////////////////////////////////////////
+TEST_F(AdaptiveFilterTest, Construction) {
+  const AdaptiveSpec noTaps = {LMS, 0, 0.1f, 0.0f, 1};
+  const AdaptiveSpec noStep = {NLMS, 8, 0.0f, 0.0f, 1};
+  const AdaptiveSpec badStep = {NLMS, 8, NAN, 0.0f, 1};
+  const AdaptiveSpec badLeak = {LEAKY_LMS, 8, 0.1f, 10.0f, 1};
+  const AdaptiveSpec noInterval = {LMS, 8, 0.1f, 0.0f, 0};
+  ASSERT_THROW(AdaptiveFilter{noTaps}, std::invalid_argument);
+  ASSERT_THROW(AdaptiveFilter{noStep}, std::invalid_argument);
+  ASSERT_THROW(AdaptiveFilter{badStep}, std::invalid_argument);
+  ASSERT_THROW(AdaptiveFilter{badLeak}, std::invalid_argument);
+  ASSERT_THROW(AdaptiveFilter{noInterval}, std::invalid_argument);
+  const AdaptiveSpec leakIgnored = {LMS, 8, 0.1f, 10.0f, 1};
+  AdaptiveFilter adaptive(leakIgnored);
+  ASSERT_EQ(8u, adaptive.GetNumInWeights());
+  ASSERT_TRUE(AdaptiveFilter::IsKernelSupported(
+      AdaptiveFilter::SCALAR_KERNEL));
+}
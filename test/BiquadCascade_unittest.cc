@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////
+/// @class BiquadCascadeTest
+/// @ingroup DSP
+///
+/// @brief Test class for the second order section cascade.
+///        The cascade is checked against the direct form
+///        Filter for a short filter, and against a double
+///        precision direct form reference for an 8th order
+///        filter.
+///////////////////////////////////////////////////////////////
+#include "../BiquadCascade.hh"
+#include "../Filter.hh"
+#include "../Polynomial.hh"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <stdexcept>
+
+class BiquadCascadeTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Cascade test setup function
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+	 sample_signal[0] =  0.0376; sample_signal[1] = 0.1914;
+	 sample_signal[2] = -0.0321; sample_signal[3] = 0.2486;
+	 sample_signal[4] =  0.2722; sample_signal[5] = 0.2189;
+	 sample_signal[6] =  0.3395; sample_signal[7] = 0.4517;
+	 sample_signal[8] =  0.7344; sample_signal[9] = 0.7320;
+     error_tolerance = 0.0001;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the test signal.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int TEST_SIGNAL_LENGTH = 10;
+  ////////////////////////////////////////////////////////////
+  /// @brief Noisy sin(x) test signal, x = [0, 1, 2, ... 9]
+  ////////////////////////////////////////////////////////////
+  float sample_signal[TEST_SIGNAL_LENGTH];
+  ////////////////////////////////////////////////////////////
+  /// @brief Allowed difference from the reference output.
+  ////////////////////////////////////////////////////////////
+  float error_tolerance;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Hand built sections give the textbook output.
+////////////////////////////////////////////////////////////
+TEST_F(BiquadCascadeTest, SectionConstructor) {
+  BiquadSection sections[2] = {{0.5f, 0.5f, 0.0f, 0.0f, 0.0f},
+                               {1.0f, 0.0f, 0.0f, -0.5f, 0.0f}};
+  BiquadCascade cascade(2, sections);
+  ASSERT_EQ(2u, cascade.GetNumSections());
+  /// Two point average followed by y[n] = x[n] + 0.5*y[n-1].
+  float average = 0.0, previous = 0.0, last = 0.0;
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+	average = 0.5f*sample_signal[i] + 0.5f*previous;
+	previous = sample_signal[i];
+	last = average + 0.5f*last;
+	ASSERT_NEAR(last, cascade.filter(sample_signal[i]), 1e-6);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Converted weights match the direct form Filter,
+///        per sample and per block.
+////////////////////////////////////////////////////////////
+TEST_F(BiquadCascadeTest, FromWeightsMatchesFilter) {
+  float inWeights[4] = {0.1f, 0.3f, 0.3f, 0.1f};
+  float outWeights[4] = {1.0f, -0.9f, 0.45f, -0.08f};
+  Filter reference(4, inWeights, 4, outWeights);
+  BiquadCascade sampleCascade(BiquadCascade::FromWeights(4, inWeights,
+                                                         4, outWeights));
+  BiquadCascade blockCascade(BiquadCascade::FromWeights(4, inWeights,
+                                                        4, outWeights));
+  ASSERT_EQ(2u, sampleCascade.GetNumSections());
+  float blockOutput[TEST_SIGNAL_LENGTH];
+  blockCascade.filterBlock(sample_signal, blockOutput, 4);
+  blockCascade.filterBlock(sample_signal + 4, blockOutput + 4,
+                           TEST_SIGNAL_LENGTH - 4);
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+	float expected = reference.filter(sample_signal[i]);
+	ASSERT_NEAR(expected, sampleCascade.filter(sample_signal[i]),
+	            error_tolerance);
+	ASSERT_NEAR(expected, blockOutput[i], error_tolerance);
+  }
+  /// A moving average converts to a single FIR section.
+  float avgWeights[3] = {0.33333f, 0.33333f, 0.33333f};
+  float unity[1] = {1.0f};
+  BiquadCascade average(BiquadCascade::FromWeights(3, avgWeights, 1, unity));
+  Filter averageReference(3, avgWeights, 1, unity);
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+	ASSERT_NEAR(averageReference.filter(sample_signal[i]),
+	            average.filter(sample_signal[i]), error_tolerance);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief An 8th order low pass with poles close to the unit
+///        circle, run in float as sections, matches a double
+///        precision direct form evaluation of the same weights.
+////////////////////////////////////////////////////////////
+TEST_F(BiquadCascadeTest, HighOrderMatchesDoubleReference) {
+  const unsigned int ORDER = 8;
+  std::vector<double> b(1, 1.0), a(1, 1.0);
+  for (unsigned int k=0; k<ORDER/2; k++){
+    const double radius = 0.80 + 0.04*k;
+    const double angle = 0.08 + 0.05*k;
+    std::vector<double> zeros(3), poles(3);
+    zeros[0] = 1.0; zeros[1] = 2.0; zeros[2] = 1.0;
+    poles[0] = 1.0; poles[1] = -2.0*radius*std::cos(angle);
+    poles[2] = radius*radius;
+    b = polynomialMultiply(b, zeros);
+    a = polynomialMultiply(a, poles);
+  }
+  /// Scale for unity gain at DC.
+  double sumB = 0.0, sumA = 0.0;
+  for (unsigned int i=0; i<=ORDER; i++){ sumB += b[i]; sumA += a[i]; }
+  float inWeights[ORDER + 1], outWeights[ORDER + 1];
+  double bRounded[ORDER + 1], aRounded[ORDER + 1];
+  for (unsigned int i=0; i<=ORDER; i++){
+    inWeights[i] = static_cast<float>(b[i]*sumA/sumB);
+    outWeights[i] = static_cast<float>(a[i]);
+    bRounded[i] = inWeights[i];
+    aRounded[i] = outWeights[i];
+  }
+  BiquadCascade cascade(BiquadCascade::FromWeights(ORDER + 1, inWeights,
+                                                   ORDER + 1, outWeights));
+  ASSERT_EQ(ORDER/2, cascade.GetNumSections());
+  double x[ORDER + 1] = {0.0}, y[ORDER + 1] = {0.0};
+  for (unsigned int n=0; n<400; n++){
+    const float input = (n % 50 < 25) ? 1.0f : -1.0f;
+    for (unsigned int i=ORDER; i>0; i--){ x[i] = x[i-1]; y[i] = y[i-1]; }
+    x[0] = input;
+    double acc = 0.0;
+    for (unsigned int i=0; i<=ORDER; i++){ acc += bRounded[i]*x[i]; }
+    for (unsigned int i=1; i<=ORDER; i++){ acc -= aRounded[i]*y[i]; }
+    y[0] = acc;
+    ASSERT_NEAR(y[0], cascade.filter(input), 1e-3);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Degenerate weights and section lists are rejected.
+////////////////////////////////////////////////////////////
+TEST_F(BiquadCascadeTest, InvalidArguments) {
+  float inWeights[2] = {1.0f, 1.0f};
+  float zeroGain[2] = {0.0f, 1.0f};
+  ASSERT_THROW(BiquadCascade::FromWeights(2, inWeights, 2, zeroGain),
+               std::invalid_argument);
+  ASSERT_THROW(BiquadCascade(std::vector<BiquadSection>()),
+               std::invalid_argument);
+}
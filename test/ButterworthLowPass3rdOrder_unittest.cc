@@ -86,3 +86,36 @@ TEST_F(ButterworthLowPass3rdOrderTest, DefaultConstructor) {
 	ASSERT_NEAR(expected_filtered[i], filterOutput, error_tolerance);
   }
 }
+
+////////////////////////////////////////////////////////////
+/// @brief Unit test for the specialized filterBlock. The
+///        block outputs must be bit-identical to calling
+///        filter() once per sample, including across blocks.
+////////////////////////////////////////////////////////////
+TEST_F(ButterworthLowPass3rdOrderTest, FilterBlock) {
+  ButterworthLowPass3rdOrder sampleFilter;
+  ButterworthLowPass3rdOrder blockFilter;
+  float blockOutput[TEST_SIGNAL_LENGTH];
+  blockFilter.filterBlock(sample_signal, blockOutput, 3);
+  blockFilter.filterBlock(sample_signal + 3, blockOutput + 3,
+                          TEST_SIGNAL_LENGTH - 3);
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+	float filterOutput = sampleFilter.filter(sample_signal[i]);
+	ASSERT_EQ(filterOutput, blockOutput[i]);
+  }
+  /// Mixing the two entry points must carry the state across.
+  ASSERT_EQ(sampleFilter.filter(0.5), blockFilter.filter(0.5));
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Unit test for the designed Butterworth c'tor. The
+///        weights match scipy.signal.butter(2, 1 Hz) at 500 Hz.
+////////////////////////////////////////////////////////////
+TEST_F(ButterworthLowPass3rdOrderTest, DesignedConstructor) {
+  ButterworthLowPass3rdOrder lowPass(1.0, 500.0);
+  ASSERT_NEAR(3.91302e-05, lowPass.GetInputWeights()[0], 1e-9);
+  ASSERT_NEAR(7.82604e-05, lowPass.GetInputWeights()[1], 1e-9);
+  ASSERT_NEAR(3.91302e-05, lowPass.GetInputWeights()[2], 1e-9);
+  ASSERT_NEAR(-1.98222893, lowPass.GetOutputWeights()[1], 1e-6);
+  ASSERT_NEAR(0.98238545, lowPass.GetOutputWeights()[2], 1e-6);
+}
@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////////////////
+/// @class CaptureReaderTest
+/// @ingroup DSP
+///
+/// @brief Test class for the memory mapped CaptureReader.
+///        Small CSV and packed binary captures are written to
+///        temporary files and decoded back.
+///////////////////////////////////////////////////////////////
+#include "../CaptureReader.hh"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+class CaptureReaderTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Capture reader test setup function. Creates an
+  ///        empty temporary file.
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     char name[] = "/tmp/CaptureReaderTestXXXXXX";
+     const int fd = mkstemp(name);
+     ASSERT_GE(fd, 0);
+     close(fd);
+     path = name;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Removes the temporary file.
+  ////////////////////////////////////////////////////////////
+  virtual void TearDown(void) {
+     std::remove(path.c_str());
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Replaces the temporary file's contents.
+  ////////////////////////////////////////////////////////////
+  void writeFile(const std::string& contents){
+     std::FILE* file = std::fopen(path.c_str(), "wb");
+     ASSERT_TRUE(file != NULL);
+     std::fwrite(contents.data(), 1, contents.size(), file);
+     std::fclose(file);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Path of the temporary capture.
+  ////////////////////////////////////////////////////////////
+  std::string path;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief CSV header names, column selection by name and
+///        index, CRLF endings and blank lines.
+////////////////////////////////////////////////////////////
+TEST_F(CaptureReaderTest, CsvColumns) {
+  writeFile("Time (s), \"Velocity Cmd (rpm)\",Sensed Velocity (rpm)\r\n"
+            "0.000,10,0.0376\r\n"
+            "0.002,10,0.1914\r\n"
+            "\r\n"
+            "0.004,-1.5e1,-.0321\r\n"
+            "0.006,10,+2.486E-1");
+  CaptureReader capture(path);
+  ASSERT_EQ(CaptureReader::CSV_FORMAT, capture.GetFormat());
+  ASSERT_EQ(3u, capture.GetColumnNames().size());
+  ASSERT_EQ("Velocity Cmd (rpm)", capture.GetColumnNames()[1]);
+  ASSERT_EQ(2u, capture.findColumn("Sensed Velocity (rpm)"));
+  ASSERT_EQ(0u, capture.findColumn("0"));
+  ASSERT_THROW(capture.findColumn("Torque"), std::invalid_argument);
+
+  std::vector<unsigned int> selection;
+  selection.push_back(capture.findColumn("Sensed Velocity (rpm)"));
+  selection.push_back(capture.findColumn("Velocity Cmd (rpm)"));
+  capture.selectColumns(selection);
+  float frames[8];
+  ASSERT_EQ(3u, capture.readFrames(frames, 3));
+  ASSERT_FLOAT_EQ(0.0376f, frames[0]); ASSERT_FLOAT_EQ(10.0f, frames[1]);
+  ASSERT_FLOAT_EQ(0.1914f, frames[2]); ASSERT_FLOAT_EQ(10.0f, frames[3]);
+  ASSERT_FLOAT_EQ(-0.0321f, frames[4]); ASSERT_FLOAT_EQ(-15.0f, frames[5]);
+  ASSERT_EQ(1u, capture.readFrames(frames, 3));
+  ASSERT_FLOAT_EQ(0.2486f, frames[0]);
+  ASSERT_EQ(0u, capture.readFrames(frames, 3));
+
+  capture.rewind();
+  capture.selectColumn(0);
+  ASSERT_EQ(4u, capture.readFrames(frames, 8));
+  ASSERT_FLOAT_EQ(0.006f, frames[3]);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Malformed numbers and short rows are reported.
+////////////////////////////////////////////////////////////
+TEST_F(CaptureReaderTest, CsvErrors) {
+  writeFile("a,b\n1,2\n3,x4\n5\n");
+  CaptureReader capture(path);
+  float frames[4];
+  ASSERT_EQ(1u, capture.readFrames(frames, 1));
+  ASSERT_THROW(capture.readFrames(frames, 1), std::runtime_error);
+
+  writeFile("a,b\n5\n");
+  CaptureReader shortRow(path);
+  ASSERT_THROW(shortRow.readFrames(frames, 1), std::runtime_error);
+  ASSERT_THROW(CaptureReader("/nonexistent/capture.csv"), std::runtime_error);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief A packed binary capture written with
+///        writeBinaryHeader reads back whole and by column.
+////////////////////////////////////////////////////////////
+TEST_F(CaptureReaderTest, Binary) {
+  std::vector<std::string> names;
+  names.push_back("Velocity Cmd (rpm)");
+  names.push_back("Sensed Velocity (rpm)");
+  names.push_back("x");
+  const float data[12] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  ASSERT_TRUE(CaptureReader::writeBinaryHeader(file, names));
+  ASSERT_EQ(0, std::ftell(file) % 4);
+  std::fwrite(data, sizeof(float), 12, file);
+  std::fclose(file);
+
+  CaptureReader capture(path);
+  ASSERT_EQ(CaptureReader::BINARY_FORMAT, capture.GetFormat());
+  ASSERT_EQ(names, capture.GetColumnNames());
+  float frames[12];
+  ASSERT_EQ(4u, capture.readFrames(frames, 10));
+  for (unsigned int i=0; i<12; i++){
+    ASSERT_EQ(data[i], frames[i]);
+  }
+  capture.rewind();
+  std::vector<unsigned int> selection;
+  selection.push_back(2);
+  selection.push_back(0);
+  capture.selectColumns(selection);
+  ASSERT_EQ(3u, capture.readFrames(frames, 3));
+  ASSERT_EQ(3.0f, frames[0]); ASSERT_EQ(1.0f, frames[1]);
+  ASSERT_EQ(9.0f, frames[4]); ASSERT_EQ(7.0f, frames[5]);
+  ASSERT_EQ(1u, capture.readFrames(frames, 3));
+  ASSERT_EQ(12.0f, frames[0]);
+  ASSERT_THROW(capture.selectColumn(3), std::invalid_argument);
+
+  /// A trailing partial frame is rejected.
+  file = std::fopen(path.c_str(), "ab");
+  std::fwrite(data, sizeof(float), 1, file);
+  std::fclose(file);
+  ASSERT_THROW(CaptureReader(path.c_str()), std::runtime_error);
+
+  /// So is a data offset that would misalign the frames.
+  const char misaligned[22] = {'F', 'L', 'T', 'C', 'A', 'P', '1', '\0',
+                               1, 0, 0, 0, 18, 0, 0, 0, 'x', '\n',
+                               0, 0, 0, 0};
+  writeFile(std::string(misaligned, sizeof(misaligned)));
+  ASSERT_THROW(CaptureReader(path.c_str()), std::runtime_error);
+}
@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////
+/// @class DecimatorTest
+/// @ingroup DSP
+///
+/// @brief Test class for the decimating filter. Its outputs
+///        must be every factor-th output of a direct form
+///        Filter with the same taps.
+///////////////////////////////////////////////////////////////
+#include "../Decimator.hh"
+#include "../Filter.hh"
+#include "gtest/gtest.h"
+#include "TestSignals.hh"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+class DecimatorTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Decimator test setup function
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     signal = twoToneSignal(SIGNAL_LENGTH);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the test signal.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int SIGNAL_LENGTH = 1000;
+  ////////////////////////////////////////////////////////////
+  /// @brief Test signal, see twoToneSignal.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> signal;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Factors and tap counts on either side of each
+///        other, fed in uneven blocks that split the output
+///        phase, filtering in place.
+////////////////////////////////////////////////////////////
+TEST_F(DecimatorTest, MatchesFilterAndDiscard) {
+  const unsigned int factors[] = {1, 3, 10};
+  const unsigned int lengths[] = {1, 7, 40};
+  for (unsigned int factor : factors){
+    for (unsigned int numTaps : lengths){
+      Filter direct(arbitraryTaps(numTaps), std::vector<float>(1, 1.0f));
+      Decimator decimator(arbitraryTaps(numTaps), factor);
+      std::vector<float> expected;
+      for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+        const float y = direct.filter(signal[n]);
+        if (n % factor == 0){
+          expected.push_back(y);
+        }
+      }
+      std::vector<float> buffer(signal);
+      std::vector<float> output;
+      for (unsigned int n=0; n<SIGNAL_LENGTH; n+=13){
+        const unsigned int count = std::min(13u, SIGNAL_LENGTH - n);
+        ASSERT_LE(decimator.GetMaxOutputs(count), count);
+        const unsigned int written =
+            decimator.filterBlock(&buffer[n], &buffer[n], count);
+        output.insert(output.end(), &buffer[n], &buffer[n] + written);
+      }
+      ASSERT_EQ(expected.size(), output.size());
+      for (size_t m=0; m<expected.size(); m++){
+        ASSERT_NEAR(expected[m], output[m], 1e-5)
+            << factor << " " << numTaps << " " << m;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Reset restarts the output phase; rejected setups.
+////////////////////////////////////////////////////////////
+TEST_F(DecimatorTest, Construction) {
+  Decimator decimator(arbitraryTaps(5), 4);
+  ASSERT_EQ(4u, decimator.GetFactor());
+  ASSERT_EQ(5u, decimator.GetNumTaps());
+  ASSERT_EQ(3u, decimator.GetMaxOutputs(9));
+  std::vector<float> first(3), second(3);
+  ASSERT_EQ(3u, decimator.filterBlock(&signal[0], &first[0], 9));
+  decimator.reset();
+  ASSERT_EQ(3u, decimator.filterBlock(&signal[0], &second[0], 9));
+  ASSERT_EQ(first, second);
+  ASSERT_THROW(Decimator(arbitraryTaps(5), 0), std::invalid_argument);
+  ASSERT_THROW(Decimator(std::vector<float>(), 2), std::invalid_argument);
+}
@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////
+/// @class FftFilterTest
+/// @ingroup DSP
+///
+/// @brief Test class for the partitioned FFT FIR filter. Its
+///        outputs must track a direct form Filter with the
+///        same taps, sample for sample.
+///////////////////////////////////////////////////////////////
+#include "../FftFilter.hh"
+#include "../FilterAnalysis.hh"
+#include "gtest/gtest.h"
+#include "TestSignals.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+class FftFilterTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief FFT filter test setup function
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     signal = twoToneSignal(SIGNAL_LENGTH);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Windowed sinc low pass taps.
+  ////////////////////////////////////////////////////////////
+  static std::vector<float> lowPassTaps(unsigned int numTaps){
+     std::vector<float> taps(numTaps);
+     const double pi = 3.14159265358979323846;
+     for (unsigned int i=0; i<numTaps; i++){
+       const double t = i - 0.5*(numTaps - 1);
+       const double sinc = (t == 0.0) ? 0.2 : std::sin(0.2*pi*t)/(pi*t);
+       taps[i] = static_cast<float>(sinc*(0.54 - 0.46*std::cos(
+           2.0*pi*i/(numTaps > 1 ? numTaps - 1 : 1))));
+     }
+     return taps;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Checks an FftFilter against direct form, per
+  ///        sample and in uneven blocks.
+  ////////////////////////////////////////////////////////////
+  void checkTaps(unsigned int numTaps, unsigned int partitionSize){
+     const std::vector<float> taps = lowPassTaps(numTaps);
+     Filter direct(taps, std::vector<float>(1, 1.0f));
+     FftFilter perSample(taps, partitionSize);
+     FftFilter blocks(taps, partitionSize);
+     std::vector<float> output(signal);
+     for (unsigned int n=0; n<SIGNAL_LENGTH; n+=37){
+       blocks.filterBlock(&output[n], &output[n],
+                          std::min(37u, SIGNAL_LENGTH - n));
+     }
+     for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+       const float y = perSample.filter(signal[n]);
+       ASSERT_NEAR(direct.filter(signal[n]), y, 1e-4) << numTaps << " " << n;
+       ASSERT_EQ(y, output[n]);
+     }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the test signal.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int SIGNAL_LENGTH = 2000;
+  ////////////////////////////////////////////////////////////
+  /// @brief Test signal, see twoToneSignal.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> signal;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Tap counts shorter than, equal to, and many times
+///        the partition, including uneven last partitions.
+////////////////////////////////////////////////////////////
+TEST_F(FftFilterTest, MatchesDirectForm) {
+  checkTaps(1, 16);
+  checkTaps(16, 16);
+  checkTaps(17, 16);
+  checkTaps(300, 16);
+  checkTaps(513, 64);
+  checkTaps(1024, 64);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filter style weights, reset, and rejected setups.
+////////////////////////////////////////////////////////////
+TEST_F(FftFilterTest, Construction) {
+  std::vector<float> taps = lowPassTaps(100);
+  std::vector<float> scaled(taps);
+  for (size_t i=0; i<scaled.size(); i++){
+    scaled[i] *= 2.0f;
+  }
+  float two[1] = {2.0f};
+  FftFilter filter(100, &scaled[0], 1, two, 32);
+  ASSERT_EQ(100u, filter.GetNumTaps());
+  ASSERT_EQ(32u, filter.GetPartitionSize());
+  FftFilter reference(taps, 32);
+  for (unsigned int n=0; n<200; n++){
+    ASSERT_NEAR(reference.filter(signal[n]), filter.filter(signal[n]), 1e-5);
+  }
+  filter.reset();
+  reference.reset();
+  Filter& asFilter = filter;
+  for (unsigned int n=0; n<200; n++){
+    ASSERT_NEAR(reference.filter(signal[n]), asFilter.filter(signal[n]),
+                1e-5);
+  }
+
+  float a[2] = {1.0f, 0.5f};
+  ASSERT_THROW(FftFilter(100, &taps[0], 2, a), std::invalid_argument);
+  ASSERT_THROW(FftFilter(std::vector<float>()), std::invalid_argument);
+  ASSERT_THROW(FftFilter(taps, 48), std::invalid_argument);
+  ASSERT_THROW(FftFilter(taps, 0), std::invalid_argument);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The base Filter holds the taps and the delay
+///        lines: the impulse response is the taps, a saved
+///        state restarts a fresh filter, and new weights
+///        carry the history over as a direct form Filter does.
+////////////////////////////////////////////////////////////
+TEST_F(FftFilterTest, BaseFilterView) {
+  const std::vector<float> taps = lowPassTaps(300);
+  FftFilter filter(taps, 32);
+  ASSERT_EQ(300u, filter.GetNumInWeights());
+  ASSERT_EQ(1u, filter.GetNumOutWeights());
+  std::vector<float> impulse(300);
+  FilterAnalysis::impulseResponse(filter, &impulse[0], 300);
+  for (unsigned int i=0; i<300; i++){
+    ASSERT_FLOAT_EQ(taps[i], impulse[i]);
+  }
+
+  Filter direct(taps, std::vector<float>(1, 1.0f));
+  const unsigned int half = 517;
+  std::vector<float> output(256);
+  filter.filterBlock(&signal[0], &output[0], 256);
+  for (unsigned int n=0; n<256; n++){
+    direct.filter(signal[n]);
+  }
+  for (unsigned int n=256; n<half; n++){
+    filter.filter(signal[n]);
+    direct.filter(signal[n]);
+  }
+  const FilterState state = filter.SaveState();
+  ASSERT_EQ(signal[half - 1], state.inputs[0]);
+  ASSERT_EQ(signal[half - 300], state.inputs[299]);
+  FftFilter restarted(taps, 32);
+  restarted.RestoreState(state);
+  for (unsigned int n=half; n<SIGNAL_LENGTH/2; n++){
+    const float y = direct.filter(signal[n]);
+    ASSERT_NEAR(y, filter.filter(signal[n]), 1e-4) << n;
+    ASSERT_NEAR(y, restarted.filter(signal[n]), 1e-4) << n;
+  }
+
+  const std::vector<float> shorter = lowPassTaps(40);
+  const float one = 1.0f;
+  Filter& asFilter = restarted;
+  asFilter.SetWeights(40, &shorter[0], 1, &one);
+  direct.SetWeights(40, &shorter[0], 1, &one);
+  ASSERT_EQ(40u, restarted.GetNumTaps());
+  for (unsigned int n=SIGNAL_LENGTH/2; n<SIGNAL_LENGTH; n++){
+    ASSERT_NEAR(direct.filter(signal[n]), restarted.filter(signal[n]), 1e-4)
+        << n;
+  }
+  float a[2] = {1.0f, 0.5f};
+  ASSERT_THROW(asFilter.SetWeights(40, &shorter[0], 2, a),
+               std::invalid_argument);
+}
@@ -0,0 +1,48 @@
+///////////////////////////////////////////////////////////////
+/// @class FftTest
+/// @ingroup DSP
+///
+/// @brief Test class for the real FFT. The transform is
+///        checked against a direct double precision DFT.
+///////////////////////////////////////////////////////////////
+#include "../Fft.hh"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+////////////////////////////////////////////////////////////
+/// @brief Every size from 2 to 1024 matches the direct DFT,
+///        and inverse(forward(x)) is size times x.
+////////////////////////////////////////////////////////////
+TEST(FftTest, MatchesDft) {
+  const double pi = 3.14159265358979323846;
+  for (unsigned int size=2; size<=1024; size*=2){
+    Fft fft(size);
+    ASSERT_EQ(size/2 + 1, fft.GetNumBins());
+    std::vector<float> signal(size);
+    for (unsigned int n=0; n<size; n++){
+      signal[n] = std::sin(0.37f*n) + 0.5f*std::cos(2.1f*n) + 0.25f;
+    }
+    std::vector<std::complex<float> > spectrum(fft.GetNumBins());
+    fft.forward(&signal[0], &spectrum[0]);
+    for (unsigned int k=0; k<fft.GetNumBins(); k++){
+      std::complex<double> expected;
+      for (unsigned int n=0; n<size; n++){
+        expected += static_cast<double>(signal[n])*
+            std::polar(1.0, -2.0*pi*k*n/size);
+      }
+      ASSERT_NEAR(expected.real(), spectrum[k].real(), 1e-4*size);
+      ASSERT_NEAR(expected.imag(), spectrum[k].imag(), 1e-4*size);
+    }
+    std::vector<float> restored(size);
+    fft.inverse(&spectrum[0], &restored[0]);
+    for (unsigned int n=0; n<size; n++){
+      ASSERT_NEAR(size*signal[n], restored[n], 1e-4*size);
+    }
+  }
+  ASSERT_THROW(Fft(0), std::invalid_argument);
+  ASSERT_THROW(Fft(1), std::invalid_argument);
+  ASSERT_THROW(Fft(96), std::invalid_argument);
+}
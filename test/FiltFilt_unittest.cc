@@ -0,0 +1,199 @@
+///////////////////////////////////////////////////////////////
+/// @class FiltFiltTest
+/// @ingroup DSP
+///
+/// @brief Test class for zero phase filtering. The results
+///        must match a double precision transcription of
+///        scipy.signal.filtfilt's default path, which pads and
+///        reverses whole copies of the signal.
+///////////////////////////////////////////////////////////////
+#include "../ButterworthLowPass3rdOrder.hh"
+#include "../CaptureReader.hh"
+#include "../FiltFilt.hh"
+#include "../FilterDesign.hh"
+#include "../MovingAverage.hh"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+class FiltFiltTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Filtfilt test setup function
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     FilterSpec spec = {BUTTERWORTH, LOW_PASS, 3, 500.0, 40.0, 0.0, 0.0};
+     FilterDesign(spec).GetWeights(b, a);
+     signal.resize(SIGNAL_LENGTH);
+     for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+       signal[n] = 2.0f + std::sin(0.02f*n) + 0.3f*std::sin(2.2f*n);
+     }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Direct form filter in double precision, starting
+  ///        in the steady state for its first input.
+  ////////////////////////////////////////////////////////////
+  std::vector<double> steadyLfilter(const std::vector<double>& x) const {
+     double sumB = 0.0, sumA = 0.0;
+     for (size_t i=0; i<b.size(); i++){ sumB += b[i]/a[0]; }
+     for (size_t i=0; i<a.size(); i++){ sumA += a[i]/a[0]; }
+     std::vector<double> y(x.size());
+     for (size_t n=0; n<x.size(); n++){
+       double value = 0.0;
+       for (size_t k=0; k<b.size(); k++){
+         value += b[k]/a[0]*(n >= k ? x[n - k] : x[0]);
+       }
+       for (size_t k=1; k<a.size(); k++){
+         value -= a[k]/a[0]*(n >= k ? y[n - k] : x[0]*sumB/sumA);
+       }
+       y[n] = value;
+     }
+     return y;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief scipy's filtfilt with padtype 'odd'.
+  ////////////////////////////////////////////////////////////
+  std::vector<double> reference(const std::vector<float>& x,
+                                size_t pad) const {
+     const size_t n = x.size();
+     std::vector<double> ext;
+     for (size_t k=pad; k>0; k--){ ext.push_back(2.0*x[0] - x[k]); }
+     ext.insert(ext.end(), x.begin(), x.end());
+     for (size_t k=1; k<=pad; k++){
+       ext.push_back(2.0*x[n - 1] - x[n - 1 - k]);
+     }
+     std::vector<double> y = steadyLfilter(ext);
+     std::reverse(y.begin(), y.end());
+     y = steadyLfilter(y);
+     std::reverse(y.begin(), y.end());
+     return std::vector<double>(y.begin() + pad, y.begin() + pad + n);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the test signal; not a multiple of the
+  ///        block size.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int SIGNAL_LENGTH = 10000;
+  ////////////////////////////////////////////////////////////
+  /// @brief Low pass weights.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> b, a;
+  ////////////////////////////////////////////////////////////
+  /// @brief Test signal: an offset, a slow sine and a fast one.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> signal;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Default, zero and long pads, filtering in place.
+////////////////////////////////////////////////////////////
+TEST_F(FiltFiltTest, MatchesReference) {
+  const Filter filter(b, a);
+  const unsigned int pads[] = {0, 12, 500};
+  for (unsigned int pad : pads){
+    const std::vector<double> expected = reference(signal, pad);
+    std::vector<float> output(signal);
+    filtfilt(filter, &output[0], &output[0], SIGNAL_LENGTH, 1, pad);
+    for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+      ASSERT_NEAR(expected[n], output[n], 1e-4) << pad << " " << n;
+    }
+  }
+  std::vector<float> output(SIGNAL_LENGTH);
+  filtfilt(filter, &signal[0], &output[0], SIGNAL_LENGTH);
+  const std::vector<double> expected = reference(signal, 3*a.size());
+  for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+    ASSERT_NEAR(expected[n], output[n], 1e-4) << n;
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Interleaved channels are filtered independently,
+///        through a packed binary capture as well.
+////////////////////////////////////////////////////////////
+TEST_F(FiltFiltTest, ChannelsAndCaptures) {
+  const Filter filter(b, a);
+  std::vector<float> frames(2*SIGNAL_LENGTH);
+  for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+    frames[2*n] = signal[n];
+    frames[2*n + 1] = -0.5f*signal[SIGNAL_LENGTH - 1 - n];
+  }
+  std::vector<float> first(SIGNAL_LENGTH), second(SIGNAL_LENGTH);
+  for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+    first[n] = frames[2*n];
+    second[n] = frames[2*n + 1];
+  }
+  filtfilt(filter, &first[0], &first[0], SIGNAL_LENGTH);
+  filtfilt(filter, &second[0], &second[0], SIGNAL_LENGTH);
+
+  char inputName[] = "/tmp/FiltFiltInputXXXXXX";
+  char outputName[] = "/tmp/FiltFiltOutputXXXXXX";
+  close(mkstemp(inputName));
+  close(mkstemp(outputName));
+  std::vector<std::string> names;
+  names.push_back("Velocity Cmd (rpm)");
+  names.push_back("Sensed Velocity (rpm)");
+  std::FILE* file = std::fopen(inputName, "wb");
+  ASSERT_TRUE(CaptureReader::writeBinaryHeader(file, names));
+  std::fwrite(&frames[0], sizeof(float), frames.size(), file);
+  std::fclose(file);
+
+  filtfilt(filter, &frames[0], &frames[0], SIGNAL_LENGTH, 2);
+  filtfiltCapture(filter, inputName, outputName);
+  CaptureReader result(outputName);
+  ASSERT_EQ(names, result.GetColumnNames());
+  ASSERT_EQ(static_cast<size_t>(SIGNAL_LENGTH),
+            result.GetNumBinaryFrames());
+  const float* filtered = result.GetBinaryFrames();
+  for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+    ASSERT_EQ(first[n], frames[2*n]);
+    ASSERT_EQ(second[n], frames[2*n + 1]);
+    ASSERT_EQ(frames[2*n], filtered[2*n]);
+    ASSERT_EQ(frames[2*n + 1], filtered[2*n + 1]);
+  }
+  ASSERT_THROW(filtfiltCapture(filter, inputName, inputName),
+               std::invalid_argument);
+  std::remove(inputName);
+  std::remove(outputName);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief A derived filter that is its difference equation
+///        is used like a Filter with the same weights.
+////////////////////////////////////////////////////////////
+TEST_F(FiltFiltTest, DerivedDifferenceEquation) {
+  const ButterworthLowPass3rdOrder lowPass3(50.0, 500.0);
+  const Filter plain(lowPass3);
+  std::vector<float> expected(SIGNAL_LENGTH);
+  std::vector<float> output(SIGNAL_LENGTH);
+  filtfilt(plain, &signal[0], &expected[0], SIGNAL_LENGTH);
+  filtfilt(lowPass3, &signal[0], &output[0], SIGNAL_LENGTH);
+  for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+    ASSERT_EQ(expected[n], output[n]) << n;
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Rejected setups.
+////////////////////////////////////////////////////////////
+TEST_F(FiltFiltTest, Errors) {
+  const Filter filter(b, a);
+  std::vector<float> output(SIGNAL_LENGTH);
+  ASSERT_THROW(filtfilt(filter, &signal[0], &output[0], 12),
+               std::invalid_argument);
+  ASSERT_THROW(filtfilt(filter, &signal[0], &output[0], 100, 0),
+               std::invalid_argument);
+  MovingAverage average(4);
+  ASSERT_THROW(filtfilt(average, &signal[0], &output[0], 100),
+               std::invalid_argument);
+  float one[2] = {1.0f, 0.0f};
+  float integrator[2] = {1.0f, -1.0f};
+  ASSERT_THROW(filtfilt(Filter(2, one, 2, integrator), &signal[0],
+                        &output[0], 100), std::invalid_argument);
+}
@@ -0,0 +1,196 @@
+///////////////////////////////////////////////////////////////
+/// @class FilterAnalysisTest
+/// @ingroup DSP
+///
+/// @brief Test class for the filter analysis. Responses,
+///        delays and roots are checked against closed forms
+///        and against each other.
+///////////////////////////////////////////////////////////////
+#include "../FilterAnalysis.hh"
+#include "../Polynomial.hh"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+class FilterAnalysisTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Filter analysis test setup function. The IIR
+  ///        filter has a complex pole pair of radius 0.9 and
+  ///        a real pole at 0.5, and zeros at -1.
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     const std::complex<double> pair = std::polar(0.9, 0.3);
+     poles.push_back(pair);
+     poles.push_back(std::conj(pair));
+     poles.push_back(std::complex<double>(0.5, 0.0));
+     const std::vector<double> a = polynomialFromRoots(poles);
+     const std::vector<double> b = polynomialFromRoots(
+         std::vector<std::complex<double> >(3, -1.0));
+     iirB.assign(b.begin(), b.end());
+     iirA.assign(a.begin(), a.end());
+     for (float& weight : iirB){
+       weight *= 0.01f;
+     }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Evaluates a weight polynomial in exp(-i w).
+  ////////////////////////////////////////////////////////////
+  static std::complex<double> evaluate(const std::vector<float>& weights,
+                                       double w){
+    std::complex<double> sum = 0.0;
+    for (size_t k=0; k<weights.size(); k++){
+      sum += static_cast<double>(weights[k])*std::polar(1.0, -w*k);
+    }
+    return sum;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief The IIR filter's poles and weights.
+  ////////////////////////////////////////////////////////////
+  std::vector<std::complex<double> > poles;
+  std::vector<float> iirB;
+  std::vector<float> iirA;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief freqz grid against a direct sum, and a custom grid
+///        with a size that is not a multiple of the lanes.
+////////////////////////////////////////////////////////////
+TEST_F(FilterAnalysisTest, FrequencyResponse) {
+  Filter iir(iirB, iirA);
+  FilterAnalysis analysis;
+  ASSERT_EQ(512u, analysis.GetNumPoints());
+  std::vector<std::complex<double> > h(analysis.GetNumPoints());
+  analysis.frequencyResponse(iir, &h[0]);
+  for (unsigned int k=0; k<analysis.GetNumPoints(); k++){
+    const double w = analysis.GetFrequencies()[k];
+    ASSERT_NEAR(3.14159265358979*k/512, w, 1e-12);
+    const std::complex<double> expected = evaluate(iirB, w)/evaluate(iirA, w);
+    ASSERT_NEAR(0.0, std::abs(expected - h[k]), 1e-9*std::abs(expected) + 1e-15)
+        << k;
+  }
+  double sumB = 0.0, sumA = 0.0;
+  for (size_t k=0; k<iirB.size(); k++){
+    sumB += iirB[k];
+    sumA += iirA[k];
+  }
+  ASSERT_NEAR(sumB/sumA, h[0].real(), 1e-9);
+  ASSERT_EQ(0.0, h[0].imag());
+
+  std::vector<double> frequencies;
+  for (unsigned int k=0; k<13; k++){
+    frequencies.push_back(3.0*k/13);
+  }
+  FilterAnalysis custom(frequencies);
+  std::vector<std::complex<double> > g(13);
+  custom.frequencyResponse(iir, &g[0]);
+  for (unsigned int k=0; k<13; k++){
+    const std::complex<double> expected =
+        evaluate(iirB, frequencies[k])/evaluate(iirA, frequencies[k]);
+    ASSERT_NEAR(0.0, std::abs(expected - g[k]),
+                1e-9*std::abs(expected) + 1e-15);
+  }
+  ASSERT_THROW(FilterAnalysis(0), std::invalid_argument);
+  ASSERT_THROW(FilterAnalysis(std::vector<double>()),
+               std::invalid_argument);
+  ASSERT_THROW(FilterAnalysis(std::vector<double>(1, NAN)),
+               std::invalid_argument);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief A symmetric FIR filter delays by half its length
+///        at every frequency; the IIR delay matches the
+///        derivative of the unwrapped phase.
+////////////////////////////////////////////////////////////
+TEST_F(FilterAnalysisTest, GroupDelay) {
+  const float taps[] = {0.1f, 0.2f, 0.4f, 0.2f, 0.1f};
+  Filter fir(std::vector<float>(taps, taps + 5), std::vector<float>(1, 1.0f));
+  FilterAnalysis analysis(64);
+  std::vector<double> delay(64);
+  analysis.groupDelay(fir, &delay[0]);
+  for (unsigned int k=0; k<64; k++){
+    ASSERT_NEAR(2.0, delay[k], 1e-9) << k;
+  }
+
+  Filter iir(iirB, iirA);
+  const double step = 1e-5;
+  std::vector<double> frequencies;
+  for (unsigned int k=1; k<20; k++){
+    frequencies.push_back(0.15*k);
+  }
+  FilterAnalysis custom(frequencies);
+  delay.resize(frequencies.size());
+  custom.groupDelay(iir, &delay[0]);
+  for (size_t k=0; k<frequencies.size(); k++){
+    const double w = frequencies[k];
+    const std::complex<double> ratio =
+        (evaluate(iirB, w + step)/evaluate(iirA, w + step))/
+        (evaluate(iirB, w - step)/evaluate(iirA, w - step));
+    ASSERT_NEAR(-std::arg(ratio)/(2*step), delay[k], 1e-4) << w;
+  }
+
+  /// The zeros at -1 put the Nyquist delay on the undefined
+  /// point.
+  FilterAnalysis nyquist(std::vector<double>(1, 3.14159265358979323846));
+  double undefined = 1.0;
+  nyquist.groupDelay(iir, &undefined);
+  ASSERT_EQ(0.0, undefined);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Roots, gain and margin of known designs, and an
+///        unstable filter.
+////////////////////////////////////////////////////////////
+TEST_F(FilterAnalysisTest, ZerosPolesAndStability) {
+  Filter iir(iirB, iirA);
+  const ZeroPoleGain zpk = FilterAnalysis::zeroPoleGain(iir);
+  ASSERT_NEAR(0.01, zpk.gain, 1e-9);
+  ASSERT_EQ(3u, zpk.zeros.size());
+  for (const std::complex<double>& zero : zpk.zeros){
+    ASSERT_NEAR(0.0, std::abs(zero + 1.0), 1e-2);
+  }
+  ASSERT_EQ(3u, zpk.poles.size());
+  for (const std::complex<double>& pole : poles){
+    double closest = 1.0;
+    for (const std::complex<double>& found : zpk.poles){
+      closest = std::min(closest, std::abs(found - pole));
+    }
+    ASSERT_LT(closest, 1e-6);
+  }
+  ASSERT_NEAR(0.1, FilterAnalysis::stabilityMargin(iir), 1e-6);
+
+  const float movingAverage[] = {0.0f, 1.0f/3, 1.0f/3, 1.0f/3};
+  Filter fir(std::vector<float>(movingAverage, movingAverage + 4),
+             std::vector<float>(1, 1.0f));
+  const ZeroPoleGain firZpk = FilterAnalysis::zeroPoleGain(fir);
+  ASSERT_FLOAT_EQ(1.0f/3, firZpk.gain);
+  ASSERT_EQ(2u, firZpk.zeros.size());
+  ASSERT_NEAR(2.0*3.14159265358979/3, std::abs(std::arg(firZpk.zeros[0])),
+              1e-6);
+  ASSERT_TRUE(firZpk.poles.empty());
+  ASSERT_EQ(1.0, FilterAnalysis::stabilityMargin(fir));
+
+  Filter unstable(std::vector<float>(1, 1.0f),
+                  std::vector<float>{1.0f, -1.2f});
+  ASSERT_NEAR(-0.2, FilterAnalysis::stabilityMargin(unstable), 1e-6);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The impulse response leaves the filter alone.
+////////////////////////////////////////////////////////////
+TEST_F(FilterAnalysisTest, ImpulseResponse) {
+  Filter iir(iirB, iirA);
+  iir.filter(5.0f);
+  const FilterState before = iir.SaveState();
+  std::vector<float> response(30);
+  FilterAnalysis::impulseResponse(iir, &response[0], 30);
+  ASSERT_EQ(before.outputs, iir.SaveState().outputs);
+  Filter fresh(iirB, iirA);
+  for (unsigned int n=0; n<30; n++){
+    ASSERT_EQ(fresh.filter(n == 0 ? 1.0f : 0.0f), response[n]);
+  }
+}
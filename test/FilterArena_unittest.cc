@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////
+/// @class FilterArenaTest
+/// @ingroup DSP
+///
+/// @brief Test class for the FilterArena. Filters built on an
+///        arena must pack their storage back to back and
+///        behave exactly like heap backed filters.
+///////////////////////////////////////////////////////////////
+#include "../Filter.hh"
+#include "../FilterArena.hh"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <new>
+#include <vector>
+
+////////////////////////////////////////////////////////////
+/// @brief Filters built one after another take exactly their
+///        storage size, contiguously, and match heap filters.
+////////////////////////////////////////////////////////////
+TEST(FilterArenaTest, Packing) {
+  const unsigned int numFilters = 100;
+  const std::vector<float> b(3, 1.0f/3.0f);
+  const std::vector<float> a(1, 1.0f);
+  std::vector<float> memory(numFilters*Filter::StorageSize(3, 1));
+  FilterArena arena(&memory[0], memory.size());
+  std::vector<Filter> filters;
+  filters.reserve(numFilters);
+  for (unsigned int i=0; i<numFilters; i++){
+    filters.push_back(Filter(b, a, &arena));
+    ASSERT_EQ(&memory[i*Filter::StorageSize(3, 1)],
+              filters[i].GetInputWeights());
+  }
+  ASSERT_EQ(memory.size(), arena.GetUsed());
+  ASSERT_THROW(Filter(b, a, &arena), std::bad_alloc);
+
+  Filter reference(b, a);
+  for (unsigned int n=0; n<20; n++){
+    const float x = std::sin(0.3f*n);
+    const float expected = reference.filter(x);
+    for (unsigned int i=0; i<numFilters; i++){
+      ASSERT_EQ(expected, filters[i].filter(x));
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief A filter that grows takes a new block from its
+///        arena and keeps its history; a rejected update
+///        takes nothing.
+////////////////////////////////////////////////////////////
+TEST(FilterArenaTest, Growth) {
+  FilterArena arena(Filter::StorageSize(2, 1) + Filter::StorageSize(4, 1));
+  Filter filter(std::vector<float>(2, 0.5f), std::vector<float>(1, 1.0f),
+                &arena);
+  filter.filter(1.0f);
+  filter.filter(2.0f);
+  float zero[1] = {0.0f};
+  float sum[5] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+  ASSERT_THROW(filter.SetWeights(4, sum, 1, zero), std::invalid_argument);
+  ASSERT_EQ(Filter::StorageSize(2, 1), arena.GetUsed());
+
+  float one[1] = {1.0f};
+  filter.SetWeights(4, sum, 1, one);
+  ASSERT_EQ(arena.GetCapacity(), arena.GetUsed());
+  ASSERT_EQ(6.0f, filter.filter(3.0f));
+  ASSERT_THROW(filter.SetWeights(5, sum, 1, one), std::bad_alloc);
+  ASSERT_EQ(10.0f, filter.filter(4.0f));
+}
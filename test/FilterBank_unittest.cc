@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////
+/// @class FilterBankTest
+/// @ingroup DSP
+///
+/// @brief Test class for the multi-channel FilterBank. Every
+///        channel of the bank must agree with an independent
+///        Filter built from the same weights, for every
+///        kernel the test machine supports.
+///////////////////////////////////////////////////////////////
+#include "../FilterBank.hh"
+#include "../Filter.hh"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+class FilterBankTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Filter bank test setup function. Builds a second
+  ///        order recursive filter and a distinct test signal
+  ///        per channel.
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     inputWeights[0] = 0.2; inputWeights[1] = 0.4; inputWeights[2] = 0.2;
+     outputWeights[0] = 1.0; outputWeights[1] = -0.6; outputWeights[2] = 0.2;
+     error_tolerance = 0.0001;
+     signal.resize(NUM_FRAMES*NUM_CHANNELS);
+     for (unsigned int f=0; f<NUM_FRAMES; f++){
+       for (unsigned int c=0; c<NUM_CHANNELS; c++){
+         signal[f*NUM_CHANNELS + c] = std::sin(0.1*f*(c+1)) + 0.01*c;
+       }
+     }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Runs the bank with the given kernel and checks
+  ///        each channel against an independent Filter.
+  ////////////////////////////////////////////////////////////
+  void checkKernel(FilterBank::Kernel kernel){
+     if (!FilterBank::IsKernelSupported(kernel)){
+       return;
+     }
+     FilterBank bank(NUM_CHANNELS, 3, inputWeights, 3, outputWeights);
+     ASSERT_TRUE(bank.SetKernel(kernel));
+     std::vector<Filter> reference(NUM_CHANNELS,
+                                   Filter(3, inputWeights, 3, outputWeights));
+     std::vector<float> output(NUM_FRAMES*NUM_CHANNELS);
+     /// One frame at a time for the first few frames, then a block.
+     for (unsigned int f=0; f<5; f++){
+       bank.filterFrame(&signal[f*NUM_CHANNELS], &output[f*NUM_CHANNELS]);
+     }
+     bank.filterFrames(&signal[5*NUM_CHANNELS], &output[5*NUM_CHANNELS],
+                       NUM_FRAMES - 5);
+     for (unsigned int f=0; f<NUM_FRAMES; f++){
+       for (unsigned int c=0; c<NUM_CHANNELS; c++){
+         float expected = reference[c].filter(signal[f*NUM_CHANNELS + c]);
+         ASSERT_NEAR(expected, output[f*NUM_CHANNELS + c], error_tolerance);
+       }
+     }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Channel count, deliberately not a multiple of the
+  ///        vector width.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int NUM_CHANNELS = 13;
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of frames in the test signal.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int NUM_FRAMES = 40;
+  ////////////////////////////////////////////////////////////
+  /// @brief Interleaved test signal.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> signal;
+  ////////////////////////////////////////////////////////////
+  /// @brief Input and output weights of the test filter.
+  ////////////////////////////////////////////////////////////
+  float inputWeights[3];
+  float outputWeights[3];
+  ////////////////////////////////////////////////////////////
+  /// @brief Allowed difference from the reference Filter.
+  ////////////////////////////////////////////////////////////
+  float error_tolerance;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief The scalar fallback kernel.
+////////////////////////////////////////////////////////////
+TEST_F(FilterBankTest, ScalarKernel) {
+  checkKernel(FilterBank::SCALAR_KERNEL);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The SSE kernel, when supported.
+////////////////////////////////////////////////////////////
+TEST_F(FilterBankTest, SseKernel) {
+  checkKernel(FilterBank::SSE_KERNEL);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The AVX2 kernel, when supported.
+////////////////////////////////////////////////////////////
+TEST_F(FilterBankTest, Avx2Kernel) {
+  checkKernel(FilterBank::AVX2_KERNEL);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief reset() must return every channel to zero state.
+////////////////////////////////////////////////////////////
+TEST_F(FilterBankTest, Reset) {
+  FilterBank bank(NUM_CHANNELS, 3, inputWeights, 3, outputWeights);
+  std::vector<float> first(NUM_CHANNELS), again(NUM_CHANNELS);
+  bank.filterFrame(&signal[0], &first[0]);
+  bank.filterFrames(&signal[0], &again[0], 1);
+  bank.reset();
+  bank.filterFrame(&signal[0], &again[0]);
+  for (unsigned int c=0; c<NUM_CHANNELS; c++){
+    ASSERT_EQ(first[c], again[c]);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Degenerate sizes and weights are rejected.
+////////////////////////////////////////////////////////////
+TEST_F(FilterBankTest, InvalidArguments) {
+  ASSERT_THROW(FilterBank(0, 3, inputWeights, 3, outputWeights),
+               std::invalid_argument);
+  ASSERT_THROW(FilterBank(4, 0, inputWeights, 3, outputWeights),
+               std::invalid_argument);
+  /// A tiny a[0] overflows the normalized weights.
+  float tinyLeading[3] = {1e-40f, outputWeights[1], outputWeights[2]};
+  ASSERT_THROW(FilterBank(4, 3, inputWeights, 3, tinyLeading),
+               std::invalid_argument);
+}
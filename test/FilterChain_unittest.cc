@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////
+/// @class FilterChainTest
+/// @ingroup DSP
+///
+/// @brief Test class for the runtime and compile time filter
+///        chains. A chain must produce exactly what its stages
+///        produce when run one after another, and a collapsed
+///        chain the same to within rounding.
+///////////////////////////////////////////////////////////////
+#include "../ButterworthLowPass3rdOrder.hh"
+#include "../FilterChain.hh"
+#include "../MovingAvg3rdOrder.hh"
+#include "gtest/gtest.h"
+#include "TestSignals.hh"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+class FilterChainTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Chain test setup function. The signal is longer
+  ///        than a tile and not a multiple of one.
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     signal = twoToneSignal(SIGNAL_LENGTH);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Runs the signal through the stages one after
+  ///        another, sample by sample.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> reference(void){
+     ButterworthLowPass3rdOrder lowPass;
+     MovingAvg3rdOrder average;
+     float b[2] = {0.5f, 0.5f};
+     float a[2] = {1.0f, -0.25f};
+     Filter shelf(2, b, 2, a);
+     std::vector<float> expected(SIGNAL_LENGTH);
+     for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+       expected[n] = shelf.filter(average.filter(lowPass.filter(signal[n])));
+     }
+     return expected;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the test signal.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int SIGNAL_LENGTH = 301;
+  ////////////////////////////////////////////////////////////
+  /// @brief Test signal, see twoToneSignal.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> signal;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief The runtime chain matches its stages, per sample
+///        and in blocks of several sizes, in place, and has
+///        no weights of its own.
+////////////////////////////////////////////////////////////
+TEST_F(FilterChainTest, Runtime) {
+  const std::vector<float> expected = reference();
+  const unsigned int blockSizes[3] = {1, 64, 301};
+  for (unsigned int k=0; k<3; k++){
+    ButterworthLowPass3rdOrder lowPass;
+    MovingAvg3rdOrder average;
+    float b[2] = {0.5f, 0.5f};
+    float a[2] = {1.0f, -0.25f};
+    Filter shelf(2, b, 2, a);
+    FilterChain chain;
+    chain.addStage(lowPass);
+    chain.addStage(average);
+    chain.addStage(shelf);
+    ASSERT_EQ(3u, chain.GetNumStages());
+    std::vector<float> output(signal);
+    for (unsigned int n=0; n<SIGNAL_LENGTH; n+=blockSizes[k]){
+      const unsigned int count = std::min(blockSizes[k], SIGNAL_LENGTH - n);
+      chain.filterBlock(&output[n], &output[n], count);
+    }
+    for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+      ASSERT_EQ(expected[n], output[n]);
+    }
+  }
+
+  ButterworthLowPass3rdOrder lowPass;
+  MovingAvg3rdOrder average;
+  float b[2] = {0.5f, 0.5f};
+  float a[2] = {1.0f, -0.25f};
+  Filter shelf(2, b, 2, a);
+  FilterChain chain;
+  chain.addStage(lowPass);
+  chain.addStage(average);
+  chain.addStage(shelf);
+  Filter& asFilter = chain;
+  for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+    ASSERT_EQ(expected[n], asFilter.filter(signal[n]));
+  }
+
+  /// The chain has no weights or state of its own to set or
+  /// save through the base class.
+  ASSERT_THROW(asFilter.SetWeights(2, b, 2, a), std::invalid_argument);
+  ASSERT_EQ(0u, asFilter.GetNumInWeights());
+  ASSERT_TRUE(asFilter.SaveState().inputs.empty());
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The compile time chain matches its stages.
+////////////////////////////////////////////////////////////
+TEST_F(FilterChainTest, Static) {
+  const std::vector<float> expected = reference();
+  float b[2] = {0.5f, 0.5f};
+  float a[2] = {1.0f, -0.25f};
+  StaticFilterChain<StaticButterworthLowPass3rdOrder,
+                    StaticMovingAvg3rdOrder,
+                    StaticFilter<2, 2> >
+      chain(StaticButterworthLowPass3rdOrder(), StaticMovingAvg3rdOrder(),
+            StaticFilter<2, 2>(b, a));
+  std::vector<float> output(SIGNAL_LENGTH);
+  chain.filterBlock(&signal[0], &output[0], SIGNAL_LENGTH);
+  for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+    ASSERT_EQ(expected[n], output[n]);
+  }
+  chain.reset();
+  for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+    ASSERT_EQ(expected[n], chain.filter(signal[n]));
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Collapsed chains match the chain closely, and a
+///        stage with no known transfer function is refused.
+////////////////////////////////////////////////////////////
+TEST_F(FilterChainTest, Collapse) {
+  const std::vector<float> expected = reference();
+  ButterworthLowPass3rdOrder lowPass;
+  MovingAvg3rdOrder average;
+  float b[2] = {0.5f, 0.5f};
+  float a[2] = {1.0f, -0.25f};
+  Filter shelf(2, b, 2, a);
+  FilterChain chain;
+  chain.addStage(lowPass);
+  chain.addStage(average);
+  chain.addStage(shelf);
+  Filter single = chain.collapse();
+  ASSERT_EQ(6u, single.GetNumInWeights());
+  ASSERT_EQ(4u, single.GetNumOutWeights());
+  for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+    ASSERT_NEAR(expected[n], single.filter(signal[n]), 1e-5);
+  }
+
+  StaticFilterChain<StaticButterworthLowPass3rdOrder,
+                    StaticMovingAvg3rdOrder,
+                    StaticFilter<2, 2> >
+      staticChain(StaticButterworthLowPass3rdOrder(),
+                  StaticMovingAvg3rdOrder(),
+                  StaticFilter<2, 2>(b, a));
+  StaticFilter<6, 4> staticSingle = staticChain.collapse();
+  for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+    ASSERT_NEAR(expected[n], staticSingle.filter(signal[n]), 1e-5);
+  }
+
+  FilterChain inner;
+  FilterChain outer;
+  outer.addStage(inner);
+  ASSERT_THROW(outer.collapse(), std::logic_error);
+}
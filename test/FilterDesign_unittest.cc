@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////
+/// @class FilterDesignTest
+/// @ingroup DSP
+///
+/// @brief Test class for the Butterworth and Chebyshev filter
+///        designer. Designs are checked against reference
+///        weights from scipy.signal.butter and against the
+///        defining properties of each prototype, measured on
+///        the frequency response of the designed sections.
+///////////////////////////////////////////////////////////////
+#include "../FilterDesign.hh"
+#include "../Filter.hh"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <stdexcept>
+
+class FilterDesignTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Filter design test setup function
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     sampleRate = 500.0;
+     error_tolerance = 1e-4;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Builds a specification with the common fields.
+  ////////////////////////////////////////////////////////////
+  FilterSpec makeSpec(FilterPrototype prototype, FilterBand band,
+                      unsigned int order, double cutoff,
+                      double upperCutoff = 0.0, double rippleDb = 0.0){
+     FilterSpec spec = {prototype, band, order, sampleRate,
+                        cutoff, upperCutoff, rippleDb};
+     return spec;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Magnitude of a section cascade at frequency f Hz.
+  ////////////////////////////////////////////////////////////
+  double magnitude(const BiquadSection* sections, unsigned int numSections,
+                   double f){
+     const std::complex<double> z1 = std::polar(1.0, -2.0*M_PI*f/sampleRate);
+     const std::complex<double> z2 = z1*z1;
+     std::complex<double> response(1.0, 0.0);
+     for (unsigned int s=0; s<numSections; s++){
+       const BiquadSection& w = sections[s];
+       response *= (double(w.b0) + double(w.b1)*z1 + double(w.b2)*z2)/
+                   (1.0 + double(w.a1)*z1 + double(w.a2)*z2);
+     }
+     return std::abs(response);
+  }
+  double magnitude(const FilterDesign& design, double f){
+     std::vector<BiquadSection> sections = design.GetSections();
+     return magnitude(&sections[0], sections.size(), f);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Sample rate of the designs, matching the 500 Hz
+  ///        velocity captures.
+  ////////////////////////////////////////////////////////////
+  double sampleRate;
+  ////////////////////////////////////////////////////////////
+  /// @brief Allowed difference from the reference values.
+  ////////////////////////////////////////////////////////////
+  double error_tolerance;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief The ChupacabraAnalysis design, butter(2, 1 Hz) at
+///        500 Hz, matches scipy's weights.
+////////////////////////////////////////////////////////////
+TEST_F(FilterDesignTest, ButterworthMatchesScipy) {
+  FilterDesign design(makeSpec(BUTTERWORTH, LOW_PASS, 2, 1.0));
+  std::vector<float> b, a;
+  design.GetWeights(b, a);
+  ASSERT_EQ(3u, b.size());
+  ASSERT_EQ(3u, a.size());
+  ASSERT_NEAR(3.91302e-05, b[0], 1e-9);
+  ASSERT_NEAR(7.82604e-05, b[1], 1e-9);
+  ASSERT_NEAR(3.91302e-05, b[2], 1e-9);
+  ASSERT_NEAR(1.0, a[0], 1e-7);
+  ASSERT_NEAR(-1.98222893, a[1], 1e-6);
+  ASSERT_NEAR(0.98238545, a[2], 1e-6);
+  /// The weights drive a Filter to unity gain at DC, less the
+  /// error of rounding a to float for this low a cutoff.
+  Filter lowPass(b.size(), &b[0], a.size(), &a[0]);
+  float output = 0.0;
+  for (unsigned int n=0; n<5000; n++){
+    output = lowPass.filter(1.0);
+  }
+  ASSERT_NEAR(1.0, output, 1e-3);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Butterworth designs are -3 dB at every band edge
+///        and flat in the pass band.
+////////////////////////////////////////////////////////////
+TEST_F(FilterDesignTest, ButterworthBandEdges) {
+  const double halfPower = std::sqrt(0.5);
+  for (unsigned int order=1; order<=8; order++){
+    FilterDesign lowPass(makeSpec(BUTTERWORTH, LOW_PASS, order, 20.0));
+    ASSERT_NEAR(1.0, magnitude(lowPass, 0.0), error_tolerance);
+    ASSERT_NEAR(halfPower, magnitude(lowPass, 20.0), error_tolerance);
+    ASSERT_NEAR(0.0, magnitude(lowPass, 0.5*sampleRate), error_tolerance);
+    FilterDesign highPass(makeSpec(BUTTERWORTH, HIGH_PASS, order, 20.0));
+    ASSERT_NEAR(0.0, magnitude(highPass, 0.0), error_tolerance);
+    ASSERT_NEAR(halfPower, magnitude(highPass, 20.0), error_tolerance);
+    ASSERT_NEAR(1.0, magnitude(highPass, 0.5*sampleRate), error_tolerance);
+    FilterDesign bandPass(makeSpec(BUTTERWORTH, BAND_PASS, order, 20.0, 60.0));
+    ASSERT_EQ(2*order, bandPass.GetPoles().size());
+    ASSERT_NEAR(halfPower, magnitude(bandPass, 20.0), error_tolerance);
+    ASSERT_NEAR(halfPower, magnitude(bandPass, 60.0), error_tolerance);
+    ASSERT_NEAR(0.0, magnitude(bandPass, 0.0), error_tolerance);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Chebyshev type I designs ripple by rippleDb in the
+///        pass band and are down by the ripple at the edge.
+////////////////////////////////////////////////////////////
+TEST_F(FilterDesignTest, ChebyshevRipple) {
+  const double rippleDb = 1.0;
+  const double rippleGain = std::pow(10.0, -rippleDb/20.0);
+  FilterDesign odd(makeSpec(CHEBYSHEV_1, LOW_PASS, 5, 30.0, 0.0, rippleDb));
+  ASSERT_NEAR(1.0, magnitude(odd, 0.0), error_tolerance);
+  ASSERT_NEAR(rippleGain, magnitude(odd, 30.0), error_tolerance);
+  FilterDesign even(makeSpec(CHEBYSHEV_1, LOW_PASS, 4, 30.0, 0.0, rippleDb));
+  ASSERT_NEAR(rippleGain, magnitude(even, 0.0), error_tolerance);
+  ASSERT_NEAR(rippleGain, magnitude(even, 30.0), error_tolerance);
+  for (double f=0.0; f<30.0; f+=0.5){
+    const double gain = magnitude(even, f);
+    ASSERT_LE(gain, 1.0 + error_tolerance);
+    ASSERT_GE(gain, rippleGain - error_tolerance);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The compile time design matches the runtime one.
+////////////////////////////////////////////////////////////
+TEST_F(FilterDesignTest, ConstexprButterworth) {
+  static constexpr ButterworthSections<5> lowPass =
+      designButterworthSections<5>(LOW_PASS, 12.5, 500.0);
+  static constexpr ButterworthSections<4> highPass =
+      designButterworthSections<4>(HIGH_PASS, 40.0, 500.0);
+  FilterDesign lowReference(makeSpec(BUTTERWORTH, LOW_PASS, 5, 12.5));
+  FilterDesign highReference(makeSpec(BUTTERWORTH, HIGH_PASS, 4, 40.0));
+  for (double f=0.0; f<=250.0; f+=12.5){
+    ASSERT_NEAR(magnitude(lowReference, f),
+                magnitude(lowPass.sections, 3, f), error_tolerance);
+    ASSERT_NEAR(magnitude(highReference, f),
+                magnitude(highPass.sections, 2, f), error_tolerance);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Invalid specifications are rejected.
+////////////////////////////////////////////////////////////
+TEST_F(FilterDesignTest, InvalidSpec) {
+  ASSERT_THROW(FilterDesign(makeSpec(BUTTERWORTH, LOW_PASS, 0, 10.0)),
+               std::invalid_argument);
+  ASSERT_THROW(FilterDesign(makeSpec(BUTTERWORTH, LOW_PASS, 2, 250.0)),
+               std::invalid_argument);
+  ASSERT_THROW(FilterDesign(makeSpec(BUTTERWORTH, BAND_PASS, 2, 60.0, 20.0)),
+               std::invalid_argument);
+  ASSERT_THROW(FilterDesign(makeSpec(CHEBYSHEV_1, LOW_PASS, 2, 10.0)),
+               std::invalid_argument);
+}
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////
+/// @class FilterSchedulerTest
+/// @ingroup DSP
+///
+/// @brief Test class for the multi-threaded FilterScheduler.
+///        Every scheduled filter must produce the same output
+///        as the same filter run serially, tick after tick.
+///////////////////////////////////////////////////////////////
+#include "../FilterScheduler.hh"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+class FilterSchedulerTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Filter scheduler test setup function. Builds a
+  ///        different recursive filter per stream.
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     for (unsigned int i=0; i<NUM_FILTERS; i++){
+       float b[3] = {0.2f, 0.4f, 0.2f + 0.0001f*i};
+       float a[3] = {1.0f, -0.6f, 0.2f};
+       reference.push_back(Filter(3, b, 3, a));
+     }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Fills a tick of stream major input.
+  ////////////////////////////////////////////////////////////
+  void makeTick(unsigned int tick, std::vector<float>& input){
+     input.resize(NUM_FILTERS*SAMPLES_PER_TICK);
+     for (unsigned int i=0; i<NUM_FILTERS; i++){
+       for (unsigned int n=0; n<SAMPLES_PER_TICK; n++){
+         input[i*SAMPLES_PER_TICK + n] =
+             std::sin(0.1f*(tick*SAMPLES_PER_TICK + n) + 0.01f*i);
+       }
+     }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Runs several ticks through a scheduler with the
+  ///        given worker count and checks every output.
+  ////////////////////////////////////////////////////////////
+  void checkWorkers(unsigned int numWorkers){
+     FilterScheduler scheduler(numWorkers);
+     ASSERT_EQ(numWorkers, scheduler.GetNumWorkers());
+     std::vector<Filter> serial(reference);
+     for (unsigned int i=0; i<NUM_FILTERS; i++){
+       ASSERT_EQ(i, scheduler.addFilter(
+           std::unique_ptr<Filter>(new Filter(reference[i]))));
+     }
+     std::vector<float> input, output(NUM_FILTERS*SAMPLES_PER_TICK);
+     std::vector<float> expected(SAMPLES_PER_TICK);
+     for (unsigned int tick=0; tick<NUM_TICKS; tick++){
+       makeTick(tick, input);
+       scheduler.process(&input[0], &output[0], SAMPLES_PER_TICK);
+       for (unsigned int i=0; i<NUM_FILTERS; i++){
+         serial[i].filterBlock(&input[i*SAMPLES_PER_TICK], &expected[0],
+                               SAMPLES_PER_TICK);
+         for (unsigned int n=0; n<SAMPLES_PER_TICK; n++){
+           ASSERT_EQ(expected[n], output[i*SAMPLES_PER_TICK + n]);
+         }
+       }
+     }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Number of streams. Not a multiple of the chunk
+  ///        size, so the last chunk is partial.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int NUM_FILTERS = 1003;
+  ////////////////////////////////////////////////////////////
+  /// @brief Samples per stream per tick.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int SAMPLES_PER_TICK = 32;
+  ////////////////////////////////////////////////////////////
+  /// @brief Ticks per check.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int NUM_TICKS = 20;
+  ////////////////////////////////////////////////////////////
+  /// @brief One serially run copy of each stream's filter.
+  ////////////////////////////////////////////////////////////
+  std::vector<Filter> reference;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief One worker, and more workers than cores.
+////////////////////////////////////////////////////////////
+TEST_F(FilterSchedulerTest, MatchesSerial) {
+  checkWorkers(1);
+  checkWorkers(4);
+  checkWorkers(13);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filters are assigned to workers in contiguous runs,
+///        start/wait splits a tick around caller work, and
+///        filters added between ticks join the next tick.
+////////////////////////////////////////////////////////////
+TEST_F(FilterSchedulerTest, StartWaitAndGrowth) {
+  FilterScheduler scheduler(4);
+  std::vector<float> input(64, 1.0f), output(64, 0.0f);
+  scheduler.process(&input[0], &output[0], 1);
+
+  for (unsigned int i=0; i<64; i++){
+    float b[1] = {2.0f};
+    float a[1] = {1.0f};
+    scheduler.addFilter(std::unique_ptr<Filter>(new Filter(1, b, 1, a)));
+  }
+  ASSERT_EQ(0u, scheduler.GetWorkerOf(0));
+  ASSERT_EQ(3u, scheduler.GetWorkerOf(63));
+  scheduler.start(&input[0], &output[0], 1);
+  scheduler.wait();
+  for (unsigned int i=0; i<64; i++){
+    ASSERT_EQ(2.0f, output[i]);
+  }
+  ASSERT_THROW(scheduler.addFilter(std::unique_ptr<Filter>()),
+               std::invalid_argument);
+}
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////
+/// @class FilterStatsTest
+/// @ingroup DSP
+///
+/// @brief Test class for the filter run time statistics. The
+///        counts must be exact, and a snapshot taken while
+///        the filter runs must be consistent.
+///////////////////////////////////////////////////////////////
+#include "../Filter.hh"
+#include "../FilterStats.hh"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////
+/// @brief Total of a snapshot's latency histogram.
+////////////////////////////////////////////////////////////
+static uint64_t timedUpdates(const FilterStatsSnapshot& snapshot){
+  uint64_t total = 0;
+  for (unsigned int i=0; i<FILTER_LATENCY_BUCKETS; i++){
+    total += snapshot.latency[i];
+  }
+  return total;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Per sample and block updates, classified outputs
+///        and the sampled timing of single samples.
+////////////////////////////////////////////////////////////
+TEST(FilterStatsTest, Counts) {
+  FilterStats stats;
+  stats.SetSaturationLevel(1.0f);
+  const float outputs[] = {0.5f, 1.0f, -2.0f, NAN,
+                           std::numeric_limits<float>::infinity()};
+  for (unsigned int n=0; n<2*FilterStats::TIMING_PERIOD; n++){
+    stats.endSample(outputs[n % 5], stats.beginSample());
+  }
+  FilterStatsSnapshot snapshot = stats.snapshot();
+  ASSERT_EQ(2u*FilterStats::TIMING_PERIOD, snapshot.samples);
+  ASSERT_EQ(26u + 26u, snapshot.saturated);
+  ASSERT_EQ(25u + 25u, snapshot.nonFinite);
+  ASSERT_EQ(2u, timedUpdates(snapshot));
+
+  unsigned int nonFinite = 0, saturated = 0;
+  const uint64_t start = stats.beginBlock();
+  for (float y : outputs){
+    stats.classify(y, nonFinite, saturated);
+  }
+  stats.endBlock(5, nonFinite, saturated, start);
+  snapshot = stats.snapshot();
+  ASSERT_EQ(2u*FilterStats::TIMING_PERIOD + 5, snapshot.samples);
+  ASSERT_EQ(54u, snapshot.saturated);
+  ASSERT_EQ(52u, snapshot.nonFinite);
+
+  const FilterStats copy(stats);
+  ASSERT_EQ(0u, copy.snapshot().samples);
+  ASSERT_EQ(1.0f, copy.GetSaturationLevel());
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Every update saturates, so any consistent
+///        snapshot has as many saturated outputs as samples.
+////////////////////////////////////////////////////////////
+TEST(FilterStatsTest, ConcurrentSnapshots) {
+  FilterStats stats;
+  stats.SetSaturationLevel(0.0f);
+  std::atomic<bool> done(false);
+  std::thread reader([&](){
+    uint64_t previous = 0;
+    while (!done.load()){
+      const FilterStatsSnapshot snapshot = stats.snapshot();
+      ASSERT_EQ(snapshot.samples, snapshot.saturated);
+      ASSERT_GE(snapshot.samples, previous);
+      previous = snapshot.samples;
+    }
+  });
+  for (unsigned int n=0; n<200000; n++){
+    stats.endSample(1.0f, stats.beginSample());
+  }
+  done.store(true);
+  reader.join();
+  ASSERT_EQ(200000u, stats.snapshot().samples);
+}
+
+#ifdef FILTER_INSTRUMENTATION
+////////////////////////////////////////////////////////////
+/// @brief Filter feeds its statistics from both routines.
+////////////////////////////////////////////////////////////
+TEST(FilterStatsTest, FilterInstrumentation) {
+  Filter filter(std::vector<float>(1, 2.0f), std::vector<float>(1, 1.0f));
+  filter.GetStats().SetSaturationLevel(1.0f);
+  filter.filter(0.25f);
+  filter.filter(0.5f);
+  const float input[] = {0.1f, 0.6f, NAN};
+  float output[3];
+  filter.filterBlock(input, output, 3);
+  const FilterStatsSnapshot snapshot = filter.GetStats().snapshot();
+  ASSERT_EQ(5u, snapshot.samples);
+  ASSERT_EQ(2u, snapshot.saturated);
+  ASSERT_EQ(1u, snapshot.nonFinite);
+  ASSERT_EQ(1u, timedUpdates(snapshot));
+}
+#endif
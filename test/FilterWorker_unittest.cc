@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////
+/// @class FilterWorkerTest
+/// @ingroup DSP
+///
+/// @brief Test class for the threaded FilterWorker. Outputs
+///        must match the filter run inline, and drops must be
+///        counted.
+///////////////////////////////////////////////////////////////
+#include "../FilterWorker.hh"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+class FilterWorkerTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Filter worker test setup function.
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     inputWeights[0] = 0.2; inputWeights[1] = 0.4; inputWeights[2] = 0.2;
+     outputWeights[0] = 1.0; outputWeights[1] = -0.6; outputWeights[2] = 0.2;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Second order recursive test filter weights.
+  ////////////////////////////////////////////////////////////
+  float inputWeights[3];
+  float outputWeights[3];
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Every sample submitted comes back filtered, in
+///        order, identical to the inline filter.
+////////////////////////////////////////////////////////////
+TEST_F(FilterWorkerTest, MatchesInline) {
+  Filter threaded(3, inputWeights, 3, outputWeights);
+  Filter inline_(3, inputWeights, 3, outputWeights);
+  const unsigned int count = 50000;
+  FilterWorker worker(threaded, 64, 64);
+  std::thread producer([&worker, count]{
+    for (unsigned int i=0; i<count; ){
+      if (worker.submit(std::sin(0.01f*i))){
+        i++;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+  float output;
+  for (unsigned int i=0; i<count; ){
+    if (worker.receive(output)){
+      ASSERT_EQ(inline_.filter(std::sin(0.01f*i)), output);
+      i++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  worker.stop();
+  ASSERT_EQ(count, worker.GetSamplesFiltered());
+}
+
+////////////////////////////////////////////////////////////
+/// @brief With nobody receiving, the output queue fills, the
+///        worker stalls, and further input overruns. Every
+///        sample is either counted as dropped or delivered.
+////////////////////////////////////////////////////////////
+TEST_F(FilterWorkerTest, Backpressure) {
+  Filter tFilter(3, inputWeights, 3, outputWeights);
+  FilterWorker worker(tFilter, 8, 8);
+  unsigned int accepted = 0;
+  for (unsigned int i=0; i<1000; i++){
+    accepted += worker.submit(1.0f) ? 1 : 0;
+    if (i % 50 == 0){
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  ASSERT_GT(worker.GetInputOverruns(), 0u);
+  ASSERT_GT(worker.GetOutputStalls(), 0u);
+  ASSERT_EQ(1000u, accepted + worker.GetInputOverruns());
+
+  /// Drain while the worker is still running, so it delivers
+  /// everything it accepted.
+  std::vector<float> outputs(1000);
+  unsigned int received = 0;
+  while (received < accepted){
+    received += worker.receiveBlock(&outputs[received], 1000 - received);
+    std::this_thread::yield();
+  }
+  ASSERT_EQ(accepted, received);
+  worker.stop();
+  ASSERT_EQ(accepted, worker.GetSamplesFiltered());
+  ASSERT_EQ(0u, worker.GetOutputDrops());
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Stopping with a full output queue and nobody
+///        receiving: every accepted sample is filtered, and
+///        is either received afterwards or counted as an
+///        output drop.
+////////////////////////////////////////////////////////////
+TEST_F(FilterWorkerTest, StopCountsDroppedOutputs) {
+  Filter tFilter(3, inputWeights, 3, outputWeights);
+  FilterWorker worker(tFilter, 64, 8);
+  std::vector<float> input(64, 1.0f);
+  const unsigned int accepted = worker.submitBlock(&input[0], 64);
+  worker.stop();
+  ASSERT_EQ(accepted, worker.GetSamplesFiltered());
+  ASSERT_GT(worker.GetOutputDrops(), 0u);
+  std::vector<float> outputs(64);
+  const unsigned int received = worker.receiveBlock(&outputs[0], 64);
+  ASSERT_EQ(accepted, received + worker.GetOutputDrops());
+}
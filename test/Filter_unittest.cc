@@ -25,6 +25,26 @@
 #include "../Filter.hh"
 #include "gtest/gtest.h"
 
+#include <stdexcept>
+#include <vector>
+
+////////////////////////////////////////////////////////////
+/// @brief A derived filter that writes its own weights, the
+///        way subclasses filled the old fixed size arrays.
+////////////////////////////////////////////////////////////
+class ThreePointAverage : public Filter {
+ public:
+  ThreePointAverage(void) : Filter() {
+    resizeWeights(3, 1);
+    for (unsigned int i=0; i<3; i++){
+      _inputWeights[i] = 1.0f/3.0f;
+    }
+  }
+  void grow(unsigned int numInWeights, unsigned int numOutWeights){
+    resizeWeights(numInWeights, numOutWeights);
+  }
+};
+
 class FilterTest : public testing::Test {
  protected:
 
@@ -145,3 +165,229 @@ TEST_F(FilterTest, FilterFunctionTest) {
 	ASSERT_NEAR(expected_filtered[i], filterOutput, error_tolerance);
   }
 }
+
+////////////////////////////////////////////////////////////
+/// @brief Unit test for the Filter filterBlock function. The
+///        block outputs must be bit-identical to calling
+///        filter() once per sample, including across blocks.
+////////////////////////////////////////////////////////////
+TEST_F(FilterTest, FilterBlockTest) {
+  Filter sampleFilter = Filter(numInputWeights, inputWeights,
+		                 numOutputWeights, outputWeights);
+  Filter blockFilter = Filter(numInputWeights, inputWeights,
+		                 numOutputWeights, outputWeights);
+  float blockOutput[TEST_SIGNAL_LENGTH];
+  blockFilter.filterBlock(sample_signal, blockOutput, 4);
+  blockFilter.filterBlock(sample_signal + 4, blockOutput + 4,
+		                  TEST_SIGNAL_LENGTH - 4);
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+	float filterOutput = sampleFilter.filter(sample_signal[i]);
+	ASSERT_EQ(filterOutput, blockOutput[i]);
+	ASSERT_NEAR(expected_filtered[i], blockOutput[i], error_tolerance);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Unit test for the buffer accessors. Both the live
+///        buffers and the snapshots are ordered newest first.
+////////////////////////////////////////////////////////////
+TEST_F(FilterTest, BufferSnapshotTest) {
+  Filter tFilter = Filter(numInputWeights, inputWeights,
+		                 numOutputWeights, outputWeights);
+  float lastOutput = 0.0;
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+	lastOutput = tFilter.filter(sample_signal[i]);
+  }
+  float inputSnapshot[3];
+  float outputSnapshot[1];
+  tFilter.GetInputBufferSnapshot(inputSnapshot);
+  tFilter.GetOutputBufferSnapshot(outputSnapshot);
+  for (unsigned int i=0; i<numInputWeights; i++){
+	ASSERT_FLOAT_EQ(sample_signal[TEST_SIGNAL_LENGTH-1-i], inputSnapshot[i]);
+	ASSERT_FLOAT_EQ(inputSnapshot[i], tFilter.GetCurrentInputBuffer()[i]);
+  }
+  ASSERT_FLOAT_EQ(lastOutput, outputSnapshot[0]);
+  ASSERT_FLOAT_EQ(lastOutput, tFilter.GetCurrentOutputBuffer()[0]);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Weights are divided by a[0] once, so scaling every
+///        weight leaves the output unchanged, and invalid
+///        weights are rejected.
+////////////////////////////////////////////////////////////
+TEST_F(FilterTest, NormalizedWeights) {
+  float scaledIn[3], scaledOut[1];
+  for (unsigned int i=0; i<numInputWeights; i++){
+    scaledIn[i] = 4.0f*inputWeights[i];
+  }
+  scaledOut[0] = 4.0f;
+  Filter tFilter = Filter(numInputWeights, scaledIn, 1, scaledOut);
+  ASSERT_FLOAT_EQ(1.0f, tFilter.GetOutputWeights()[0]);
+  for (unsigned int i=0; i<numInputWeights; i++){
+    ASSERT_FLOAT_EQ(inputWeights[i], tFilter.GetInputWeights()[i]);
+  }
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+    ASSERT_NEAR(expected_filtered[i], tFilter.filter(sample_signal[i]),
+                error_tolerance);
+  }
+
+  float zero[1] = {0.0f};
+  ASSERT_THROW(Filter(numInputWeights, inputWeights, 1, zero),
+               std::invalid_argument);
+  ASSERT_THROW(Filter(0, inputWeights, 1, outputWeights),
+               std::invalid_argument);
+  ASSERT_THROW(Filter(-1, inputWeights, 1, outputWeights),
+               std::invalid_argument);
+  ASSERT_THROW(Filter(std::vector<float>(), std::vector<float>(1, 1.0f)),
+               std::invalid_argument);
+  float tiny[1] = {1e-40f};
+  float huge[1] = {1e38f};
+  ASSERT_THROW(Filter(1, huge, 1, tiny), std::invalid_argument);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief SetWeights replaces the weights of a running
+///        filter, keeps its history, and leaves the filter
+///        untouched when the new weights are rejected.
+////////////////////////////////////////////////////////////
+TEST_F(FilterTest, SetWeights) {
+  Filter tFilter = Filter(numInputWeights, inputWeights,
+		                 numOutputWeights, outputWeights);
+  for (unsigned int i=0; i<5; i++){
+    tFilter.filter(sample_signal[i]);
+  }
+  float zero[1] = {0.0f};
+  ASSERT_THROW(tFilter.SetWeights(numInputWeights, inputWeights, 1, zero),
+               std::invalid_argument);
+  ASSERT_FLOAT_EQ(inputWeights[0], tFilter.GetInputWeights()[0]);
+  ASSERT_NEAR(expected_filtered[5], tFilter.filter(sample_signal[5]),
+              error_tolerance);
+
+  /// Two point sum, entered with a[0] = 2 so the result is the
+  /// two point average of the retained history.
+  float sumWeights[2] = {1.0f, 1.0f};
+  float two[1] = {2.0f};
+  tFilter.SetWeights(2, sumWeights, 1, two);
+  ASSERT_FLOAT_EQ(0.5f, tFilter.GetInputWeights()[0]);
+  ASSERT_FLOAT_EQ(0.0f, tFilter.GetInputWeights()[2]);
+  ASSERT_NEAR(0.5f*(sample_signal[6] + sample_signal[5]),
+              tFilter.filter(sample_signal[6]), 1e-6);
+  ASSERT_NEAR(0.5f*(sample_signal[7] + sample_signal[6]),
+              tFilter.filter(sample_signal[7]), 1e-6);
+
+  /// Growing back to three taps picks up the last two inputs.
+  tFilter.SetWeights(numInputWeights, inputWeights,
+                     numOutputWeights, outputWeights);
+  for (unsigned int i=8; i<TEST_SIGNAL_LENGTH; i++){
+    ASSERT_NEAR(expected_filtered[i], tFilter.filter(sample_signal[i]),
+                error_tolerance);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief A derived filter sizes the weights with
+///        resizeWeights before writing them; resizing again
+///        keeps the weights and the history.
+////////////////////////////////////////////////////////////
+TEST_F(FilterTest, DerivedResizeWeights) {
+  ThreePointAverage average;
+  ASSERT_EQ(3u, average.GetNumInWeights());
+  ASSERT_EQ(1u, average.GetNumOutWeights());
+  ASSERT_FLOAT_EQ(1.0f, average.GetOutputWeights()[0]);
+  Filter direct(std::vector<float>(3, 1.0f/3.0f),
+                std::vector<float>(1, 1.0f));
+  for (unsigned int i=0; i<5; i++){
+    ASSERT_EQ(direct.filter(sample_signal[i]),
+              average.filter(sample_signal[i]));
+  }
+  average.grow(5, 2);
+  ASSERT_EQ(5u, average.GetNumInWeights());
+  ASSERT_FLOAT_EQ(1.0f/3.0f, average.GetInputWeights()[2]);
+  ASSERT_FLOAT_EQ(0.0f, average.GetInputWeights()[4]);
+  ASSERT_FLOAT_EQ(0.0f, average.GetOutputWeights()[1]);
+  ASSERT_EQ(direct.filter(sample_signal[5]),
+            average.filter(sample_signal[5]));
+  ASSERT_THROW(average.grow(0, 1), std::invalid_argument);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Filters are no longer limited to MAX_FILTER_SIZE
+///        weights, and copies and moves carry the state.
+////////////////////////////////////////////////////////////
+TEST_F(FilterTest, LongFilter) {
+  const unsigned int numTaps = 4*MAX_FILTER_SIZE + 1;
+  std::vector<float> taps(numTaps, 1.0f/numTaps);
+  Filter longAverage(taps, std::vector<float>(1, 1.0f));
+  ASSERT_EQ(numTaps, longAverage.GetNumInWeights());
+  for (unsigned int n=0; n<numTaps; n++){
+    longAverage.filter(1.0f);
+  }
+  ASSERT_NEAR(1.0f, longAverage.filter(1.0f), 1e-5);
+
+  Filter copy(longAverage);
+  ASSERT_EQ(longAverage.filter(0.0f), copy.filter(0.0f));
+  Filter moved(std::move(copy));
+  ASSERT_EQ(longAverage.filter(0.0f), moved.filter(0.0f));
+  Filter assigned;
+  assigned = moved;
+  ASSERT_EQ(longAverage.filter(0.0f), assigned.filter(0.0f));
+}
+
+////////////////////////////////////////////////////////////
+/// @brief A filter put in the steady state for a level gives
+///        the settled output from the first sample, matching
+///        one that has run on the level for a long time.
+////////////////////////////////////////////////////////////
+TEST_F(FilterTest, SteadyState) {
+  float b[3] = {0.0675f, 0.1349f, 0.0675f};
+  float a[3] = {1.0f, -1.143f, 0.4128f};
+  Filter settled(3, b, 3, a);
+  for (unsigned int n=0; n<2000; n++){
+    settled.filter(2.5f);
+  }
+  Filter primed(3, b, 3, a);
+  primed.SetSteadyState(2.5f);
+  const float level = settled.filter(2.5f);
+  ASSERT_NEAR(level, primed.filter(2.5f), 1e-5);
+  for (unsigned int n=0; n<20; n++){
+    const float x = 2.5f + 0.1f*n;
+    ASSERT_NEAR(settled.filter(x), primed.filter(x), 1e-5);
+  }
+  float one[2] = {1.0f, 0.0f};
+  float integrator[2] = {1.0f, -1.0f};
+  Filter accumulate(2, one, 2, integrator);
+  ASSERT_THROW(accumulate.SetSteadyState(1.0f), std::invalid_argument);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief A saved state put back into a fresh filter picks
+///        up exactly where the original left off. A filter
+///        without weights saves and restores an empty state.
+////////////////////////////////////////////////////////////
+TEST_F(FilterTest, SaveRestoreState) {
+  float b[3] = {0.0675f, 0.1349f, 0.0675f};
+  float a[3] = {1.0f, -1.143f, 0.4128f};
+  Filter original(3, b, 3, a);
+  for (unsigned int n=0; n<TEST_SIGNAL_LENGTH; n++){
+    original.filter(sample_signal[n]);
+  }
+  const FilterState state = original.SaveState();
+  ASSERT_EQ(3u, state.inputs.size());
+  ASSERT_EQ(3u, state.outputs.size());
+  Filter restarted(3, b, 3, a);
+  restarted.RestoreState(state);
+  for (unsigned int n=0; n<TEST_SIGNAL_LENGTH; n++){
+    ASSERT_EQ(original.filter(sample_signal[n]),
+              restarted.filter(sample_signal[n]));
+  }
+  Filter other(2, b, 3, a);
+  ASSERT_THROW(other.RestoreState(state), std::invalid_argument);
+
+  /// An unconfigured filter has no weights and an empty state.
+  Filter unconfigured;
+  const FilterState empty = unconfigured.SaveState();
+  ASSERT_TRUE(empty.inputs.empty());
+  ASSERT_TRUE(empty.outputs.empty());
+  unconfigured.RestoreState(empty);
+  ASSERT_THROW(unconfigured.RestoreState(state), std::invalid_argument);
+}
@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////////
+/// @class FixedPointTest
+/// @ingroup DSP
+///
+/// @brief Test class for the Q15 and Q31 filter arithmetic.
+///        The fixed point filters run the same signal and
+///        weights as the Filter test and must agree with the
+///        float filter to within their quantization.
+///////////////////////////////////////////////////////////////
+#include "../FixedPoint.hh"
+#include "../StaticFilter.hh"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+
+class FixedPointTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Fixed point test setup function
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+	 sample_signal[0] =  0.0376; sample_signal[1] = 0.1914;
+	 sample_signal[2] = -0.0321; sample_signal[3] = 0.2486;
+	 sample_signal[4] =  0.2722; sample_signal[5] = 0.2189;
+	 sample_signal[6] =  0.3395; sample_signal[7] = 0.4517;
+	 sample_signal[8] =  0.7344; sample_signal[9] = 0.7320;
+	 expected_filtered[0] = 0.0125; expected_filtered[1] = 0.0763;
+	 expected_filtered[2] = 0.0656; expected_filtered[3] = 0.1359;
+	 expected_filtered[4] = 0.1629; expected_filtered[5] = 0.2466;
+	 expected_filtered[6] = 0.2769; expected_filtered[7] = 0.3367;
+	 expected_filtered[8] = 0.5085; expected_filtered[9] = 0.6394;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the test signal.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int TEST_SIGNAL_LENGTH = 10;
+  ////////////////////////////////////////////////////////////
+  /// @brief Noisy sin(x) test signal, x = [0, 1, 2, ... 9]
+  ////////////////////////////////////////////////////////////
+  float sample_signal[TEST_SIGNAL_LENGTH];
+  ////////////////////////////////////////////////////////////
+  /// @brief Three point moving average of sample_signal.
+  ////////////////////////////////////////////////////////////
+  float expected_filtered[TEST_SIGNAL_LENGTH];
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Moving average weights in each weight format.
+////////////////////////////////////////////////////////////
+static constexpr StaticFilter<3, 1, Q15>::Coefficients kAverageQ15 = {
+  {Q15::weight(0.33333), Q15::weight(0.33333), Q15::weight(0.33333)},
+  {Q15::weight(1.0)}
+};
+static constexpr StaticFilter<3, 1, Q31>::Coefficients kAverageQ31 = {
+  {Q31::weight(0.33333), Q31::weight(0.33333), Q31::weight(0.33333)},
+  {Q31::weight(1.0)}
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Conversions round and saturate.
+////////////////////////////////////////////////////////////
+TEST_F(FixedPointTest, Conversions) {
+  ASSERT_EQ(16384, Q15::fromFloat(0.5f).raw);
+  ASSERT_EQ(32767, Q15::fromFloat(1.5f).raw);
+  ASSERT_EQ(-32768, Q15::fromFloat(-3.0f).raw);
+  ASSERT_FLOAT_EQ(-0.25f, Q15::fromFloat(-0.25f).toFloat());
+  ASSERT_EQ(INT32_MAX, Q31::fromFloat(1.0f).raw);
+  ASSERT_FLOAT_EQ(0.125f, Q31::fromFloat(0.125f).toFloat());
+  ASSERT_EQ(-2*536870912, Q31::weight(-2.0));
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The moving average in Q15, Q31 and double matches
+///        the reference output used by the Filter test.
+////////////////////////////////////////////////////////////
+TEST_F(FixedPointTest, MovingAverage) {
+  StaticFilter<3, 1, Q15> q15Filter(kAverageQ15);
+  StaticFilter<3, 1, Q31> q31Filter(kAverageQ31);
+  const double averageWeights[3] = {0.33333, 0.33333, 0.33333};
+  const double unity[1] = {1.0};
+  StaticFilter<3, 1, double> doubleFilter(averageWeights, unity);
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+	Q15 q15 = q15Filter.filter(Q15::fromFloat(sample_signal[i]));
+	Q31 q31 = q31Filter.filter(Q31::fromFloat(sample_signal[i]));
+	double y = doubleFilter.filter(sample_signal[i]);
+	ASSERT_NEAR(expected_filtered[i], q15.toFloat(), 2e-4);
+	ASSERT_NEAR(expected_filtered[i], q31.toFloat(), 1e-4);
+	ASSERT_NEAR(expected_filtered[i], y, 1e-4);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief A recursive filter with |a[1]| close to one tracks
+///        the float filter in Q15 and Q31, per sample and per
+///        block.
+////////////////////////////////////////////////////////////
+TEST_F(FixedPointTest, Recursive) {
+  const float inWeights[3] = {0.05f, 0.1f, 0.05f};
+  const float outWeights[3] = {1.0f, -1.3f, 0.5f};
+  int32_t q15In[3], q15Out[3], q31In[3], q31Out[3];
+  for (unsigned int i=0; i<3; i++){
+    q15In[i] = Q15::weight(inWeights[i]);
+    q15Out[i] = Q15::weight(outWeights[i]);
+    q31In[i] = Q31::weight(inWeights[i]);
+    q31Out[i] = Q31::weight(outWeights[i]);
+  }
+  StaticFilter<3, 3> floatFilter(inWeights, outWeights);
+  StaticFilter<3, 3, Q15> q15Filter(q15In, q15Out);
+  StaticFilter<3, 3, Q31> q31Filter(q31In, q31Out);
+  Q31 q31Input[TEST_SIGNAL_LENGTH], q31Output[TEST_SIGNAL_LENGTH];
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+    q31Input[i] = Q31::fromFloat(sample_signal[i]);
+  }
+  q31Filter.filterBlock(q31Input, q31Output, TEST_SIGNAL_LENGTH);
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+	float y = floatFilter.filter(sample_signal[i]);
+	ASSERT_NEAR(y, q15Filter.filter(Q15::fromFloat(sample_signal[i])).toFloat(),
+	            5e-4);
+	ASSERT_NEAR(y, q31Output[i].toFloat(), 1e-6);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Outputs beyond full scale saturate instead of
+///        wrapping.
+////////////////////////////////////////////////////////////
+TEST_F(FixedPointTest, Saturation) {
+  const int32_t gainOfThree[1] = {Q15::weight(3.0)};
+  const int32_t unity[1] = {Q15::weight(1.0)};
+  StaticFilter<1, 1, Q15> q15Filter(gainOfThree, unity);
+  ASSERT_EQ(32767, q15Filter.filter(Q15::fromFloat(0.9f)).raw);
+  ASSERT_EQ(-32768, q15Filter.filter(Q15::fromFloat(-0.9f)).raw);
+  const int32_t gainOfThreeQ31[1] = {Q31::weight(3.0)};
+  const int32_t unityQ31[1] = {Q31::weight(1.0)};
+  StaticFilter<1, 1, Q31> q31Filter(gainOfThreeQ31, unityQ31);
+  ASSERT_EQ(INT32_MAX, q31Filter.filter(Q31::fromFloat(0.9f)).raw);
+  ASSERT_EQ(INT32_MIN, q31Filter.filter(Q31::fromFloat(-0.9f)).raw);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Fixed point filters cannot normalize, so a[0]
+///        other than one is rejected.
+////////////////////////////////////////////////////////////
+TEST_F(FixedPointTest, LeadingWeight) {
+  const int32_t gain[1] = {Q15::weight(0.5)};
+  const int32_t two[1] = {Q15::weight(2.0)};
+  ASSERT_THROW((StaticFilter<1, 1, Q15>(gain, two)), std::invalid_argument);
+  const int32_t twoQ31[1] = {Q31::weight(2.0)};
+  ASSERT_THROW((StaticFilter<1, 1, Q31>(gain, twoQ31)), std::invalid_argument);
+}
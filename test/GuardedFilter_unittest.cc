@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////
+/// @class GuardedFilterTest
+/// @ingroup DSP
+///
+/// @brief Test class for the numerically guarded filter. A
+///        NaN must not outlive the policy that handles it,
+///        and flushing must keep denormals out of the state.
+///////////////////////////////////////////////////////////////
+#include "../DenormalGuard.hh"
+#include "../GuardedFilter.hh"
+#include "gtest/gtest.h"
+#include "TestSignals.hh"
+
+#include <cmath>
+#include <vector>
+
+class GuardedFilterTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Guarded filter test setup function
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     signal = twoToneSignal(SIGNAL_LENGTH);
+     signal[BAD_SAMPLE] = NAN;
+     const float bWeights[] = {0.02f, 0.04f, 0.02f};
+     const float aWeights[] = {1.0f, -1.56f, 0.64f};
+     b.assign(bWeights, bWeights + 3);
+     a.assign(aWeights, aWeights + 3);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the test signal, and the index of its
+  ///        NaN.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int SIGNAL_LENGTH = 1000;
+  static const unsigned int BAD_SAMPLE = 300;
+  ////////////////////////////////////////////////////////////
+  /// @brief Test signal and a resonant low pass.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> signal;
+  std::vector<float> b;
+  std::vector<float> a;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Each policy against a plain Filter run the way the
+///        policy promises, per sample and in place blocks.
+////////////////////////////////////////////////////////////
+TEST_F(GuardedFilterTest, NonFinitePolicies) {
+  const NonFinitePolicy policies[] = {NONFINITE_PROPAGATE, NONFINITE_RESET,
+                                      NONFINITE_HOLD};
+  for (NonFinitePolicy policy : policies){
+    GuardedFilter perSample(b, a, DENORMALS_KEEP, policy);
+    GuardedFilter blocks(b, a, DENORMALS_KEEP, policy);
+    Filter plain(b, a);
+    std::vector<float> output(signal);
+    blocks.filterBlock(&output[0], &output[0], SIGNAL_LENGTH);
+    for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+      float expected;
+      if (n != BAD_SAMPLE || policy == NONFINITE_PROPAGATE){
+        expected = plain.filter(signal[n]);
+      } else if (policy == NONFINITE_RESET){
+        plain = Filter(b, a);
+        expected = 0.0f;
+      } else {
+        expected = plain.filter(signal[n - 1]);
+      }
+      const float y = perSample.filter(signal[n]);
+      if (std::isnan(expected)){
+        ASSERT_TRUE(std::isnan(y)) << policy << " " << n;
+        ASSERT_TRUE(std::isnan(output[n])) << policy << " " << n;
+      } else {
+        ASSERT_EQ(expected, y) << policy << " " << n;
+        ASSERT_EQ(y, output[n]) << policy << " " << n;
+      }
+    }
+    const FilterHealthCounters& counters = blocks.GetCounters();
+    ASSERT_EQ(1u, counters.nonFiniteInputs);
+    ASSERT_EQ(policy == NONFINITE_PROPAGATE ? SIGNAL_LENGTH - BAD_SAMPLE :
+              policy == NONFINITE_RESET ? 1u : 0u, counters.nonFiniteOutputs);
+    ASSERT_EQ(policy == NONFINITE_RESET ? 1u : 0u, counters.resets);
+    blocks.ClearCounters();
+    ASSERT_EQ(0u, blocks.GetCounters().nonFiniteInputs);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief An overflowing unstable filter restarts from rest
+///        even when holding inputs.
+////////////////////////////////////////////////////////////
+TEST_F(GuardedFilterTest, Overflow) {
+  GuardedFilter unstable(std::vector<float>(1, 1.0f),
+                         std::vector<float>{1.0f, -1e10f},
+                         DENORMALS_KEEP, NONFINITE_HOLD);
+  std::vector<float> output(10, 1.0f);
+  unstable.filterBlock(&output[0], &output[0], 10);
+  ASSERT_EQ(1.0f, output[0]);
+  ASSERT_EQ(0.0f, output[4]);
+  ASSERT_EQ(1.0f, output[5]);
+  ASSERT_EQ(2u, unstable.GetCounters().resets);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief A slowly decaying pole: its state goes denormal
+///        unless flushed, and the guard restores the mode.
+////////////////////////////////////////////////////////////
+TEST_F(GuardedFilterTest, Denormals) {
+  if (!DenormalGuard::IsSupported()){
+    return;
+  }
+  const std::vector<float> pole{1.0f, -0.5f};
+  const DenormalMode modes[] = {DENORMALS_KEEP, DENORMALS_FLUSH,
+                                DENORMALS_OFFSET};
+  for (DenormalMode mode : modes){
+    GuardedFilter decay(std::vector<float>(1, 1.0f), pole, mode);
+    std::vector<float> output(400, 0.0f);
+    output[0] = 1.0f;
+    decay.filterBlock(&output[0], &output[0], 400);
+    unsigned int denormals = 0;
+    for (float y : output){
+      denormals += (std::fpclassify(y) == FP_SUBNORMAL);
+    }
+    if (mode == DENORMALS_KEEP){
+      ASSERT_GT(denormals, 0u);
+    } else {
+      ASSERT_EQ(0u, denormals) << mode;
+      const float rest = (mode == DENORMALS_FLUSH) ?
+                         0.0f : 2*GuardedFilter::DENORMAL_OFFSET;
+      ASSERT_EQ(rest, output[399]);
+    }
+  }
+  volatile float tiny = 1e-30f;
+  {
+    DenormalGuard flushDenormals;
+    ASSERT_EQ(0.0f, tiny*tiny*1e10f);
+  }
+  ASSERT_GT(tiny*1e-10f, 0.0f);
+}
@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////
+/// @class InterpolatorTest
+/// @ingroup DSP
+///
+/// @brief Test class for the interpolating filter. Its
+///        outputs must match a direct form Filter with the
+///        same taps run over the zero stuffed input.
+///////////////////////////////////////////////////////////////
+#include "../Filter.hh"
+#include "../Interpolator.hh"
+#include "gtest/gtest.h"
+#include "TestSignals.hh"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+class InterpolatorTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Interpolator test setup function
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     signal = twoToneSignal(SIGNAL_LENGTH);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the test signal.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int SIGNAL_LENGTH = 300;
+  ////////////////////////////////////////////////////////////
+  /// @brief Test signal, see twoToneSignal.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> signal;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Factors and tap counts, including tap counts that
+///        leave the last phase short, fed in uneven blocks.
+////////////////////////////////////////////////////////////
+TEST_F(InterpolatorTest, MatchesZeroStuffedFilter) {
+  const unsigned int factors[] = {1, 2, 5};
+  const unsigned int lengths[] = {1, 4, 23};
+  for (unsigned int factor : factors){
+    for (unsigned int numTaps : lengths){
+      Filter direct(arbitraryTaps(numTaps), std::vector<float>(1, 1.0f));
+      Interpolator interpolator(arbitraryTaps(numTaps), factor);
+      std::vector<float> output(factor*SIGNAL_LENGTH);
+      for (unsigned int n=0; n<SIGNAL_LENGTH; n+=11){
+        interpolator.filterBlock(&signal[n], &output[factor*n],
+                                 std::min(11u, SIGNAL_LENGTH - n));
+      }
+      for (unsigned int n=0; n<factor*SIGNAL_LENGTH; n++){
+        const float x = (n % factor == 0) ? signal[n/factor] : 0.0f;
+        ASSERT_NEAR(direct.filter(x), output[n], 1e-5)
+            << factor << " " << numTaps << " " << n;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Reset and rejected setups.
+////////////////////////////////////////////////////////////
+TEST_F(InterpolatorTest, Construction) {
+  Interpolator interpolator(arbitraryTaps(7), 3);
+  ASSERT_EQ(3u, interpolator.GetFactor());
+  ASSERT_EQ(7u, interpolator.GetNumTaps());
+  std::vector<float> first(30), second(30);
+  interpolator.filterBlock(&signal[0], &first[0], 10);
+  interpolator.reset();
+  interpolator.filterBlock(&signal[0], &second[0], 10);
+  ASSERT_EQ(first, second);
+  ASSERT_THROW(Interpolator(arbitraryTaps(5), 0), std::invalid_argument);
+  ASSERT_THROW(Interpolator(std::vector<float>(), 2), std::invalid_argument);
+}
@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////
+/// @class MovingAverageTest
+/// @ingroup DSP
+///
+/// @brief Test class for the running sum moving average. Its
+///        outputs must track a direct form Filter with equal
+///        weights, and must not drift over long runs.
+///////////////////////////////////////////////////////////////
+#include "../FilterAnalysis.hh"
+#include "../MovingAverage.hh"
+#include "gtest/gtest.h"
+#include "TestSignals.hh"
+
+#include <stdexcept>
+#include <vector>
+
+class MovingAverageTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Moving average test setup function
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     signal = twoToneSignal(SIGNAL_LENGTH);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the test signal.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int SIGNAL_LENGTH = 3000;
+  ////////////////////////////////////////////////////////////
+  /// @brief Test signal, see twoToneSignal.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> signal;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Window lengths from one sample to longer than a
+///        direct form filter would be practical for, per
+///        sample and in blocks.
+////////////////////////////////////////////////////////////
+TEST_F(MovingAverageTest, MatchesDirectForm) {
+  const unsigned int lengths[] = {1, 3, 64, 1000};
+  for (unsigned int length : lengths){
+    Filter direct(std::vector<float>(length, 1.0f/length),
+                  std::vector<float>(1, 1.0f));
+    MovingAverage perSample(length);
+    MovingAverage blocks(length);
+    ASSERT_EQ(length, perSample.GetWindowLength());
+    std::vector<float> output(signal);
+    blocks.filterBlock(&output[0], &output[0], SIGNAL_LENGTH);
+    for (unsigned int n=0; n<SIGNAL_LENGTH; n++){
+      const float y = perSample.filter(signal[n]);
+      ASSERT_NEAR(direct.filter(signal[n]), y, 1e-5) << length << " " << n;
+      ASSERT_EQ(y, output[n]);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief A large offset and a small signal over many
+///        windows: the average must stay exact to within
+///        float rounding rather than wander.
+////////////////////////////////////////////////////////////
+TEST_F(MovingAverageTest, NoDrift) {
+  const unsigned int length = 1000;
+  MovingAverage average(length);
+  std::vector<float> window(length, 0.0f);
+  for (unsigned int n=0; n<2000000; n++){
+    const float x = 1.0e4f + 0.01f*signal[n % SIGNAL_LENGTH];
+    window[n % length] = x;
+    const float y = average.filter(x);
+    if (n % 99991 == 0 && n >= length){
+      double exact = 0.0;
+      for (unsigned int i=0; i<length; i++){
+        exact += window[i];
+      }
+      ASSERT_NEAR(exact/length, y, 1e-3) << n;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Reset, use through the base class, and a rejected
+///        window length.
+////////////////////////////////////////////////////////////
+TEST_F(MovingAverageTest, Construction) {
+  MovingAverage average(10);
+  Filter& asFilter = average;
+  for (unsigned int n=0; n<25; n++){
+    asFilter.filter(1.0f);
+  }
+  ASSERT_FLOAT_EQ(1.0f, asFilter.filter(1.0f));
+  average.reset();
+  ASSERT_FLOAT_EQ(0.1f, asFilter.filter(1.0f));
+  ASSERT_THROW(MovingAverage(0), std::invalid_argument);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The base Filter describes the running filter: its
+///        weights are N of 1/N, its state is the window and
+///        the last output, and other weights are rejected.
+////////////////////////////////////////////////////////////
+TEST_F(MovingAverageTest, BaseFilterView) {
+  const unsigned int length = 16;
+  MovingAverage average(length);
+  ASSERT_EQ(length, average.GetNumInWeights());
+  ASSERT_EQ(1u, average.GetNumOutWeights());
+  ASSERT_FLOAT_EQ(1.0f/length, average.GetInputWeights()[length - 1]);
+  FilterAnalysis analysis(std::vector<double>(1, 0.0));
+  std::complex<double> dcGain;
+  analysis.frequencyResponse(average, &dcGain);
+  ASSERT_NEAR(1.0, dcGain.real(), 1e-6);
+
+  const unsigned int half = SIGNAL_LENGTH/2 + 3;
+  float last = 0.0f;
+  for (unsigned int n=0; n<half; n++){
+    last = average.filter(signal[n]);
+  }
+  const FilterState state = average.SaveState();
+  ASSERT_EQ(length, state.inputs.size());
+  ASSERT_EQ(signal[half - 1], state.inputs[0]);
+  ASSERT_EQ(last, state.outputs[0]);
+  MovingAverage restarted(length);
+  restarted.RestoreState(state);
+  for (unsigned int n=half; n<SIGNAL_LENGTH; n++){
+    ASSERT_NEAR(average.filter(signal[n]), restarted.filter(signal[n]), 1e-6);
+  }
+
+  float b[2] = {0.5f, 0.5f};
+  float a[1] = {1.0f};
+  ASSERT_THROW(average.SetWeights(2, b, 1, a), std::invalid_argument);
+  ASSERT_EQ(length, average.GetNumInWeights());
+}
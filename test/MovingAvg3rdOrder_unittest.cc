@@ -86,3 +86,47 @@ TEST_F(MovingAvg3rdOrderTest, DefaultConstructor) {
 	ASSERT_NEAR(expected_filtered[i], filterOutput, error_tolerance);
   }
 }
+
+////////////////////////////////////////////////////////////
+/// @brief Unit test for the specialized filterBlock. The
+///        block outputs must be bit-identical to calling
+///        filter() once per sample, including across blocks.
+////////////////////////////////////////////////////////////
+TEST_F(MovingAvg3rdOrderTest, FilterBlock) {
+  MovingAvg3rdOrder sampleFilter;
+  MovingAvg3rdOrder blockFilter;
+  float blockOutput[TEST_SIGNAL_LENGTH];
+  blockFilter.filterBlock(sample_signal, blockOutput, 3);
+  blockFilter.filterBlock(sample_signal + 3, blockOutput + 3,
+                          TEST_SIGNAL_LENGTH - 3);
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+	float filterOutput = sampleFilter.filter(sample_signal[i]);
+	ASSERT_EQ(filterOutput, blockOutput[i]);
+  }
+  /// Mixing the two entry points must carry the state across.
+  ASSERT_EQ(sampleFilter.filter(0.5), blockFilter.filter(0.5));
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The filter works through a Filter reference, and
+///        its block routine still matches filter() after
+///        SetWeights has changed the tap counts.
+////////////////////////////////////////////////////////////
+TEST_F(MovingAvg3rdOrderTest, UsedAsFilter) {
+  MovingAvg3rdOrder avgFilter;
+  Filter& asFilter = avgFilter;
+  float blockOutput[TEST_SIGNAL_LENGTH];
+  asFilter.filterBlock(sample_signal, blockOutput, TEST_SIGNAL_LENGTH);
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+	ASSERT_NEAR(expected_filtered[i], blockOutput[i], error_tolerance);
+  }
+  float inWeights[2] = {0.5f, 0.5f};
+  float outWeights[2] = {1.0f, -0.25f};
+  Filter reference(2, inWeights, 2, outWeights);
+  MovingAvg3rdOrder retuned;
+  retuned.SetWeights(2, inWeights, 2, outWeights);
+  retuned.filterBlock(sample_signal, blockOutput, TEST_SIGNAL_LENGTH);
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+	ASSERT_EQ(reference.filter(sample_signal[i]), blockOutput[i]);
+  }
+}
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////
+/// @class ParallelFilterTest
+/// @ingroup DSP
+///
+/// @brief Test class for chunked parallel filtering. Its
+///        outputs and final state must match filtering the
+///        whole signal serially.
+///////////////////////////////////////////////////////////////
+#include "../ButterworthLowPass3rdOrder.hh"
+#include "../FilterDesign.hh"
+#include "../MovingAverage.hh"
+#include "../ParallelFilter.hh"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+class ParallelFilterTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Parallel filter test setup function
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     signal.resize(SIGNAL_LENGTH);
+     for (size_t n=0; n<SIGNAL_LENGTH; n++){
+       signal[n] = std::sin(0.001f*n) + 0.5f*std::sin(0.9f*n) +
+                   ((n*2654435761u) % 1000)*0.0004f;
+     }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief A 4th order Butterworth low pass, whose state
+  ///        carries well into each chunk.
+  ////////////////////////////////////////////////////////////
+  static Filter lowPass(void){
+     FilterSpec spec = {BUTTERWORTH, LOW_PASS, 4, 500.0, 50.0, 0.0, 0.0};
+     std::vector<float> b, a;
+     FilterDesign(spec).GetWeights(b, a);
+     return Filter(b, a);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Checks filterParallel against serial filtering,
+  ///        in place, from a warmed up state, and afterwards.
+  ////////////////////////////////////////////////////////////
+  void checkFilter(const Filter& prototype, unsigned int numThreads){
+     Filter serial(prototype);
+     Filter parallel(prototype);
+     for (unsigned int n=0; n<500; n++){
+       serial.filter(signal[n]);
+       parallel.filter(signal[n]);
+     }
+     std::vector<float> expected(SIGNAL_LENGTH);
+     serial.filterBlock(&signal[0], &expected[0], SIGNAL_LENGTH);
+     std::vector<float> output(signal);
+     filterParallel(parallel, &output[0], &output[0], SIGNAL_LENGTH,
+                    numThreads);
+     for (size_t n=0; n<SIGNAL_LENGTH; n++){
+       ASSERT_NEAR(expected[n], output[n], 1e-4) << numThreads << " " << n;
+     }
+     for (unsigned int n=0; n<500; n++){
+       ASSERT_NEAR(serial.filter(signal[n]), parallel.filter(signal[n]),
+                   1e-4) << n;
+     }
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the test signal, several chunks' worth.
+  ////////////////////////////////////////////////////////////
+  static const size_t SIGNAL_LENGTH = 5*PARALLEL_MIN_CHUNK + 123;
+  ////////////////////////////////////////////////////////////
+  /// @brief Test signal: slow and fast sines plus noise.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> signal;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief IIR and FIR filters over several thread counts,
+///        including counts the signal is too short for.
+////////////////////////////////////////////////////////////
+TEST_F(ParallelFilterTest, MatchesSerial) {
+  const unsigned int threads[] = {1, 2, 3, 5, 16};
+  for (unsigned int numThreads : threads){
+    checkFilter(lowPass(), numThreads);
+  }
+  std::vector<float> taps(31);
+  for (size_t i=0; i<taps.size(); i++){
+    taps[i] = 0.03f*std::cos(0.2f*i);
+  }
+  checkFilter(Filter(taps, std::vector<float>(1, 1.0f)), 4);
+  float b[2] = {0.1f, 0.0f};
+  float a[2] = {1.0f, -0.9f};
+  checkFilter(Filter(2, b, 2, a), 3);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Derived filters are refused unless they are their
+///        difference equation.
+////////////////////////////////////////////////////////////
+TEST_F(ParallelFilterTest, RejectsDerivedFilters) {
+  MovingAverage average(10);
+  ASSERT_THROW(filterParallel(average, &signal[0], &signal[0], 100),
+               std::invalid_argument);
+  ButterworthLowPass3rdOrder lowPass3(50.0, 500.0);
+  Filter serial(lowPass3);
+  std::vector<float> expected(SIGNAL_LENGTH);
+  serial.filterBlock(&signal[0], &expected[0], SIGNAL_LENGTH);
+  std::vector<float> output(SIGNAL_LENGTH);
+  filterParallel(lowPass3, &signal[0], &output[0], SIGNAL_LENGTH, 4);
+  for (size_t n=0; n<SIGNAL_LENGTH; n++){
+    ASSERT_NEAR(expected[n], output[n], 1e-4) << n;
+  }
+}
@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////
+/// @class PolynomialTest
+/// @ingroup DSP
+///
+/// @brief Tests for the polynomial root finder and helpers.
+///////////////////////////////////////////////////////////////
+#include "../Polynomial.hh"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+////////////////////////////////////////////////////////////
+/// @brief Orders roots by real then imaginary part.
+////////////////////////////////////////////////////////////
+static bool rootLess(const std::complex<double>& lhs,
+                     const std::complex<double>& rhs){
+  if (lhs.real() != rhs.real()) return lhs.real() < rhs.real();
+  return lhs.imag() < rhs.imag();
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Real and complex roots of known polynomials.
+////////////////////////////////////////////////////////////
+TEST(PolynomialTest, Roots) {
+  std::vector<std::complex<double> > roots;
+  double cubic[4] = {1.0, -6.0, 11.0, -6.0};
+  polynomialRoots(std::vector<double>(cubic, cubic + 4), roots);
+  ASSERT_EQ(3u, roots.size());
+  std::sort(roots.begin(), roots.end(), rootLess);
+  for (unsigned int i=0; i<3; i++){
+    ASSERT_NEAR(i + 1.0, roots[i].real(), 1e-12);
+    ASSERT_EQ(0.0, roots[i].imag());
+  }
+  /// z^2 + 1 has the conjugate pair +-j.
+  double quadratic[3] = {1.0, 0.0, 1.0};
+  polynomialRoots(std::vector<double>(quadratic, quadratic + 3), roots);
+  ASSERT_EQ(2u, roots.size());
+  ASSERT_NEAR(0.0, roots[0].real(), 1e-12);
+  ASSERT_NEAR(1.0, std::abs(roots[0].imag()), 1e-12);
+  ASSERT_EQ(roots[0], std::conj(roots[1]));
+  /// Leading zeros are ignored, trailing zeros are roots at 0.
+  double padded[5] = {0.0, 2.0, -2.0, 0.0, 0.0};
+  polynomialRoots(std::vector<double>(padded, padded + 5), roots);
+  ASSERT_EQ(3u, roots.size());
+  std::sort(roots.begin(), roots.end(), rootLess);
+  ASSERT_EQ(0.0, roots[0].real());
+  ASSERT_EQ(0.0, roots[1].real());
+  ASSERT_NEAR(1.0, roots[2].real(), 1e-12);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Rebuilding a polynomial from its roots round trips,
+///        even for the repeated roots of (z+1)^8.
+////////////////////////////////////////////////////////////
+TEST(PolynomialTest, MultiplyAndRebuild) {
+  std::vector<double> factor(2, 1.0);
+  std::vector<double> poly(1, 1.0);
+  for (unsigned int i=0; i<8; i++){
+    poly = polynomialMultiply(poly, factor);
+  }
+  const double binomial[9] = {1, 8, 28, 56, 70, 56, 28, 8, 1};
+  ASSERT_EQ(9u, poly.size());
+  for (unsigned int i=0; i<9; i++){
+    ASSERT_EQ(binomial[i], poly[i]);
+  }
+  std::vector<std::complex<double> > roots;
+  polynomialRoots(poly, roots);
+  std::vector<double> rebuilt = polynomialFromRoots(roots);
+  ASSERT_EQ(poly.size(), rebuilt.size());
+  for (unsigned int i=0; i<9; i++){
+    ASSERT_NEAR(binomial[i], rebuilt[i], 1e-9*binomial[i]);
+  }
+}
@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////
+/// @class SpscQueueTest
+/// @ingroup DSP
+///
+/// @brief Test class for the lock free SpscQueue, single
+///        threaded for the edge cases and with a producer and
+///        consumer thread for ordering.
+///////////////////////////////////////////////////////////////
+#include "../SpscQueue.hh"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <thread>
+
+////////////////////////////////////////////////////////////
+/// @brief Capacity rounds up, and full and empty queues
+///        refuse push and pop, across wrap around.
+////////////////////////////////////////////////////////////
+TEST(SpscQueueTest, FullAndEmpty) {
+  SpscQueue<int> queue(5);
+  ASSERT_EQ(8u, queue.capacity());
+  int value = -1;
+  ASSERT_FALSE(queue.pop(value));
+  for (int round=0; round<3; round++){
+    for (int i=0; i<8; i++){
+      ASSERT_TRUE(queue.push(round*8 + i));
+    }
+    ASSERT_FALSE(queue.push(99));
+    ASSERT_EQ(8u, queue.size());
+    for (int i=0; i<8; i++){
+      ASSERT_TRUE(queue.pop(value));
+      ASSERT_EQ(round*8 + i, value);
+    }
+    ASSERT_FALSE(queue.pop(value));
+  }
+  ASSERT_THROW(SpscQueue<int>(0), std::invalid_argument);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Block operations move as much as fits.
+////////////////////////////////////////////////////////////
+TEST(SpscQueueTest, Blocks) {
+  SpscQueue<float> queue(4);
+  const float in[6] = {1, 2, 3, 4, 5, 6};
+  float out[6];
+  ASSERT_EQ(3u, queue.pushBlock(in, 3));
+  ASSERT_EQ(2u, queue.popBlock(out, 2));
+  ASSERT_EQ(3u, queue.pushBlock(in + 3, 3));
+  ASSERT_EQ(4u, queue.popBlock(out + 2, 6));
+  for (unsigned int i=0; i<6; i++){
+    ASSERT_EQ(in[i], out[i]);
+  }
+}
+
+////////////////////////////////////////////////////////////
+/// @brief A producer and consumer thread pass a long
+///        sequence through a small queue in order.
+////////////////////////////////////////////////////////////
+TEST(SpscQueueTest, Threads) {
+  const unsigned int count = 200000;
+  SpscQueue<unsigned int> queue(64);
+  std::thread producer([&queue, count]{
+    for (unsigned int i=0; i<count; ){
+      if (queue.push(i)){
+        i++;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+  unsigned int expected = 0;
+  unsigned int value;
+  while (expected < count){
+    if (queue.pop(value)){
+      ASSERT_EQ(expected, value);
+      expected++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+}
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////
+/// @class StaticFilterTest
+/// @ingroup DSP
+///
+/// @brief Test class for the compile time StaticFilter. The
+///        static filter must produce exactly the same outputs
+///        as the generic Filter class for the same weights.
+///////////////////////////////////////////////////////////////
+#include "../StaticFilter.hh"
+#include "../Filter.hh"
+#include "../MovingAvg3rdOrder.hh"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+
+class StaticFilterTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Static filter test setup function
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+	 sample_signal[0] =  0.0376; sample_signal[1] = 0.1914;
+	 sample_signal[2] = -0.0321; sample_signal[3] = 0.2486;
+	 sample_signal[4] =  0.2722; sample_signal[5] = 0.2189;
+	 sample_signal[6] =  0.3395; sample_signal[7] = 0.4517;
+	 sample_signal[8] =  0.7344; sample_signal[9] = 0.7320;
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the test signal.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int TEST_SIGNAL_LENGTH = 10;
+  ////////////////////////////////////////////////////////////
+  /// @brief Noisy sin(x) test signal, x = [0, 1, 2, ... 9]
+  ////////////////////////////////////////////////////////////
+  float sample_signal[TEST_SIGNAL_LENGTH];
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Recursive (IIR) weights used to compare the static
+///        filter against the generic one.
+////////////////////////////////////////////////////////////
+static constexpr StaticFilter<3, 3>::Coefficients kIirWeights = {
+  {0.2f, 0.4f, 0.2f},
+  {1.0f, -0.6f, 0.2f}
+};
+
+////////////////////////////////////////////////////////////
+/// @brief The object must hold nothing but its state.
+////////////////////////////////////////////////////////////
+TEST_F(StaticFilterTest, Footprint) {
+  ASSERT_EQ(2*(3+1)*sizeof(float), sizeof(StaticFilter<3, 1>));
+  ASSERT_EQ(2*(3+1)*sizeof(float), sizeof(StaticMovingAvg3rdOrder));
+  ASSERT_EQ(2*(5+4)*sizeof(double), sizeof(StaticFilter<5, 4, double>));
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Per sample and block outputs must match Filter.
+////////////////////////////////////////////////////////////
+TEST_F(StaticFilterTest, MatchesFilter) {
+  float inWeights[3] = {0.2f, 0.4f, 0.2f};
+  float outWeights[3] = {1.0f, -0.6f, 0.2f};
+  Filter reference(3, inWeights, 3, outWeights);
+  StaticFilter<3, 3> sampleFilter(kIirWeights);
+  StaticFilter<3, 3> blockFilter(inWeights, outWeights);
+  float blockOutput[TEST_SIGNAL_LENGTH];
+  blockFilter.filterBlock(sample_signal, blockOutput, 6);
+  blockFilter.filterBlock(sample_signal + 6, blockOutput + 6,
+                          TEST_SIGNAL_LENGTH - 6);
+  for (unsigned int i=0; i<TEST_SIGNAL_LENGTH; i++){
+	float expected = reference.filter(sample_signal[i]);
+	ASSERT_EQ(expected, sampleFilter.filter(sample_signal[i]));
+	ASSERT_EQ(expected, blockOutput[i]);
+  }
+  ASSERT_EQ(reference.GetCurrentOutputBuffer()[1],
+            blockFilter.GetCurrentOutputBuffer()[1]);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief reset() must return the filter to its initial state.
+////////////////////////////////////////////////////////////
+TEST_F(StaticFilterTest, Reset) {
+  StaticFilter<3, 3> tFilter(kIirWeights);
+  float first = tFilter.filter(sample_signal[0]);
+  tFilter.filter(sample_signal[1]);
+  tFilter.reset();
+  ASSERT_EQ(first, tFilter.filter(sample_signal[0]));
+}
+
+////////////////////////////////////////////////////////////
+/// @brief The weights are normalized by a[0] at construction
+///        and a zero a[0], or one so small that it overflows
+///        the normalized weights, is rejected.
+////////////////////////////////////////////////////////////
+TEST_F(StaticFilterTest, NormalizedWeights) {
+  const float inWeights[3] = {0.5f, 1.0f, 0.5f};
+  const float outWeights[3] = {2.0f, -1.2f, 0.4f};
+  StaticFilter<3, 3> tFilter(inWeights, outWeights);
+  ASSERT_FLOAT_EQ(0.25f, tFilter.GetInputWeights()[0]);
+  ASSERT_FLOAT_EQ(1.0f, tFilter.GetOutputWeights()[0]);
+  ASSERT_FLOAT_EQ(-0.6f, tFilter.GetOutputWeights()[1]);
+  const float zero[3] = {0.0f, 0.0f, 0.0f};
+  ASSERT_THROW((StaticFilter<3, 3>(inWeights, zero)), std::invalid_argument);
+  const float tinyLeading[3] = {1e-40f, -1.2f, 0.4f};
+  ASSERT_THROW((StaticFilter<3, 3>(inWeights, tinyLeading)),
+               std::invalid_argument);
+}
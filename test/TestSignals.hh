@@ -0,0 +1,40 @@
+///////////////////////////////////////////////////////////////
+/// @ingroup Input signals and weights shared by the unit
+///          tests that compare two implementations of the
+///          same filter.
+///////////////////////////////////////////////////////////////
+#ifndef TEST_SIGNALS_HH
+#define TEST_SIGNALS_HH
+
+#include <cmath>
+#include <vector>
+
+////////////////////////////////////////////////////////////
+/// @brief Sum of a slow and a fast sine, so a filter under
+///        test sees energy in both its pass and stop bands.
+/// @param length -- Number of samples.
+/// @return The signal.
+////////////////////////////////////////////////////////////
+inline std::vector<float> twoToneSignal(unsigned int length){
+  std::vector<float> signal(length);
+  for (unsigned int n=0; n<length; n++){
+    signal[n] = std::sin(0.05f*n) + 0.3f*std::sin(1.7f*n);
+  }
+  return signal;
+}
+
+////////////////////////////////////////////////////////////
+/// @brief FIR taps with no particular response, for tests
+///        that only check one implementation against another.
+/// @param numTaps -- Number of taps.
+/// @return The taps.
+////////////////////////////////////////////////////////////
+inline std::vector<float> arbitraryTaps(unsigned int numTaps){
+  std::vector<float> taps(numTaps);
+  for (unsigned int i=0; i<numTaps; i++){
+    taps[i] = 0.1f*std::cos(0.7f*i) + 0.05f;
+  }
+  return taps;
+}
+
+#endif  // TEST_SIGNALS_HH
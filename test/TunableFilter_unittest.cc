@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////
+/// @class TunableFilterTest
+/// @ingroup DSP
+///
+/// @brief Test class for retuning a running filter through a
+///        CoefficientMailbox. A retuned filter must continue
+///        exactly like one retuned with SetWeights, and a
+///        block must never see a mix of two weight sets.
+///////////////////////////////////////////////////////////////
+#include "../TunableFilter.hh"
+#include "gtest/gtest.h"
+#include "TestSignals.hh"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class TunableFilterTest : public testing::Test {
+ protected:
+
+  ////////////////////////////////////////////////////////////
+  /// @brief Tunable filter test setup function
+  ////////////////////////////////////////////////////////////
+  virtual void SetUp(void) {
+     signal = twoToneSignal(SIGNAL_LENGTH);
+  }
+  ////////////////////////////////////////////////////////////
+  /// @brief Length of the test signal.
+  ////////////////////////////////////////////////////////////
+  static const unsigned int SIGNAL_LENGTH = 300;
+  ////////////////////////////////////////////////////////////
+  /// @brief Test signal, see twoToneSignal.
+  ////////////////////////////////////////////////////////////
+  std::vector<float> signal;
+};
+
+////////////////////////////////////////////////////////////
+/// @brief Retuning to longer and shorter weight sets keeps
+///        the state, exactly as SetWeights does, and only the
+///        newest of several published sets is taken.
+////////////////////////////////////////////////////////////
+TEST_F(TunableFilterTest, MatchesSetWeights) {
+  const float b1[3] = {0.0675f, 0.1349f, 0.0675f};
+  const float a1[3] = {2.0f, -2.286f, 0.8256f};
+  const float b2[5] = {0.1f, 0.2f, 0.3f, 0.2f, 0.1f};
+  const float a2[2] = {1.0f, -0.1f};
+  const float b3[1] = {0.5f};
+  const float a3[4] = {1.0f, -0.5f, 0.2f, -0.1f};
+  CoefficientMailbox mailbox(5, 4);
+  TunableFilter tunable(std::vector<float>(b1, b1 + 3),
+                        std::vector<float>(a1, a1 + 3), mailbox);
+  Filter reference(std::vector<float>(b1, b1 + 3),
+                   std::vector<float>(a1, a1 + 3));
+  std::vector<float> output(SIGNAL_LENGTH);
+  tunable.filterBlock(&signal[0], &output[0], 100);
+  for (unsigned int n=0; n<100; n++){
+    ASSERT_EQ(reference.filter(signal[n]), output[n]);
+  }
+  mailbox.publish(std::vector<float>(b1, b1 + 3),
+                  std::vector<float>(a1, a1 + 3));
+  mailbox.publish(std::vector<float>(b2, b2 + 5),
+                  std::vector<float>(a2, a2 + 2));
+  reference.SetWeights(5, b2, 2, a2);
+  tunable.filterBlock(&signal[100], &output[100], 100);
+  ASSERT_EQ(5u, tunable.GetNumInWeights());
+  for (unsigned int n=100; n<200; n++){
+    ASSERT_EQ(reference.filter(signal[n]), output[n]);
+  }
+  mailbox.publish(std::vector<float>(b3, b3 + 1),
+                  std::vector<float>(a3, a3 + 4));
+  reference.SetWeights(1, b3, 4, a3);
+  for (unsigned int n=200; n<SIGNAL_LENGTH; n++){
+    ASSERT_EQ(reference.filter(signal[n]), tunable.filter(signal[n]));
+  }
+  ASSERT_TRUE(mailbox.take() == NULL);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief Rejected sets leave the mailbox as it was.
+////////////////////////////////////////////////////////////
+TEST_F(TunableFilterTest, RejectedSets) {
+  CoefficientMailbox mailbox(2, 2);
+  std::vector<float> b(2, 0.5f), a(1, 1.0f);
+  ASSERT_THROW(mailbox.publish(std::vector<float>(3, 0.1f), a),
+               std::invalid_argument);
+  ASSERT_THROW(mailbox.publish(b, std::vector<float>()),
+               std::invalid_argument);
+  ASSERT_THROW(mailbox.publish(b, std::vector<float>(1, 0.0f)),
+               std::invalid_argument);
+  ASSERT_TRUE(mailbox.take() == NULL);
+  ASSERT_THROW(CoefficientMailbox(0, 1), std::invalid_argument);
+}
+
+////////////////////////////////////////////////////////////
+/// @brief A control thread publishes ever larger gains while
+///        the filter runs. With a constant input every output
+///        of a block shows a single published gain, and gains
+///        never go backwards.
+////////////////////////////////////////////////////////////
+TEST_F(TunableFilterTest, ConcurrentRetuning) {
+  const unsigned int numSets = 20000;
+  CoefficientMailbox mailbox(8, 1);
+  TunableFilter gain(std::vector<float>(8, 0.0f),
+                     std::vector<float>(1, 1.0f), mailbox);
+  std::atomic<bool> done(false);
+  std::thread control([&](){
+    for (unsigned int k=1; k<=numSets; k++){
+      mailbox.publish(std::vector<float>(8, static_cast<float>(k)),
+                      std::vector<float>(1, 1.0f));
+    }
+    done.store(true);
+  });
+  const std::vector<float> ones(64, 1.0f);
+  std::vector<float> output(64);
+  float last = 0.0f;
+  bool finished = false;
+  while (!finished){
+    finished = done.load();
+    gain.filterBlock(&ones[0], &output[0], 64);
+    const float level = output[63];
+    ASSERT_EQ(0.0f, std::fmod(level, 8.0f));
+    ASSERT_GE(level, last);
+    for (unsigned int n=8; n<64; n++){
+      ASSERT_EQ(level, output[n]);
+    }
+    last = level;
+  }
+  control.join();
+  gain.filterBlock(&ones[0], &output[0], 64);
+  ASSERT_EQ(8.0f*numSets, output[63]);
+}